@@ -0,0 +1,186 @@
+#include "PchorAnalysis.hpp"
+
+#include "./visitors/AstVisitor.hpp"
+#include "./visitors/CASTValidator.hpp"
+#include "./utils/ChannelGenerator.hpp"
+#include "./utils/ChannelUseIndex.hpp"
+#include "./utils/CoroutineGenerator.hpp"
+#include "./utils/ContextManager.hpp"
+#include "./utils/FalseSharing.hpp"
+#include "./utils/MonitorGenerator.hpp"
+#include "./utils/ResultWriter.hpp"
+#include "./utils/SessionGenerator.hpp"
+#include "./utils/UnsynchronizedChannels.hpp"
+
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <print>
+
+namespace PchorAST {
+
+std::shared_ptr<SymbolTable> parseChoreography(const std::string &corFilePath,
+                                               bool debug) {
+  PchorParser parser{corFilePath};
+  parser.genTokens();
+  if (debug) {
+    parser.printTokenList();
+  }
+  parser.parse();
+
+  if (debug) {
+    parser.printAST();
+  }
+  return parser.getChorAST();
+}
+
+std::shared_ptr<PchorProjection>
+projectChoreography(clang::ASTContext &Context, const SymbolTable &sTable,
+                    const ParticipantDemand &demand) {
+  auto globalTypePtr = sTable.back();
+  if ((*globalTypePtr)->getDeclType() != Decl::Global_Type_Decl) {
+    throw std::runtime_error("Final Expression is required to be a Global type expression.");
+  }
+  Proj_PchorASTVisitor Proj_visitor(Context, demand);
+  (*globalTypePtr)->accept(Proj_visitor);
+  return Proj_visitor.getContext();
+}
+
+void runChoreographyAnalysis(clang::ASTContext &Context,
+                             const std::shared_ptr<SymbolTable> &sTable,
+                             bool debug, bool onlyproj,
+                             const std::string &resultsPath,
+                             const ParticipantDemand &demand,
+                             const std::string &channelsPath,
+                             const std::string &monitorPath,
+                             const std::string &sessionPath,
+                             const std::string &coroutinesPath,
+                             bool falseSharing, bool unsynchronized,
+                             std::FILE *out) {
+  std::println(out, "\n\nAST has been fully created. CASTMapping and Choreography Projection Commencing!");
+  try {
+    if (!sTable) {
+      std::println(out, "Error: HandleTranslationUnit received no SymbolTable. Continuing to compilation");
+      return;
+    }
+
+    std::println(out, "Symbol table correctly passed to ChoreographyAstConsumer");
+    auto globalTypePtr = sTable->back();
+    if ((*globalTypePtr)->getDeclType() != Decl::Global_Type_Decl) {
+      throw std::runtime_error("Final Expression is required to be a Global type expression.");
+    }
+
+    const bool generates = !channelsPath.empty() || !monitorPath.empty() ||
+                           !sessionPath.empty() || !coroutinesPath.empty();
+    if (onlyproj || generates) {
+      // Projection of every demanded participant, without a CAST mapping
+      Proj_PchorASTVisitor Proj_visitor(Context, demand);
+      (*globalTypePtr)->accept(Proj_visitor);
+      if (!channelsPath.empty()) {
+        // the kind of a channel depends on all of its senders and recievers,
+        // not only the demanded ones
+        const auto channelProjections =
+            demand.all() ? Proj_visitor.getContext()
+                         : projectChoreography(Context, *sTable);
+        ChannelGenerator generator{*sTable, *channelProjections};
+        generator.write(channelsPath);
+        std::println(out, "Channels written to {}", channelsPath);
+      }
+      if (!monitorPath.empty()) {
+        MonitorGenerator generator{*Proj_visitor.getContext()};
+        generator.write(monitorPath);
+        std::println(out, "Monitors written to {}", monitorPath);
+      }
+      if (!sessionPath.empty()) {
+        SessionGenerator generator{*Proj_visitor.getContext()};
+        generator.write(sessionPath);
+        std::println(out, "Session API written to {}", sessionPath);
+      }
+      if (!coroutinesPath.empty()) {
+        CoroutineGenerator generator{*Proj_visitor.getContext()};
+        generator.write(coroutinesPath);
+        std::println(out, "Coroutine skeletons written to {}", coroutinesPath);
+      }
+      if (onlyproj) {
+        Proj_visitor.printProjections();
+        return;
+      }
+    }
+
+    // Full pipeline
+    CAST_PchorASTVisitor CAST_visitor(Context);
+
+    for (auto itr = sTable->begin(); itr != sTable->end(); ++itr) {
+      if ((*itr)->getDeclType() != Decl::Global_Type_Decl ||
+          (std::distance(itr, sTable->end()) == 1 && (*itr)->getDeclType() == Decl::Global_Type_Decl)) {
+        (*itr)->accept(CAST_visitor);
+      }
+    }
+    if (CAST_visitor.getMappedParticipants().empty()) {
+      throw std::runtime_error(
+          "No participant of the choreography is declared in this translation "
+          "unit");
+    }
+    for (const std::string &name : CAST_visitor.getMissingParticipants()) {
+      std::println(out,
+                   "No declaration for participant {} in this translation unit",
+                   name);
+    }
+    std::println(out, "CAST mapping created");
+
+    // participants not declared in this translation unit are not projected
+    ParticipantDemand projected = demand;
+    if (projected.all() && !CAST_visitor.getMissingParticipants().empty()) {
+      for (const std::string &name : CAST_visitor.getMappedParticipants()) {
+        projected.addParticipant(name);
+      }
+    }
+    Proj_PchorASTVisitor Proj_visitor(Context, projected);
+    (*globalTypePtr)->accept(Proj_visitor);
+    std::println(out, "Projection created");
+
+    auto CASTMapping = CAST_visitor.getContext();
+    auto Projections = Proj_visitor.getContext();
+
+    std::unique_ptr<ResultWriter> results = nullptr;
+    if (!resultsPath.empty()) {
+      results = std::make_unique<ResultWriter>(resultsPath);
+    }
+    CASTValidator validator{results.get()};
+    validator.validateProjection(Context, CASTMapping, Projections);
+
+    if (debug) {
+      CAST_visitor.printMappings();
+      Proj_visitor.printProjections();
+    }
+
+    validator.printValidations(out);
+
+    if (!falseSharing && !unsynchronized) {
+      return;
+    }
+    // the channel analyses need the sends of every participant, also of
+    // those neither demanded nor declared in this translation unit
+    const auto channelProjections =
+        projected.all() ? Projections
+                        : projectChoreography(Context, *sTable);
+
+    const ChannelUseIndex channels{*sTable, *channelProjections};
+
+    if (falseSharing) {
+      FalseSharingAnalysis sharing{Context, *CASTMapping,
+                                   *channelProjections, channels};
+      sharing.printReports(out);
+    }
+    if (unsynchronized) {
+      UnsynchronizedChannelAnalysis analysis{*CASTMapping, channels};
+      analysis.printReports(out);
+    }
+
+  } catch (const std::exception &e) {
+    std::println(out, "Error in CAST Mapping or Choreography Projection: \n{}",
+                 e.what());
+  }
+}
+
+} // namespace PchorAST
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <clang/AST/ASTContext.h>
+
+#include "../pchor/parser/PchorParser.hpp"
+#include "./utils/ContextManager.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace PchorAST {
+
+/*
+  Shared entrypoints of the analysis pipeline. Used by the clang plugin for a
+  single compilation, and by pchord, which keeps the results of both stages
+  alive between requests.
+*/
+
+// Tokenizes and parses a .cor-file. Throws on malformed choreographies
+std::shared_ptr<SymbolTable> parseChoreography(const std::string &corFilePath,
+                                               bool debug);
+
+// Projects the participants in demand, every one by default, without mapping
+// them to a translation unit. Throws if the choreography does not end in a
+// global type
+std::shared_ptr<PchorProjection>
+projectChoreography(clang::ASTContext &Context, const SymbolTable &sTable,
+                    const ParticipantDemand &demand = {});
+
+// Runs CAST mapping, projection and validation on a fully created clang AST.
+// The result of every participant is also written to resultsPath, if given.
+// Only the participants in demand are projected, by default those declared
+// in the translation unit. If channelsPath, monitorPath, sessionPath or
+// coroutinesPath is given, a header of channel types, of runtime monitor
+// tables, of the typestate session API or of coroutine skeletons for the
+// choreography is generated there from the projection. falseSharing and
+// unsynchronized report channel fields that share a cache line with fields
+// of other writers, or lack a concurrent type; as both need the senders and
+// recievers of every channel, they project every participant. The report of
+// the run is written to out; debug dumps always go to stdout
+void runChoreographyAnalysis(clang::ASTContext &Context,
+                             const std::shared_ptr<SymbolTable> &sTable,
+                             bool debug, bool onlyproj,
+                             const std::string &resultsPath = "",
+                             const ParticipantDemand &demand = {},
+                             const std::string &channelsPath = "",
+                             const std::string &monitorPath = "",
+                             const std::string &sessionPath = "",
+                             const std::string &coroutinesPath = "",
+                             bool falseSharing = false,
+                             bool unsynchronized = false,
+                             std::FILE *out = stdout);
+
+} // namespace PchorAST
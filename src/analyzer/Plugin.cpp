@@ -3,15 +3,11 @@
 #include "clang/Frontend/FrontendPluginRegistry.h"
 #include "llvm/Support/raw_ostream.h"
 
-#include "../pchor/parser/PchorParser.hpp"
-#include "./visitors/AstVisitor.hpp"
-#include "./visitors/CASTValidator.hpp"
-#include "./utils/ContextManager.hpp"
+#include "./PchorAnalysis.hpp"
 
 #include <memory>
 #include <string>
 #include <vector>
-#include <iterator>
 
 using namespace clang;
 
@@ -19,68 +15,38 @@ namespace {
 class ChoreographyAstConsumer : public ASTConsumer {
 public:
   explicit ChoreographyAstConsumer(
-      std::shared_ptr<PchorAST::SymbolTable> sTable, bool debug, bool onlyproj)
-      : sTable(std::move(sTable)), debug(debug), onlyproj(onlyproj) {}
+      std::shared_ptr<PchorAST::SymbolTable> sTable, bool debug, bool onlyproj,
+      std::string resultsPath, PchorAST::ParticipantDemand demand,
+      std::string channelsPath, std::string monitorPath,
+      std::string sessionPath, std::string coroutinesPath, bool falseSharing,
+      bool unsynchronized)
+      : sTable(std::move(sTable)), debug(debug), onlyproj(onlyproj),
+        resultsPath(std::move(resultsPath)), demand(std::move(demand)),
+        channelsPath(std::move(channelsPath)),
+        monitorPath(std::move(monitorPath)),
+        sessionPath(std::move(sessionPath)),
+        coroutinesPath(std::move(coroutinesPath)), falseSharing(falseSharing),
+        unsynchronized(unsynchronized) {}
 void HandleTranslationUnit(ASTContext &Context) override {
-    llvm::outs() << "\n\nAST has been fully created. CASTMapping and Choreography Projection Commencing!\n";
-    try {
-      if (!sTable) {
-        llvm::outs() << "Error: HandleTranslationUnit received no SymbolTable. Continuing to compilation\n";
-        return;
-      }
-
-      llvm::outs() << "Symbol table correctly passed to ChoreographyAstConsumer\n";
-      auto globalTypePtr = sTable->back();
-      if ((*globalTypePtr)->getDeclType() != PchorAST::Decl::Global_Type_Decl) {
-        throw std::runtime_error("Final Expression is required to be a Global type expression.");
-      }
-
-      if (onlyproj) {
-        // Only projection logic
-        PchorAST::Proj_PchorASTVisitor Proj_visitor(Context);
-        (*globalTypePtr)->accept(Proj_visitor);
-        Proj_visitor.printProjections();
-        return;
-      }
-
-      // Full pipeline
-      PchorAST::CAST_PchorASTVisitor CAST_visitor(Context);
-      PchorAST::Proj_PchorASTVisitor Proj_visitor(Context);
-
-      for (auto itr = sTable->begin(); itr != sTable->end(); ++itr) {
-        if ((*itr)->getDeclType() != PchorAST::Decl::Global_Type_Decl ||
-            (std::distance(itr, sTable->end()) == 1 && (*itr)->getDeclType() == PchorAST::Decl::Global_Type_Decl)) {
-          (*itr)->accept(CAST_visitor);
-        }
-      }
-      llvm::outs() << "CAST mapping created\n";
-      (*globalTypePtr)->accept(Proj_visitor);
-      llvm::outs() << "Projection created\n";
-
-      auto CASTMapping = CAST_visitor.getContext();
-      auto Projections = Proj_visitor.getContext();
-
-      PchorAST::CASTValidator validator{};
-      validator.validateProjection(Context, CASTMapping, Projections);
-
-      if (debug) {
-        CAST_visitor.printMappings();
-        Proj_visitor.printProjections();
-      }
-
-      validator.printValidations();
-
-    } catch (const std::exception &e) {
-      llvm::errs() << "Error in CAST Mapping or Choreography Projection: \n"
-                   << e.what() << "\n";
-                   
-    }
+    PchorAST::runChoreographyAnalysis(Context, sTable, debug, onlyproj,
+                                      resultsPath, demand, channelsPath,
+                                      monitorPath, sessionPath,
+                                      coroutinesPath, falseSharing,
+                                      unsynchronized);
 }
 
 private:
   std::shared_ptr<PchorAST::SymbolTable> sTable;
   bool debug;
   bool onlyproj;
+  std::string resultsPath;
+  PchorAST::ParticipantDemand demand;
+  std::string channelsPath;
+  std::string monitorPath;
+  std::string sessionPath;
+  std::string coroutinesPath;
+  bool falseSharing;
+  bool unsynchronized;
 };
 
 class ChoreographyValidatorFrontendAction : public PluginASTAction {
@@ -88,13 +54,24 @@ class ChoreographyValidatorFrontendAction : public PluginASTAction {
   std::shared_ptr<PchorAST::SymbolTable> sTable;
   bool debug;
   bool onlyproj;
+  std::string resultsPath;
+  PchorAST::ParticipantDemand demand;
+  std::string channelsPath;
+  std::string monitorPath;
+  std::string sessionPath;
+  std::string coroutinesPath;
+  bool falseSharing;
+  bool unsynchronized;
 
 protected:
   std::unique_ptr<ASTConsumer>
   CreateASTConsumer([[maybe_unused]] CompilerInstance &CI,
                     llvm::StringRef) override {
     // Create and return your AST consumer that prints messages.
-    return std::make_unique<ChoreographyAstConsumer>(std::move(sTable), debug, onlyproj);
+    return std::make_unique<ChoreographyAstConsumer>(
+        std::move(sTable), debug, onlyproj, resultsPath, std::move(demand),
+        channelsPath, monitorPath, sessionPath, coroutinesPath, falseSharing,
+        unsynchronized);
   }
 
   bool ParseArgs([[maybe_unused]] const CompilerInstance &CI,
@@ -102,6 +79,8 @@ protected:
     // Handle plugin arguments if any.
     debug = false;
     onlyproj = false;
+    falseSharing = false;
+    unsynchronized = false;
     for (const auto &arg : args) {
       if (arg.find("--cor=") != std::string::npos) {
         corFilePath = arg.substr(arg.find("--cor=") + 6);
@@ -111,6 +90,47 @@ protected:
         debug = true;
         llvm::outs() << "Debug flag found. Debug Output will be printed\n";
       }
+      if (arg.find("--results=") != std::string::npos) {
+        resultsPath = arg.substr(arg.find("--results=") + 10);
+        llvm::outs() << "Results will be written to: " << resultsPath << "\n";
+      }
+      if (arg.find("--channels=") != std::string::npos) {
+        channelsPath = arg.substr(arg.find("--channels=") + 11);
+        llvm::outs() << "Channels will be generated to: " << channelsPath
+                     << "\n";
+      }
+      if (arg.find("--monitor=") != std::string::npos) {
+        monitorPath = arg.substr(arg.find("--monitor=") + 10);
+        llvm::outs() << "Monitors will be generated to: " << monitorPath
+                     << "\n";
+      }
+      if (arg.find("--session=") != std::string::npos) {
+        sessionPath = arg.substr(arg.find("--session=") + 10);
+        llvm::outs() << "Session API will be generated to: " << sessionPath
+                     << "\n";
+      }
+      if (arg.find("--coroutines=") != std::string::npos) {
+        coroutinesPath = arg.substr(arg.find("--coroutines=") + 13);
+        llvm::outs() << "Coroutine skeletons will be generated to: "
+                     << coroutinesPath << "\n";
+      }
+      if (arg.find("--participant=") != std::string::npos) {
+        try {
+          demand.parse(arg.substr(arg.find("--participant=") + 14));
+        } catch (const std::exception &e) {
+          llvm::errs() << "Error: " << e.what() << "\n";
+          return false;
+        }
+      }
+      if (arg.find("--false-sharing") != std::string::npos) {
+        falseSharing = true;
+        llvm::outs() << "False sharing of channel fields will be reported\n";
+      }
+      if (arg.find("--unsynchronized") != std::string::npos) {
+        unsynchronized = true;
+        llvm::outs()
+            << "Channel fields without a concurrent type will be reported\n";
+      }
       if(arg.find("--projection") != std::string::npos) {
         onlyproj = true;
         llvm::outs() << "Projection flag found. Program will only generate local type projections\n";
@@ -124,19 +144,7 @@ protected:
     }
 
     try {
-      PchorAST::PchorParser parser{corFilePath};
-      parser.genTokens();
-      if(debug) {
-        parser.printTokenList();
-      }
-      parser.parse();
-
-      if (debug) {
-        parser.printAST();
-      }
-
-      sTable = parser.getChorAST();
-
+      sTable = PchorAST::parseChoreography(corFilePath, debug);
     } catch (const std::exception &e) {
       llvm::errs() << "Error processing .cor-file:" << e.what() << "\n";
       return false;
@@ -0,0 +1,97 @@
+#include "AnnotationIndex.hpp"
+
+#include <clang/AST/Attr.h>
+#include <clang/AST/RecursiveASTVisitor.h>
+
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+namespace PchorAST {
+
+static constexpr std::string_view participantPrefix = "pchor:participant=";
+static constexpr std::string_view channelPrefix = "pchor:channel=";
+
+class AnnotationCollector
+    : public clang::RecursiveASTVisitor<AnnotationCollector> {
+public:
+  explicit AnnotationCollector(AnnotationIndex &index,
+                               const clang::SourceManager &sourceManager)
+      : index(index), sourceManager(sourceManager) {}
+
+  // system headers carry no annotations, so their declarations, and the
+  // bodies within them, are not traversed at all
+  bool TraverseDecl(clang::Decl *decl) {
+    if (decl && !llvm::isa<clang::TranslationUnitDecl>(decl) &&
+        sourceManager.isInSystemHeader(decl->getLocation())) {
+      return true;
+    }
+    return clang::RecursiveASTVisitor<AnnotationCollector>::TraverseDecl(decl);
+  }
+
+  bool VisitCXXRecordDecl(clang::CXXRecordDecl *record) {
+    if (!record->isThisDeclarationADefinition()) {
+      return true;
+    }
+    for (const auto *attr : record->specific_attrs<clang::AnnotateAttr>()) {
+      std::string_view annotation = attr->getAnnotation();
+      if (!annotation.starts_with(participantPrefix)) {
+        continue;
+      }
+      std::string name{annotation.substr(participantPrefix.size())};
+      auto [it, inserted] = index.participants.emplace(name, record);
+      if (!inserted && it->second != record) {
+        throw std::runtime_error(std::format(
+            "Participant {} is annotated on both {} and {}\n", name,
+            it->second->getNameAsString(), record->getNameAsString()));
+      }
+    }
+    return true;
+  }
+
+  bool VisitFieldDecl(clang::FieldDecl *field) {
+    for (const auto *attr : field->specific_attrs<clang::AnnotateAttr>()) {
+      std::string_view annotation = attr->getAnnotation();
+      if (!annotation.starts_with(channelPrefix)) {
+        continue;
+      }
+      std::string channel{annotation.substr(channelPrefix.size())};
+      const clang::Decl *record = field->getParent();
+      auto [it, inserted] = index.channels.emplace(
+          AnnotationIndex::ChannelKey{record, channel}, field);
+      if (!inserted && it->second != field) {
+        throw std::runtime_error(std::format(
+            "Channel {} is annotated on both {} and {} of {}\n", channel,
+            it->second->getNameAsString(), field->getNameAsString(),
+            field->getParent()->getNameAsString()));
+      }
+      index.channelFields.insert(field);
+    }
+    return true;
+  }
+
+private:
+  AnnotationIndex &index;
+  const clang::SourceManager &sourceManager;
+};
+
+AnnotationIndex::AnnotationIndex(clang::ASTContext &context)
+    : participants(), channels(), channelFields() {
+  AnnotationCollector collector{*this, context.getSourceManager()};
+  collector.TraverseDecl(context.getTranslationUnitDecl());
+}
+
+const clang::CXXRecordDecl *
+AnnotationIndex::findParticipant(const std::string &name) const {
+  auto it = participants.find(name);
+  return it != participants.end() ? it->second : nullptr;
+}
+
+const clang::FieldDecl *
+AnnotationIndex::findChannel(const clang::Decl *record,
+                             const std::string &channel) const {
+  auto it = channels.find(ChannelKey{record, channel});
+  return it != channels.end() ? it->second : nullptr;
+}
+
+} // namespace PchorAST
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Decl.h>
+#include <clang/AST/DeclCXX.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace PchorAST {
+
+/*
+  Explicit mapping of the choreography onto the code, written as annotations
+  on classes and fields:
+
+    class [[clang::annotate("pchor:participant=Worker")]] Worker { ... };
+    [[clang::annotate("pchor:channel=urgent")]] Job first;
+
+  All annotations of a translation unit are collected in one traversal,
+  which leaves out the declarations of system headers.
+  Participants and channels found here are mapped exactly, only the names
+  without an annotation are left to the heuristic searches.
+*/
+class AnnotationIndex {
+public:
+  explicit AnnotationIndex(clang::ASTContext &context);
+
+  AnnotationIndex(const AnnotationIndex &other) = delete;
+  AnnotationIndex &operator=(const AnnotationIndex &other) = delete;
+
+  // nullptr if no class is annotated as participant
+  const clang::CXXRecordDecl *findParticipant(const std::string &name) const;
+  // nullptr if no field of record is annotated as channel
+  const clang::FieldDecl *findChannel(const clang::Decl *record,
+                                      const std::string &channel) const;
+  // every field annotated as a channel
+  const std::unordered_set<const clang::FieldDecl *> &getChannelFields() const {
+    return channelFields;
+  }
+
+private:
+  struct ChannelKey {
+    const clang::Decl *record;
+    std::string channel;
+    bool operator==(const ChannelKey &other) const {
+      return record == other.record && channel == other.channel;
+    }
+  };
+  struct ChannelKeyHash {
+    size_t operator()(const ChannelKey &key) const {
+      return std::hash<const clang::Decl *>{}(key.record) ^
+             (std::hash<std::string>{}(key.channel) << 1);
+    }
+  };
+
+  std::unordered_map<std::string, const clang::CXXRecordDecl *> participants;
+  std::unordered_map<ChannelKey, const clang::FieldDecl *, ChannelKeyHash>
+      channels;
+  std::unordered_set<const clang::FieldDecl *> channelFields;
+
+  friend class AnnotationCollector;
+};
+
+} // namespace PchorAST
@@ -148,6 +148,34 @@ const clang::Decl *AnalyzerUtils::findDecl(clang::ASTContext &context,
   return result;
 }
 
+const clang::EnumDecl *AnalyzerUtils::findEnumDecl(clang::ASTContext &context,
+                                                   const std::string &name) {
+  auto matcher = clang::ast_matchers::enumDecl(
+                     clang::ast_matchers::hasName(name),
+                     clang::ast_matchers::isDefinition())
+                     .bind("enumDecl");
+
+  const clang::EnumDecl *result = nullptr;
+
+  MatchCallback<clang::EnumDecl> callback(result, "enumDecl");
+  clang::ast_matchers::MatchFinder finder;
+  finder.addMatcher(matcher, &callback);
+  finder.matchAST(context);
+
+  return result;
+}
+
+const clang::EnumConstantDecl *
+AnalyzerUtils::findEnumConstant(const clang::EnumDecl *enumDecl,
+                                const std::string &label) {
+  for (const auto *enumerator : enumDecl->enumerators()) {
+    if (enumerator->getName() == label) {
+      return enumerator;
+    }
+  }
+  return nullptr;
+}
+
 std::vector<const clang::FunctionDecl *>
 AnalyzerUtils::findDataTypeInClass(clang::ASTContext &context,
                                    const clang::Decl *decl,
@@ -212,53 +240,6 @@ AnalyzerUtils::findDataTypeInClass(clang::ASTContext &context,
   return results;
 }
 
-const clang::FieldDecl *
-AnalyzerUtils::findMatchingMember(clang::ASTContext &context,
-                                  const clang::Decl *decl,
-                                  const std::string &typeName) {
-
-  auto directDeclaration = clang::ast_matchers::hasDeclaration(
-      clang::ast_matchers::namedDecl(clang::ast_matchers::hasName(typeName)));
-  auto pointerDeclaration = clang::ast_matchers::pointerType(
-      clang::ast_matchers::pointee(directDeclaration));
-  auto templateDeclaration = clang::ast_matchers::hasDeclaration(
-      clang::ast_matchers::classTemplateSpecializationDecl(
-          clang::ast_matchers::hasTemplateArgument(
-              0, clang::ast_matchers::templateArgument(
-                     clang::ast_matchers::refersToType(
-                         clang::ast_matchers::qualType(directDeclaration))))));
-  auto templatePointerDeclaration = clang::ast_matchers::pointerType(
-      clang::ast_matchers::pointee(templateDeclaration));
-  auto fieldMatcher =
-      clang::ast_matchers::fieldDecl(
-          clang::ast_matchers::hasType(clang::ast_matchers::qualType(
-              clang::ast_matchers::anyOf(directDeclaration, pointerDeclaration,
-                                         templateDeclaration,
-                                         templatePointerDeclaration))))
-          .bind("fieldDecl");
-  const clang::FieldDecl *field = nullptr;
-
-  const clang::CXXRecordDecl *record =
-      llvm::dyn_cast<clang::CXXRecordDecl>(decl);
-  if (!record) {
-    throw std::runtime_error(
-        std::format("Recieved Declaration is not a class. Recieved {}",
-                    decl->getDeclKindName()));
-  }
-
-  clang::ast_matchers::MatchFinder finder;
-  MatchCallback<clang::FieldDecl> callback(field, "fieldDecl");
-  finder.addMatcher(fieldMatcher, &callback);
-
-  for (const auto *matchField : record->fields()) {
-    finder.match(*matchField, context);
-    if (field != nullptr) {
-      break;
-    }
-  }
-  return field;
-}
-
 bool AnalyzerUtils::validateSendExpression(const clang::Stmt *opCallExpr,
                                            const clang::Decl *channelDecl,
                                            const clang::Decl *typeDecl,
@@ -352,12 +333,31 @@ bool AnalyzerUtils::validateSendExpression(const clang::Stmt *opCallExpr,
       )
     ).bind("sendAssignment");
 
+  // a coroutine sends by awaiting send on the channel of its peer
+  auto awaitedSendMatcher = clang::ast_matchers::expr(
+      clang::ast_matchers::hasDescendant(
+          clang::ast_matchers::cxxMemberCallExpr(
+              clang::ast_matchers::callee(clang::ast_matchers::cxxMethodDecl(
+                  clang::ast_matchers::hasName("send"))),
+              clang::ast_matchers::on(lhsTypeMatcher),
+              clang::ast_matchers::hasArgument(
+                  0, clang::ast_matchers::ignoringImplicit(
+                         clang::ast_matchers::ignoringParenImpCasts(
+                             rhsTypeMatcher))))))
+      .bind("sendAssignment");
+
   // Use MatchFinder to debug the matcher
   const clang::Expr *matched = nullptr;
   clang::ast_matchers::MatchFinder finder;
-  finder.addMatcher(expressionMatcher,
-                    new DebugStoreMatchCallback<clang::Expr>(
-                        "sendAssignment", matched));
+  if (llvm::isa<clang::CoawaitExpr>(opCallExpr)) {
+    finder.addMatcher(awaitedSendMatcher,
+                      new DebugStoreMatchCallback<clang::Expr>(
+                          "sendAssignment", matched));
+  } else {
+    finder.addMatcher(expressionMatcher,
+                      new DebugStoreMatchCallback<clang::Expr>(
+                          "sendAssignment", matched));
+  }
 
   // Run the matcher on the AST node
   finder.match(*opCallExpr, context);
@@ -372,6 +372,150 @@ bool AnalyzerUtils::validateSendExpression(const clang::Stmt *opCallExpr,
   return matched != nullptr;
 }
 
+const clang::EnumConstantDecl *
+AnalyzerUtils::findSelectedLabel(const clang::Stmt *stmt,
+                                 const clang::Decl *channelDecl,
+                                 const clang::Decl *labelDecl,
+                                 clang::ASTContext &context) {
+  if (!stmt || !channelDecl || !labelDecl) {
+    llvm::errs() << "Invalid input to findSelectedLabel.\n";
+    return nullptr;
+  }
+
+  auto labelMatcher = clang::ast_matchers::declRefExpr(
+      clang::ast_matchers::to(
+          clang::ast_matchers::enumConstantDecl(
+              clang::ast_matchers::hasDeclContext(
+                  clang::ast_matchers::equalsNode(labelDecl)))
+              .bind("selectedLabel")));
+
+  auto directMemberExpr =
+      clang::ast_matchers::memberExpr(
+          clang::ast_matchers::member(clang::ast_matchers::fieldDecl(
+              clang::ast_matchers::equalsNode(channelDecl))));
+  auto lhsMatcher = clang::ast_matchers::anyOf(
+      directMemberExpr, clang::ast_matchers::hasDescendant(directMemberExpr));
+  auto rhsMatcher = clang::ast_matchers::ignoringImplicit(
+      clang::ast_matchers::ignoringParenImpCasts(labelMatcher));
+
+  // plain enums are assigned with '=', atomics and wrappers with operator=
+  auto assignmentMatcher = clang::ast_matchers::expr(
+      clang::ast_matchers::anyOf(
+          clang::ast_matchers::binaryOperator(
+              clang::ast_matchers::hasOperatorName("="),
+              clang::ast_matchers::hasLHS(lhsMatcher),
+              clang::ast_matchers::hasRHS(rhsMatcher)),
+          clang::ast_matchers::cxxOperatorCallExpr(
+              clang::ast_matchers::hasOverloadedOperatorName("="),
+              clang::ast_matchers::hasArgument(0, lhsMatcher),
+              clang::ast_matchers::hasArgument(1, rhsMatcher))));
+
+  // or, in a coroutine, by awaiting send on the channel with the label
+  auto awaitedSendMatcher = clang::ast_matchers::cxxMemberCallExpr(
+      clang::ast_matchers::callee(
+          clang::ast_matchers::cxxMethodDecl(clang::ast_matchers::hasName("send"))),
+      clang::ast_matchers::on(lhsMatcher),
+      clang::ast_matchers::hasArgument(0, rhsMatcher));
+
+  clang::ast_matchers::StatementMatcher selectMatcher =
+      llvm::isa<clang::CoawaitExpr>(stmt)
+          ? clang::ast_matchers::stmt(
+                clang::ast_matchers::hasDescendant(awaitedSendMatcher))
+          : clang::ast_matchers::stmt(clang::ast_matchers::anyOf(
+                assignmentMatcher,
+                clang::ast_matchers::hasDescendant(assignmentMatcher)));
+
+  const clang::EnumConstantDecl *label = nullptr;
+  MatchCallback<clang::EnumConstantDecl> callback(label, "selectedLabel");
+  clang::ast_matchers::MatchFinder finder;
+  finder.addMatcher(selectMatcher, &callback);
+  finder.match(*stmt, context);
+
+  return label;
+}
+
+const clang::EnumConstantDecl *
+AnalyzerUtils::findLabelReference(const clang::Stmt *stmt,
+                                  const clang::Decl *labelDecl,
+                                  clang::ASTContext &context) {
+  if (!stmt || !labelDecl) {
+    llvm::errs() << "Invalid input to findLabelReference.\n";
+    return nullptr;
+  }
+
+  auto labelMatcher = clang::ast_matchers::declRefExpr(
+      clang::ast_matchers::to(
+          clang::ast_matchers::enumConstantDecl(
+              clang::ast_matchers::hasDeclContext(
+                  clang::ast_matchers::equalsNode(labelDecl)))
+              .bind("referencedLabel")));
+
+  const clang::EnumConstantDecl *label = nullptr;
+  MatchCallback<clang::EnumConstantDecl> callback(label, "referencedLabel");
+  clang::ast_matchers::MatchFinder finder;
+  finder.addMatcher(
+      clang::ast_matchers::stmt(clang::ast_matchers::anyOf(
+          labelMatcher, clang::ast_matchers::hasDescendant(labelMatcher))),
+      &callback);
+  finder.match(*stmt, context);
+
+  return label;
+}
+
+LabelComparison AnalyzerUtils::findLabelComparison(
+    const clang::Expr *cond, const clang::Decl *channelDecl,
+    const clang::Decl *labelDecl, clang::ASTContext &context) {
+  if (!cond || !channelDecl || !labelDecl) {
+    llvm::errs() << "Invalid input to findLabelComparison.\n";
+    return LabelComparison{nullptr, true};
+  }
+  const auto *comparison =
+      llvm::dyn_cast<clang::BinaryOperator>(cond->IgnoreParenImpCasts());
+  if (!comparison || !comparison->isEqualityOp()) {
+    return LabelComparison{nullptr, true};
+  }
+
+  auto enumerator =
+      [labelDecl](const clang::Expr *expr) -> const clang::EnumConstantDecl * {
+    const auto *ref =
+        llvm::dyn_cast<clang::DeclRefExpr>(expr->IgnoreParenImpCasts());
+    const auto *label =
+        ref ? llvm::dyn_cast<clang::EnumConstantDecl>(ref->getDecl()) : nullptr;
+    return label && llvm::dyn_cast<clang::EnumDecl>(
+                        label->getDeclContext()) == labelDecl
+               ? label
+               : nullptr;
+  };
+  // the channel member itself, or the variable a coroutine awaited its recv
+  // into
+  auto recieved = [channelDecl, &context](const clang::Expr *expr) {
+    expr = expr->IgnoreParenImpCasts();
+    if (const auto *member = llvm::dyn_cast<clang::MemberExpr>(expr)) {
+      return member->getMemberDecl() == channelDecl;
+    }
+    const auto *ref = llvm::dyn_cast<clang::DeclRefExpr>(expr);
+    const auto *var =
+        ref ? llvm::dyn_cast<clang::VarDecl>(ref->getDecl()) : nullptr;
+    if (!var || !var->getInit()) {
+      return false;
+    }
+    const clang::Expr *init = var->getInit()->IgnoreImplicit();
+    return llvm::isa<clang::CoawaitExpr>(init) &&
+           validateRecieveExpression(init, channelDecl, nullptr, context);
+  };
+
+  const bool equal = comparison->getOpcode() == clang::BO_EQ;
+  if (const auto *label = enumerator(comparison->getRHS());
+      label && recieved(comparison->getLHS())) {
+    return LabelComparison{label, equal};
+  }
+  if (const auto *label = enumerator(comparison->getLHS());
+      label && recieved(comparison->getRHS())) {
+    return LabelComparison{label, equal};
+  }
+  return LabelComparison{nullptr, true};
+}
+
 bool AnalyzerUtils::validateRecieveExpression(
     const clang::Stmt *whileStmt, const clang::Decl *channelDecl,
     [[maybe_unused]] const clang::Decl *typeDecl, clang::ASTContext &context) {
@@ -381,6 +525,31 @@ bool AnalyzerUtils::validateRecieveExpression(
     return false;
   }
 
+  // a coroutine recieves by awaiting recv on its channel instead of waiting
+  // in a loop
+  if (llvm::isa<clang::CoawaitExpr>(whileStmt)) {
+    auto awaitMatcher =
+        clang::ast_matchers::expr(
+            clang::ast_matchers::hasDescendant(
+                clang::ast_matchers::cxxMemberCallExpr(
+                    clang::ast_matchers::callee(
+                        clang::ast_matchers::cxxMethodDecl(
+                            clang::ast_matchers::hasName("recv"))),
+                    clang::ast_matchers::on(clang::ast_matchers::memberExpr(
+                        clang::ast_matchers::member(
+                            clang::ast_matchers::fieldDecl(
+                                clang::ast_matchers::equalsNode(
+                                    channelDecl))))))))
+            .bind("recvAwait");
+
+    const clang::Expr *awaited = nullptr;
+    MatchCallback<clang::Expr> callback(awaited, "recvAwait");
+    clang::ast_matchers::MatchFinder finder;
+    finder.addMatcher(awaitMatcher, &callback);
+    finder.match(*whileStmt, context);
+    return awaited != nullptr;
+  }
+
   auto whileMatcher =
       clang::ast_matchers::whileStmt(
           clang::ast_matchers::hasCondition(
@@ -104,6 +104,12 @@ CrossTypeMatchCallback<clang::CXXMemberCallExpr, clang::CXXMethodDecl>::extract(
   return node->getMethodDecl();
 }
 
+// Enumerator a label is compared against, and whether for (in)equality
+struct LabelComparison {
+  const clang::EnumConstantDecl *label;
+  bool equal;
+};
+
 class AnalyzerUtils {
 public:
   // print functions for debugging
@@ -118,24 +124,44 @@ public:
   static const clang::FunctionDecl *
   getFullDecl(const clang::FunctionDecl *funcDecl);
 
+  // Labels: an enum named after the Label declaration, one enumerator per label
+  static const clang::EnumDecl *findEnumDecl(clang::ASTContext &context,
+                                             const std::string &name);
+  static const clang::EnumConstantDecl *
+  findEnumConstant(const clang::EnumDecl *enumDecl, const std::string &label);
+
   static std::vector<const clang::FunctionDecl *>
   findDataTypeInClass(clang::ASTContext &context, const clang::Decl *decl,
                       const std::string &typeName);
 
-  static const clang::FieldDecl *
-  findMatchingMember(clang::ASTContext &context, const clang::Decl *decl,
-                     const std::string &typeName);
-
   // Validation Functions
   static bool validateSendExpression(const clang::Stmt *opCallExpr,
                                      const clang::Decl *channelDecl,
                                      const clang::Decl *typeDecl,
                                      clang::ASTContext &context);
-  // Validation Functions
+  // A loop waiting on channelDecl, or an await of its recv in a coroutine
   static bool validateRecieveExpression(
       const clang::Stmt *whileStmt, const clang::Decl *channelDecl,
       [[maybe_unused]] const clang::Decl *typeDecl, clang::ASTContext &context);
 
+  // Label assigned to the channel member in stmt, or sent over it by an
+  // awaited send, or nullptr
+  static const clang::EnumConstantDecl *
+  findSelectedLabel(const clang::Stmt *stmt, const clang::Decl *channelDecl,
+                    const clang::Decl *labelDecl, clang::ASTContext &context);
+
+  // First enumerator of labelDecl referenced anywhere in stmt, or nullptr
+  static const clang::EnumConstantDecl *
+  findLabelReference(const clang::Stmt *stmt, const clang::Decl *labelDecl,
+                     clang::ASTContext &context);
+  // Enumerator of labelDecl that cond compares the label recieved over
+  // channelDecl against with == or !=. The label is nullptr for any other
+  // condition
+  static LabelComparison findLabelComparison(const clang::Expr *cond,
+                                             const clang::Decl *channelDecl,
+                                             const clang::Decl *labelDecl,
+                                             clang::ASTContext &context);
+
   static const clang::FunctionDecl *
   findFunctionDefinition(const clang::Stmt *possibleFunctionCall,
                          clang::ASTContext &context);
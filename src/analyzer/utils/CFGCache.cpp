@@ -0,0 +1,39 @@
+#include "CFGCache.hpp"
+
+#include <clang/AST/StmtCXX.h>
+
+namespace PchorAST {
+
+const FunctionCFG *CFGCache::get(const clang::FunctionDecl *funcDecl) {
+  if (auto it = cfgs.find(funcDecl); it != cfgs.end()) {
+    return it->second.get();
+  }
+
+  std::unique_ptr<FunctionCFG> entry = nullptr;
+  clang::Stmt *body = funcDecl->getBody();
+  // the CFG of a coroutine follows the body as written, without the promise
+  // and suspend points the compiler wraps around it
+  if (auto *coroutine =
+          llvm::dyn_cast_or_null<clang::CoroutineBodyStmt>(body)) {
+    body = coroutine->getBody();
+  }
+  if (body) {
+    clang::CFG::BuildOptions options{};
+    std::unique_ptr<clang::CFG> cfg =
+        clang::CFG::buildCFG(funcDecl, body, &context, options);
+    if (cfg) {
+      entry = std::make_unique<FunctionCFG>();
+      entry->blocks.resize(cfg->getNumBlockIDs(), nullptr);
+      for (const clang::CFGBlock *block : *cfg) {
+        entry->blocks[block->getBlockID()] = block;
+      }
+      entry->blocks[cfg->getEntry().getBlockID()] = &cfg->getEntry();
+      entry->blocks[cfg->getExit().getBlockID()] = &cfg->getExit();
+      entry->cfg = std::move(cfg);
+    }
+  }
+  // failures are cached too, so they are not retried for every caller
+  return cfgs.emplace(funcDecl, std::move(entry)).first->second.get();
+}
+
+} // namespace PchorAST
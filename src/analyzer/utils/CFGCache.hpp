@@ -0,0 +1,40 @@
+#pragma once
+
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Decl.h>
+#include <clang/Analysis/CFG.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace PchorAST {
+
+// Control flow graph of a function, with its blocks indexed by block id
+struct FunctionCFG {
+  std::unique_ptr<clang::CFG> cfg;
+  std::vector<const clang::CFGBlock *> blocks;
+};
+
+/*
+  Builds the CFG of every function at most once per analysis run, no matter
+  how many participants or callers validate it. CFGs point into the AST, so
+  a cache must not outlive the ASTContext it was built for.
+*/
+class CFGCache {
+public:
+  explicit CFGCache(clang::ASTContext &context) : context(context), cfgs() {}
+
+  CFGCache(const CFGCache &other) = delete;
+  CFGCache &operator=(const CFGCache &other) = delete;
+
+  // nullptr if funcDecl has no body or clang cannot build a CFG for it
+  const FunctionCFG *get(const clang::FunctionDecl *funcDecl);
+
+private:
+  clang::ASTContext &context;
+  std::unordered_map<const clang::FunctionDecl *, std::unique_ptr<FunctionCFG>>
+      cfgs;
+};
+
+} // namespace PchorAST
@@ -0,0 +1,119 @@
+#include "ChannelAccessIndex.hpp"
+
+#include <clang/AST/Expr.h>
+#include <clang/AST/ExprCXX.h>
+
+#include <algorithm>
+
+namespace PchorAST {
+
+void ChannelAccessIndex::index(const clang::FunctionDecl *funcDecl) {
+  if (!funcDecl || !indexed.insert(funcDecl).second) {
+    return;
+  }
+  if (const clang::Stmt *body = funcDecl->getBody()) {
+    collect(body, AccessKind::Read);
+  }
+}
+
+std::span<const ChannelAccess>
+ChannelAccessIndex::getAccesses(const clang::Stmt *stmt) const {
+  auto it = ranges.find(stmt);
+  if (it == ranges.end()) {
+    return {};
+  }
+  return std::span<const ChannelAccess>(events).subspan(
+      it->second.begin, it->second.end - it->second.begin);
+}
+
+bool ChannelAccessIndex::contains(std::span<const ChannelAccess> accesses,
+                                  const clang::Decl *channel) {
+  return std::any_of(accesses.begin(), accesses.end(),
+                     [channel](const ChannelAccess &access) {
+                       return access.channel == channel;
+                     });
+}
+
+bool ChannelAccessIndex::contains(std::span<const ChannelAccess> accesses,
+                                  const clang::Decl *channel,
+                                  AccessKind kind) {
+  return std::any_of(accesses.begin(), accesses.end(),
+                     [channel, kind](const ChannelAccess &access) {
+                       return access.channel == channel && access.kind == kind;
+                     });
+}
+
+void ChannelAccessIndex::collect(const clang::Stmt *stmt, AccessKind kind) {
+  if (!stmt) {
+    return;
+  }
+  const auto begin = static_cast<uint32_t>(events.size());
+
+  if (const auto *member = llvm::dyn_cast<clang::MemberExpr>(stmt)) {
+    const auto *field =
+        llvm::dyn_cast<clang::FieldDecl>(member->getMemberDecl());
+    if (field && channels.contains(field)) {
+      events.push_back(ChannelAccess{field, kind});
+    }
+    // writing to a member of an object writes to the object as well
+    collect(member->getBase(),
+            kind == AccessKind::Write ? kind : AccessKind::Read);
+  } else if (const auto *binary =
+                 llvm::dyn_cast<clang::BinaryOperator>(stmt);
+             binary && binary->isAssignmentOp()) {
+    collect(binary->getLHS(), AccessKind::Write);
+    collect(binary->getRHS(), AccessKind::Read);
+  } else if (const auto *opCall =
+                 llvm::dyn_cast<clang::CXXOperatorCallExpr>(stmt);
+             opCall && opCall->isAssignmentOp() && opCall->getNumArgs() == 2) {
+    collect(opCall->getArg(0), AccessKind::Write);
+    collect(opCall->getArg(1), AccessKind::Read);
+  } else if (const auto *await = llvm::dyn_cast<clang::CoawaitExpr>(stmt)) {
+    // awaiting send on a channel sends over it, like assigning to it
+    const auto *call = llvm::dyn_cast<clang::CXXMemberCallExpr>(
+        await->getOperand()->IgnoreImplicit());
+    const clang::CXXMethodDecl *method = call ? call->getMethodDecl() : nullptr;
+    if (method && method->getIdentifier() && method->getName() == "send") {
+      collect(call->getImplicitObjectArgument(), AccessKind::Write);
+      for (const clang::Expr *arg : call->arguments()) {
+        collect(arg, AccessKind::Read);
+      }
+    } else {
+      collect(await->getOperand(), kind);
+    }
+  } else if (const auto *memberCall =
+                 llvm::dyn_cast<clang::CXXMemberCallExpr>(stmt)) {
+    collect(memberCall->getImplicitObjectArgument(), AccessKind::Call);
+    for (const clang::Expr *arg : memberCall->arguments()) {
+      collect(arg, AccessKind::Read);
+    }
+  } else if (const auto *subscript =
+                 llvm::dyn_cast<clang::ArraySubscriptExpr>(stmt)) {
+    collect(subscript->getBase(), kind);
+    collect(subscript->getIdx(), AccessKind::Read);
+  } else if (const auto *unary = llvm::dyn_cast<clang::UnaryOperator>(stmt);
+             unary && unary->getOpcode() == clang::UO_Deref) {
+    collect(unary->getSubExpr(), kind);
+  } else if (llvm::isa<clang::ImplicitCastExpr, clang::ParenExpr,
+                       clang::MaterializeTemporaryExpr>(stmt)) {
+    // wrappers are used the way the expression they wrap is
+    collectChildren(stmt, kind);
+  } else {
+    collectChildren(stmt, AccessKind::Read);
+  }
+
+  // statements without channel accesses are left out, they map to no range
+  const auto end = static_cast<uint32_t>(events.size());
+  if (end > begin) {
+    ranges.insert_or_assign(stmt, Range{begin, end});
+  }
+}
+
+void ChannelAccessIndex::collectChildren(const clang::Stmt *stmt,
+                                         AccessKind kind) {
+  for (const clang::Stmt *child : stmt->children()) {
+    collect(child, kind);
+  }
+}
+
+} // namespace PchorAST
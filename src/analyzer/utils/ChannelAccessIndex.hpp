@@ -0,0 +1,71 @@
+#pragma once
+
+#include <clang/AST/Decl.h>
+#include <clang/AST/Stmt.h>
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace PchorAST {
+
+enum class AccessKind : uint8_t {
+  Read,  // the value of the channel is used
+  Write, // assigned to, or through, or sent over by an awaited send
+  Call   // a method of the channel is called
+};
+
+struct ChannelAccess {
+  const clang::FieldDecl *channel;
+  AccessKind kind;
+};
+
+/*
+  Uses of the channel fields of a protocol, recorded by walking every function
+  body once. The accesses of a body are appended in statement order to one
+  event array, so the accesses within any statement of the body are a
+  contiguous range of it. Ranges are only kept for statements containing an
+  access; every other statement maps to the empty range, which lets the
+  validators skip them without searching their subtrees.
+*/
+class ChannelAccessIndex {
+public:
+  explicit ChannelAccessIndex(
+      std::unordered_set<const clang::FieldDecl *> channels)
+      : channels(std::move(channels)), events(), ranges(), indexed() {}
+
+  ChannelAccessIndex(const ChannelAccessIndex &other) = delete;
+  ChannelAccessIndex &operator=(const ChannelAccessIndex &other) = delete;
+
+  // Walks the body of funcDecl, unless it has already been indexed
+  void index(const clang::FunctionDecl *funcDecl);
+
+  // Accesses within stmt in statement order, stmt must belong to an indexed
+  // body. The span is invalidated by indexing another function
+  std::span<const ChannelAccess> getAccesses(const clang::Stmt *stmt) const;
+
+  static bool contains(std::span<const ChannelAccess> accesses,
+                       const clang::Decl *channel);
+  static bool contains(std::span<const ChannelAccess> accesses,
+                       const clang::Decl *channel, AccessKind kind);
+
+private:
+  struct Range {
+    uint32_t begin;
+    uint32_t end;
+  };
+
+  std::unordered_set<const clang::FieldDecl *> channels;
+  std::vector<ChannelAccess> events;
+  std::unordered_map<const clang::Stmt *, Range> ranges;
+  std::unordered_set<const clang::FunctionDecl *> indexed;
+
+  // Records the accesses within stmt, which is used as described by kind
+  void collect(const clang::Stmt *stmt, AccessKind kind);
+  void collectChildren(const clang::Stmt *stmt, AccessKind kind);
+};
+
+} // namespace PchorAST
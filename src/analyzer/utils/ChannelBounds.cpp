@@ -0,0 +1,201 @@
+#include "ChannelBounds.hpp"
+
+#include <algorithm>
+#include <set>
+
+namespace PchorAST {
+
+ChannelBoundAnalysis::ChannelBoundAnalysis(const PchorProjection &projection)
+    : participants(), counterIndex(), indexIds(), indexBounds(),
+      indexChannel(), channelIds(), channelBounds() {
+  std::map<CounterKey, size_t> counters{};
+  for (const auto &[participant, projections] : projection) {
+    const LocalAutomaton automaton{projections};
+    Steps steps(automaton.size());
+    for (size_t state = 0; state < automaton.size(); ++state) {
+      for (const auto &transition : automaton.getState(state).transitions) {
+        const auto &com = *transition.projection;
+        switch (transition.kind) {
+        case TransitionKind::Send:
+          steps[state].push_back(Step{
+              counterOf(counters, com, com.getTypeName()), true,
+              transition.target});
+          break;
+        case TransitionKind::Select:
+          steps[state].push_back(Step{counterOf(counters, com, transition.label),
+                                      true, transition.target});
+          break;
+        case TransitionKind::Recieve:
+          // a recieved label picks its branch, so it is recieved per label
+          if (automaton.isChoice(transition.target)) {
+            for (const auto &label :
+                 automaton.getState(transition.target).transitions) {
+              steps[state].push_back(Step{
+                  counterOf(counters, com, label.label), false, label.target});
+            }
+          } else {
+            steps[state].push_back(Step{
+                counterOf(counters, com, com.getTypeName()), false,
+                transition.target});
+          }
+          break;
+        case TransitionKind::Label:
+          // taken together with the recieve into the choice state
+          break;
+        }
+      }
+    }
+    participants.push_back(std::move(steps));
+  }
+
+  if (!explore()) {
+    for (ChannelBound &bound : indexBounds) {
+      if (bound.kind == BoundKind::Bounded) {
+        bound.kind = BoundKind::Unknown;
+      }
+    }
+    for (ChannelBound &bound : channelBounds) {
+      if (bound.kind == BoundKind::Bounded) {
+        bound.kind = BoundKind::Unknown;
+      }
+    }
+  }
+}
+
+const ChannelBound *ChannelBoundAnalysis::getBound(const std::string &channel,
+                                                   size_t index) const {
+  auto it = indexIds.find({channel, index});
+  return it != indexIds.end() ? &indexBounds[it->second] : nullptr;
+}
+
+const ChannelBound *
+ChannelBoundAnalysis::getBound(const std::string &channel) const {
+  auto it = channelIds.find(channel);
+  return it != channelIds.end() ? &channelBounds[it->second] : nullptr;
+}
+
+size_t ChannelBoundAnalysis::counterOf(std::map<CounterKey, size_t> &counters,
+                                       const AbstractComProjection &projection,
+                                       const std::string &payload) {
+  const std::string &channel = projection.getChannelName();
+  const size_t index = projection.getChannelIndex();
+  auto [counter, added] = counters.try_emplace(
+      CounterKey{channel, index, payload}, counterIndex.size());
+  if (!added) {
+    return counter->second;
+  }
+
+  auto [channelId, newChannel] =
+      channelIds.try_emplace(channel, channelBounds.size());
+  if (newChannel) {
+    channelBounds.push_back(ChannelBound{BoundKind::Bounded, 0});
+  }
+  auto [indexId, newIndex] =
+      indexIds.try_emplace({channel, index}, indexBounds.size());
+  if (newIndex) {
+    indexBounds.push_back(ChannelBound{BoundKind::Bounded, 0});
+    indexChannel.push_back(channelId->second);
+  }
+  counterIndex.push_back(indexId->second);
+  return counter->second;
+}
+
+bool ChannelBoundAnalysis::explore() {
+  // a configuration is the state of every participant, followed by the
+  // counters
+  const size_t states = participants.size();
+  struct Frame {
+    std::vector<uint32_t> configuration;
+    size_t participant;
+    size_t step;
+  };
+
+  std::vector<uint32_t> initial(states + counterIndex.size(), 0);
+  std::set<std::vector<uint32_t>> visited{initial};
+  record(initial);
+  std::vector<Frame> path{Frame{std::move(initial), 0, 0}};
+  while (!path.empty()) {
+    Frame &frame = path.back();
+    if (frame.participant == states) {
+      path.pop_back();
+      continue;
+    }
+    const auto &steps =
+        participants[frame.participant][frame.configuration[frame.participant]];
+    if (frame.step == steps.size()) {
+      ++frame.participant;
+      frame.step = 0;
+      continue;
+    }
+    const Step &step = steps[frame.step++];
+    if (!step.send && frame.configuration[states + step.counter] == 0) {
+      continue;
+    }
+
+    std::vector<uint32_t> next = frame.configuration;
+    next[frame.participant] = static_cast<uint32_t>(step.target);
+    uint32_t &counter = next[states + step.counter];
+    if (counter != omega) {
+      counter = step.send ? counter + 1 : counter - 1;
+    }
+    // repeating the path from an ancestor it covers grows the counters that
+    // grew along it without bound
+    for (const Frame &ancestor : path) {
+      const auto &previous = ancestor.configuration;
+      if (!std::equal(previous.begin(), previous.begin() + states,
+                      next.begin()) ||
+          !std::equal(previous.begin() + states, previous.end(),
+                      next.begin() + states,
+                      [](uint32_t lhs, uint32_t rhs) { return lhs <= rhs; })) {
+        continue;
+      }
+      for (size_t i = states; i < next.size(); ++i) {
+        if (previous[i] < next[i]) {
+          next[i] = omega;
+        }
+      }
+    }
+
+    if (!visited.insert(next).second) {
+      continue;
+    }
+    if (visited.size() > maxConfigurations) {
+      return false;
+    }
+    record(next);
+    path.push_back(Frame{std::move(next), 0, 0});
+  }
+  return true;
+}
+
+void ChannelBoundAnalysis::record(const std::vector<uint32_t> &configuration) {
+  const size_t states = participants.size();
+  std::vector<size_t> inFlight(indexBounds.size(), 0);
+  std::vector<bool> unbounded(indexBounds.size(), false);
+  for (size_t counter = 0; counter < counterIndex.size(); ++counter) {
+    const uint32_t messages = configuration[states + counter];
+    if (messages == omega) {
+      unbounded[counterIndex[counter]] = true;
+    } else {
+      inFlight[counterIndex[counter]] += messages;
+    }
+  }
+
+  std::vector<size_t> channelInFlight(channelBounds.size(), 0);
+  for (size_t index = 0; index < indexBounds.size(); ++index) {
+    ChannelBound &bound = indexBounds[index];
+    ChannelBound &channelBound = channelBounds[indexChannel[index]];
+    if (unbounded[index]) {
+      bound.kind = BoundKind::Unbounded;
+      channelBound.kind = BoundKind::Unbounded;
+    }
+    bound.messages = std::max(bound.messages, inFlight[index]);
+    channelInFlight[indexChannel[index]] += inFlight[index];
+  }
+  for (size_t channel = 0; channel < channelBounds.size(); ++channel) {
+    channelBounds[channel].messages =
+        std::max(channelBounds[channel].messages, channelInFlight[channel]);
+  }
+}
+
+} // namespace PchorAST
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "../../pchor/ast/PchorAutomaton.hpp"
+#include "../../pchor/ast/PchorProjection.hpp"
+#include "ContextManager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace PchorAST {
+
+enum class BoundKind : uint8_t {
+  Bounded,
+  // a sender may run ahead of its reciever by any number of messages
+  Unbounded,
+  // the configurations of the protocol were too many to explore
+  Unknown
+};
+
+struct ChannelBound {
+  BoundKind kind;
+  // most messages in flight at once, if bounded
+  size_t messages;
+};
+
+/*
+  Computes how many messages may be in flight on every channel index at
+  once, under the asynchronous semantics of the choreography: a send never
+  waits for its reciever, so the messages on an index are those its sender
+  has sent and its reciever not yet recieved.
+
+  The local automata of all projected participants are run together, with a
+  counter of the messages in flight for every channel index and payload (or
+  label). Recieves are enabled by a positive counter of their payload, which
+  ignores the order of the messages on an index, so the bounds found are
+  upper bounds. Exploration follows Karp and Miller: a configuration that
+  repeats the states of one it was reached from, with at least as many
+  messages in flight on every index, can repeat its path forever, and the
+  indices whose counters grew are unbounded. This finds the recursions and
+  foreach loops in which a sender does not have to wait for its reciever.
+
+  Exploration stops after maxConfigurations configurations, and bounds not
+  settled by then are Unknown.
+*/
+class ChannelBoundAnalysis {
+public:
+  static constexpr size_t maxConfigurations = size_t{1} << 17;
+
+  explicit ChannelBoundAnalysis(const PchorProjection &projection);
+
+  // Bound of one channel index, or null if no participant uses it
+  const ChannelBound *getBound(const std::string &channel, size_t index) const;
+  // Bound of the messages in flight over all indices of a channel together,
+  // as they share the ring of a combining channel
+  const ChannelBound *getBound(const std::string &channel) const;
+
+private:
+  // a counter of some configuration marked as growing without bound
+  static constexpr uint32_t omega = UINT32_MAX;
+
+  struct Step {
+    size_t counter;
+    bool send;
+    size_t target;
+  };
+  // transitions of every state of one participant
+  using Steps = std::vector<std::vector<Step>>;
+  using CounterKey = std::tuple<std::string, size_t, std::string>;
+
+  std::vector<Steps> participants;
+  // channel index of every counter, counted per channel index and payload
+  std::vector<size_t> counterIndex;
+  std::map<std::pair<std::string, size_t>, size_t> indexIds;
+  std::vector<ChannelBound> indexBounds;
+  // channel of every channel index
+  std::vector<size_t> indexChannel;
+  std::map<std::string, size_t> channelIds;
+  std::vector<ChannelBound> channelBounds;
+
+  size_t counterOf(std::map<CounterKey, size_t> &counters,
+                   const AbstractComProjection &projection,
+                   const std::string &payload);
+  // Explores every configuration, returns false if there were too many
+  bool explore();
+  void record(const std::vector<uint32_t> &configuration);
+};
+
+} // namespace PchorAST
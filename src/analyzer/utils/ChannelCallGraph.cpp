@@ -0,0 +1,128 @@
+#include "ChannelCallGraph.hpp"
+#include "CASTAnalyzerUtils.hpp"
+
+#include <clang/AST/DeclCXX.h>
+#include <clang/Analysis/CallGraph.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace PchorAST {
+
+bool ChannelCallGraph::mayCommunicate(const clang::FunctionDecl *funcDecl) {
+  if (!funcDecl) {
+    return false;
+  }
+  if (!built) {
+    build();
+  }
+  const clang::Decl *canonical = funcDecl->getCanonicalDecl();
+  return !known.contains(canonical) || communicating.contains(canonical) ||
+         unresolved.contains(canonical);
+}
+
+bool ChannelCallGraph::mayUse(const clang::FunctionDecl *funcDecl,
+                              const clang::FieldDecl *channel) {
+  if (!funcDecl) {
+    return false;
+  }
+  if (!built) {
+    build();
+  }
+  const clang::Decl *canonical = funcDecl->getCanonicalDecl();
+  if (!known.contains(canonical) || unresolved.contains(canonical)) {
+    return true;
+  }
+  auto it = users.find(channel);
+  return it != users.end() && it->second.contains(canonical);
+}
+
+void ChannelCallGraph::build() {
+  built = true;
+  clang::CallGraph callGraph{};
+  callGraph.addToCallGraph(context.getTranslationUnitDecl());
+
+  // callers of every function, and the functions using a channel themselves
+  std::unordered_map<const clang::Decl *, std::vector<const clang::Decl *>>
+      callers{};
+  for (const auto &[decl, node] : callGraph) {
+    const auto *funcDecl = llvm::dyn_cast_or_null<clang::FunctionDecl>(decl);
+    if (!funcDecl || context.getSourceManager().isInSystemHeader(
+                         funcDecl->getLocation())) {
+      continue;
+    }
+    const clang::Decl *canonical = funcDecl->getCanonicalDecl();
+    known.insert(canonical);
+    for (const clang::CallGraphNode::CallRecord &callee : *node) {
+      if (const clang::Decl *calleeDecl = callee.Callee->getDecl()) {
+        callers[calleeDecl->getCanonicalDecl()].push_back(canonical);
+      }
+    }
+    // the call graph records the static callee of a virtual call only
+    if (const auto *method = llvm::dyn_cast<clang::CXXMethodDecl>(funcDecl)) {
+      for (const clang::CXXMethodDecl *overridden :
+           method->overridden_methods()) {
+        callers[canonical].push_back(overridden->getCanonicalDecl());
+      }
+    }
+
+    const clang::FunctionDecl *definition = funcDecl->getDefinition();
+    if (!definition || !definition->getBody()) {
+      continue;
+    }
+    if (hasUnresolvedCall(definition)) {
+      unresolved.insert(canonical);
+    }
+    accessIndex.index(definition);
+    for (const ChannelAccess &access :
+         accessIndex.getAccesses(definition->getBody())) {
+      users[access.channel].insert(canonical);
+    }
+  }
+
+  // a function uses a channel, or makes an unresolved call, if anything it
+  // calls does
+  auto propagate = [&callers](std::unordered_set<const clang::Decl *> &into) {
+    std::vector<const clang::Decl *> worklist(into.begin(), into.end());
+    while (!worklist.empty()) {
+      const clang::Decl *callee = worklist.back();
+      worklist.pop_back();
+      auto it = callers.find(callee);
+      if (it == callers.end()) {
+        continue;
+      }
+      for (const clang::Decl *caller : it->second) {
+        if (into.insert(caller).second) {
+          worklist.push_back(caller);
+        }
+      }
+    }
+  };
+  for (auto &[channel, channelUsers] : users) {
+    propagate(channelUsers);
+    communicating.insert(channelUsers.begin(), channelUsers.end());
+  }
+  propagate(unresolved);
+}
+
+bool ChannelCallGraph::hasUnresolvedCall(
+    const clang::FunctionDecl *definition) const {
+  // the callee of such a call is a variable or an expression, not a function
+  auto unresolvedCall =
+      clang::ast_matchers::callExpr(
+          clang::ast_matchers::unless(clang::ast_matchers::callee(
+              clang::ast_matchers::functionDecl())))
+          .bind("unresolvedCall");
+
+  const clang::CallExpr *call = nullptr;
+  MatchCallback<clang::CallExpr> callback(call, "unresolvedCall");
+  clang::ast_matchers::MatchFinder finder;
+  finder.addMatcher(
+      clang::ast_matchers::stmt(clang::ast_matchers::anyOf(
+          unresolvedCall, clang::ast_matchers::hasDescendant(unresolvedCall))),
+      &callback);
+  finder.match(*definition->getBody(), context);
+  return call != nullptr;
+}
+
+} // namespace PchorAST
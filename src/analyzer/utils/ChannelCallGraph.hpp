@@ -0,0 +1,67 @@
+#pragma once
+
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Decl.h>
+
+#include "ChannelAccessIndex.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace PchorAST {
+
+/*
+  Tells which functions of the translation unit may communicate over the
+  channels of the protocol: those using a channel field in their body, and
+  every function calling one of them, directly or through other calls. This
+  is kept per channel field, so the functions that may use one channel can
+  be looked up without analysing any of them. The call graph of the
+  translation unit is built on the first query, and only once per analysis
+  run.
+
+  A virtual call may run any override of its callee, so an override counts
+  as called by every method it overrides. A call the graph cannot resolve,
+  through a function pointer or a pointer to member, may run anything: the
+  function making it, and its callers, may use every channel. Functions the
+  call graph does not know about are assumed to communicate, so they are
+  still descended into. Like the validator, the graph leaves out functions
+  declared in system headers.
+*/
+class ChannelCallGraph {
+public:
+  explicit ChannelCallGraph(clang::ASTContext &context,
+                            ChannelAccessIndex &accessIndex)
+      : context(context), accessIndex(accessIndex), built(false), known(),
+        communicating(), users(), unresolved() {}
+
+  ChannelCallGraph(const ChannelCallGraph &other) = delete;
+  ChannelCallGraph &operator=(const ChannelCallGraph &other) = delete;
+
+  // False only if funcDecl provably never uses a channel
+  bool mayCommunicate(const clang::FunctionDecl *funcDecl);
+  // False only if funcDecl provably never uses channel
+  bool mayUse(const clang::FunctionDecl *funcDecl,
+              const clang::FieldDecl *channel);
+
+private:
+  clang::ASTContext &context;
+  ChannelAccessIndex &accessIndex;
+  bool built;
+  // canonical declarations of the functions in the call graph
+  std::unordered_set<const clang::Decl *> known;
+  std::unordered_set<const clang::Decl *> communicating;
+  // functions using each channel, directly or through calls
+  std::unordered_map<const clang::FieldDecl *,
+                     std::unordered_set<const clang::Decl *>>
+      users;
+  // functions making a call the graph cannot resolve, directly or through
+  // calls
+  std::unordered_set<const clang::Decl *> unresolved;
+
+  void build();
+  // True if the body of definition calls through a function pointer or a
+  // pointer to member
+  bool hasUnresolvedCall(const clang::FunctionDecl *definition) const;
+};
+
+} // namespace PchorAST
@@ -0,0 +1,184 @@
+#include "ChannelGenerator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace PchorAST {
+
+ChannelGenerator::ChannelGenerator(const SymbolTable &sTable,
+                                   const PchorProjection &projection)
+    : projection(projection), uses(sTable, projection), bounds() {}
+
+const ChannelBoundAnalysis &ChannelGenerator::getBounds() const {
+  if (!bounds) {
+    bounds.emplace(projection);
+  }
+  return *bounds;
+}
+
+std::string ChannelGenerator::generate() const {
+  std::set<std::string> includes{};
+  std::string body{};
+  for (const std::string &channel : uses.getChannels()) {
+    body.append(generateChannel(channel, includes));
+  }
+
+  std::string header =
+      "// Generated by PChorAnalyzer from the Channel declarations of a\n"
+      "// choreography. Include it after the payload types are declared.\n"
+      "#pragma once\n\n";
+  for (const std::string &include : includes) {
+    header.append(std::format("#include \"pchor/runtime/{}\"\n", include));
+  }
+  header.append("\n#include <cstddef>\n\nnamespace PchorChannels {\n\n");
+  header.append(body);
+  header.append("} // namespace PchorChannels\n");
+  return header;
+}
+
+void ChannelGenerator::write(const std::string &path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error(
+        std::format("Could not open {} to write channels to", path));
+  }
+  file << generate();
+}
+
+std::string
+ChannelGenerator::generateChannel(const std::string &channel,
+                                  std::set<std::string> &includes) const {
+  const auto *indices = uses.getUses(channel);
+  if (!indices) {
+    return std::format("// {}: not used by the projected participants\n\n",
+                       channel);
+  }
+
+  std::set<std::string> payloads{};
+  std::set<std::string> senders{};
+  std::set<std::string> recievers{};
+  size_t messages = 0;
+  size_t totalMessages = 0;
+  bool recursive = false;
+  // messages in flight on the busiest index
+  ChannelBound indexBound{BoundKind::Bounded, 0};
+  for (const auto &[index, use] : *indices) {
+    payloads.insert(use.payloads.begin(), use.payloads.end());
+    senders.insert(use.senders.begin(), use.senders.end());
+    recievers.insert(use.recievers.begin(), use.recievers.end());
+    messages = std::max(messages, use.messages);
+    totalMessages += use.messages;
+    recursive = recursive || use.recursive;
+    const ChannelBound *bound = getBounds().getBound(channel, index);
+    indexBound.kind = std::max(indexBound.kind, bound->kind);
+    indexBound.messages = std::max(indexBound.messages, bound->messages);
+  }
+  if (payloads.size() != 1) {
+    return std::format("// {}: carries {} payload types, not generated\n\n",
+                       channel, payloads.size());
+  }
+  const std::string &payload = *payloads.begin();
+  const ChannelKind kind = uses.getKind(channel);
+
+  // Capacity for the messages in flight, rounded up to a power of two, with
+  // the description of the bound. Unexplored channels are sized for every
+  // message sent over them instead
+  auto capacityFor = [&](const ChannelBound &bound, size_t sent,
+                         size_t least) {
+    switch (bound.kind) {
+    case BoundKind::Bounded:
+      return std::pair{std::bit_ceil(std::max(bound.messages, least)),
+                       std::format("at most {} message{} in flight",
+                                   bound.messages,
+                                   bound.messages == 1 ? "" : "s")};
+    case BoundKind::Unbounded:
+      return std::pair{
+          std::max(std::bit_ceil(std::max(bound.messages, least)),
+                   defaultCapacity),
+          std::string{"unbounded, as a sender may run ahead of its "
+                      "reciever within a recursion"}};
+    case BoundKind::Unknown:
+      break;
+    }
+    const size_t capacity = std::bit_ceil(std::max(sent, least));
+    if (recursive) {
+      return std::pair{std::max(capacity, defaultCapacity),
+                       std::string{"sent on within a recursion"}};
+    }
+    return std::pair{capacity, std::format("at most {} message{}", sent,
+                                           sent == 1 ? "" : "s")};
+  };
+  // capacity and boundedness are exported for buffers sized alongside
+  auto declare = [&channel](const std::string &comment, size_t capacity,
+                            const ChannelBound &bound,
+                            const std::string &type) {
+    return std::format(
+        "// {}: {}\n"
+        "inline constexpr std::size_t {}_capacity = {};\n"
+        "inline constexpr bool {}_bounded = {};\n"
+        "using {} = {};\n\n",
+        channel, comment, channel, capacity, channel,
+        bound.kind == BoundKind::Bounded ? "true" : "false", channel, type);
+  };
+
+  // one sender to a different reciever at every index: the payload is
+  // stored once and read by every reciever
+  if (kind == ChannelKind::Multicast) {
+    includes.insert("MulticastChannel.hpp");
+    const auto [capacity, bound] = capacityFor(indexBound, messages, 1);
+    return declare(
+        std::format("{} -> {} recievers (numbered from index {}[{}]), {}{}",
+                    *senders.begin(), recievers.size(), channel,
+                    indices->begin()->first, bound,
+                    indexBound.kind == BoundKind::Bounded ||
+                            (indexBound.kind == BoundKind::Unknown &&
+                             !recursive)
+                        ? " each"
+                        : ""),
+        capacity, indexBound,
+        std::format("PchorRuntime::MulticastChannel<{}, {}_capacity, {}>",
+                    payload, channel, recievers.size()));
+  }
+  // many senders to one reciever combine into a single ring
+  if (kind == ChannelKind::Mpsc) {
+    includes.insert("MpscChannel.hpp");
+    const ChannelBound &channelBound = *getBounds().getBound(channel);
+    const auto [capacity, bound] =
+        capacityFor(channelBound, totalMessages, 2);
+    return declare(std::format("{} senders -> {}, {} in total",
+                               senders.size(), *recievers.begin(), bound),
+                   capacity, channelBound,
+                   std::format("PchorRuntime::MpscChannel<{}, {}_capacity>",
+                               payload, channel));
+  }
+  if (kind == ChannelKind::None) {
+    for (const auto &[index, use] : *indices) {
+      if (use.senders.size() != 1 || use.recievers.size() != 1) {
+        return std::format("// {}[{}]: {} senders and {} recievers, not "
+                           "generated\n\n",
+                           channel, index, use.senders.size(),
+                           use.recievers.size());
+      }
+    }
+  }
+
+  includes.insert("SpscChannel.hpp");
+  const ChannelUse &first = indices->begin()->second;
+  std::string pairs = std::format("{} -> {}", *first.senders.begin(),
+                                  *first.recievers.begin());
+  if (indices->size() > 1) {
+    const size_t more = indices->size() - 1;
+    pairs.append(std::format(" and {} more {}", more,
+                             more == 1 ? "index" : "indices"));
+  }
+  const auto [capacity, bound] = capacityFor(indexBound, messages, 1);
+  return declare(std::format("{}, {}", pairs, bound), capacity, indexBound,
+                 std::format("PchorRuntime::SpscChannel<{}, {}_capacity>",
+                             payload, channel));
+}
+
+} // namespace PchorAST
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../../pchor/ast/PchorProjection.hpp"
+#include "../../pchor/parser/PchorParser.hpp"
+#include "ChannelBounds.hpp"
+#include "ChannelUseIndex.hpp"
+#include "ContextManager.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <set>
+#include <string>
+
+namespace PchorAST {
+
+/*
+  Generates a header declaring a lock-free channel type (pchor/runtime) for
+  every Channel declaration of a choreography. The sender/reciever pairs and
+  the payload of every channel index are read from the projections of the
+  participants, which picks the kind of channel (see ChannelUseIndex). A
+  MulticastChannel stores each payload once, with a cursor per reciever.
+
+  A channel is sized for the messages it may hold at once, as found by the
+  ChannelBoundAnalysis, which only explores the protocol once a header is
+  generated: the messages in flight on its busiest index (or over
+  all indices, for a combining channel), rounded up to a power of two. The
+  capacity is exported as d_capacity, and d_bounded tells whether it bounds
+  every run of the protocol. Unbounded channels, and channels sent on
+  within a recursion whose bound is unknown, get at least defaultCapacity,
+  and block their sender while full. Channels carrying several payload types
+  are not generated. Each generated type is named after its channel, so a
+  participant declares its channel field as
+
+    PchorChannels::d d;
+
+  which the CAST mapping resolves to channel d by its name and payload.
+*/
+class ChannelGenerator {
+public:
+  static constexpr size_t defaultCapacity = 64;
+
+  ChannelGenerator(const SymbolTable &sTable,
+                   const PchorProjection &projection);
+
+  std::string generate() const;
+  // Writes the generated header to path, throws if it cannot be written
+  void write(const std::string &path) const;
+
+private:
+  const PchorProjection &projection;
+  ChannelUseIndex uses;
+  // explored on first use
+  mutable std::optional<ChannelBoundAnalysis> bounds;
+
+  const ChannelBoundAnalysis &getBounds() const;
+  // Declaration of the channel type, adding the runtime header it needs
+  std::string generateChannel(const std::string &channel,
+                              std::set<std::string> &includes) const;
+};
+
+} // namespace PchorAST
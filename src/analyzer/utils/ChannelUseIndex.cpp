@@ -0,0 +1,114 @@
+#include "ChannelUseIndex.hpp"
+
+namespace PchorAST {
+
+ChannelUseIndex::ChannelUseIndex(const SymbolTable &sTable,
+                                 const PchorProjection &projection)
+    : channels(), uses() {
+  for (auto itr = sTable.begin(); itr != sTable.end(); ++itr) {
+    if ((*itr)->getDeclType() == Decl::Channel_Decl) {
+      channels.push_back((*itr)->getName());
+    }
+  }
+  for (const auto &[participant, projections] : projection) {
+    collect(participant, projections, false);
+  }
+}
+
+const std::map<size_t, ChannelUse> *
+ChannelUseIndex::getUses(const std::string &channel) const {
+  auto it = uses.find(channel);
+  return it != uses.end() ? &it->second : nullptr;
+}
+
+ChannelKind ChannelUseIndex::getKind(const std::string &channel) const {
+  const auto *indices = getUses(channel);
+  if (!indices) {
+    return ChannelKind::None;
+  }
+  std::set<std::string> payloads{};
+  std::set<std::string> senders{};
+  std::set<std::string> recievers{};
+  bool pointToPoint = true;
+  for (const auto &[index, use] : *indices) {
+    payloads.insert(use.payloads.begin(), use.payloads.end());
+    senders.insert(use.senders.begin(), use.senders.end());
+    recievers.insert(use.recievers.begin(), use.recievers.end());
+    pointToPoint = pointToPoint && use.senders.size() == 1 &&
+                   use.recievers.size() == 1;
+  }
+  if (payloads.size() != 1) {
+    return ChannelKind::None;
+  }
+  if (pointToPoint && indices->size() > 1 && senders.size() == 1 &&
+      recievers.size() == indices->size()) {
+    return ChannelKind::Multicast;
+  }
+  if (recievers.size() == 1 && senders.size() > 1) {
+    return ChannelKind::Mpsc;
+  }
+  return pointToPoint ? ChannelKind::Spsc : ChannelKind::None;
+}
+
+std::string_view ChannelUseIndex::getTemplate(ChannelKind kind) {
+  switch (kind) {
+  case ChannelKind::Spsc:
+    return "SpscChannel";
+  case ChannelKind::Mpsc:
+    return "MpscChannel";
+  case ChannelKind::Multicast:
+    return "MulticastChannel";
+  case ChannelKind::None:
+    break;
+  }
+  return "";
+}
+
+void ChannelUseIndex::collect(const ParticipantKey &participant,
+                              const ProjectionList &projections,
+                              bool recursive) {
+  for (const AbstractProjection &proj : projections) {
+    if (proj.getType() == ProjectionType::Rec) {
+      const auto &rec = static_cast<const Prec &>(proj);
+      collect(participant, rec.getBody(), true);
+      continue;
+    }
+    if (!proj.isComProjection()) {
+      continue;
+    }
+
+    ChannelUse &use = uses[proj.getChannelName()][proj.getChannelIndex()];
+    use.payloads.insert(proj.getTypeName());
+    use.recursive = use.recursive || recursive;
+    if (proj.getType() == ProjectionType::Send ||
+        proj.getType() == ProjectionType::Select) {
+      use.senders.insert(participant.toString());
+      ++use.messages;
+    } else {
+      use.recievers.insert(participant.toString());
+    }
+
+    if (proj.getType() == ProjectionType::Select ||
+        proj.getType() == ProjectionType::Branch) {
+      const auto &choice = static_cast<const AbstractChoiceProjection &>(proj);
+      for (const auto &[label, branch] : choice.getBranches()) {
+        collect(participant, branch, recursive);
+      }
+    }
+  }
+}
+
+std::string joinParticipants(const std::set<std::string> &participants) {
+  std::string str{};
+  size_t pos = 0;
+  for (const std::string &name : participants) {
+    if (pos > 0) {
+      str.append(pos + 1 == participants.size() ? " and " : ", ");
+    }
+    str.append(name);
+    ++pos;
+  }
+  return str;
+}
+
+} // namespace PchorAST
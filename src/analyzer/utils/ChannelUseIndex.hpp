@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../../pchor/ast/PchorProjection.hpp"
+#include "../../pchor/parser/PchorParser.hpp"
+#include "ContextManager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PchorAST {
+
+// One index of a channel, as used by the projected participants
+struct ChannelUse {
+  std::set<std::string> payloads;
+  std::set<std::string> senders;
+  std::set<std::string> recievers;
+  // sends over the index in one run of the protocol, sizing the channel if
+  // its bound is unknown
+  size_t messages;
+  // sent on within a recursion, so messages does not bound it
+  bool recursive;
+};
+
+// Lock-free channel of pchor/runtime implementing a channel
+enum class ChannelKind : uint8_t {
+  Spsc,
+  Mpsc,
+  Multicast,
+  // unused, with several payload types, or with several senders and
+  // recievers on one index
+  None
+};
+
+/*
+  The senders, recievers and payloads of every channel index, collected in
+  one pass over the projections of all participants. This is all the
+  channel reports need; the messages in flight are only explored by the
+  generators that size channels for them.
+*/
+class ChannelUseIndex {
+public:
+  ChannelUseIndex(const SymbolTable &sTable,
+                  const PchorProjection &projection);
+
+  const std::map<size_t, ChannelUse> *getUses(const std::string &channel) const;
+  // Channel declarations, in order of the .cor-file
+  const std::vector<std::string> &getChannels() const { return channels; }
+
+  /*
+    The kind of channel generated for channel:
+
+    - one sender to a different reciever at every index, as in a foreach
+      broadcast, gets a MulticastChannel
+    - many senders to one reciever get a combining MpscChannel
+    - any other channel with one sender and one reciever per index gets an
+      SpscChannel
+  */
+  ChannelKind getKind(const std::string &channel) const;
+  // Template of pchor/runtime for kind, empty for ChannelKind::None
+  static std::string_view getTemplate(ChannelKind kind);
+
+private:
+  std::vector<std::string> channels;
+  std::map<std::string, std::map<size_t, ChannelUse>> uses;
+
+  void collect(const ParticipantKey &participant,
+               const ProjectionList &projections, bool recursive);
+};
+
+// Participants as "A, B and C", for the channel reports
+std::string joinParticipants(const std::set<std::string> &participants);
+
+} // namespace PchorAST
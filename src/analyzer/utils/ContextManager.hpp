@@ -1,8 +1,11 @@
 #pragma once
 
+#include <charconv>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -71,23 +74,31 @@ struct Context {
 
 class CASTMapping {
 public:
-  CASTMapping() : map() {}
+  CASTMapping() : map(), channels() {}
 
-  CASTMapping(const CASTMapping &other) { this->map = other.map; }
+  CASTMapping(const CASTMapping &other) {
+    this->map = other.map;
+    this->channels = other.channels;
+  }
   CASTMapping &operator=(const CASTMapping &other) {
     if (this != &other) {
       this->map = other.map;
+      this->channels = other.channels;
     }
     return *this;
   }
   CASTMapping(CASTMapping &&other) noexcept {
     this->map = std::move(other.map);
+    this->channels = std::move(other.channels);
     other.map.clear();
+    other.channels.clear();
   }
   CASTMapping &operator=(CASTMapping &&other) noexcept {
     if (this != &other) {
       this->map = std::move(other.map);
+      this->channels = std::move(other.channels);
       other.map.clear();
+      other.channels.clear();
     }
     return *this;
   }
@@ -100,6 +111,18 @@ public:
     map.emplace(name, Context(stmt));
   }
 
+  // channels are also remembered by field, so their uses can be indexed
+  void addChannelMapping(const std::string &name,
+                         const clang::FieldDecl *field) {
+    if (map.emplace(name, Context(field)).second) {
+      channels.insert(field);
+    }
+  }
+
+  const std::unordered_set<const clang::FieldDecl *> &getChannels() const {
+    return channels;
+  }
+
   template <typename NodeType> NodeType getMapping(const std::string &name) {
     auto it = map.find(name);
     if (it != map.end()) {
@@ -120,6 +143,7 @@ public:
 
 private:
   std::unordered_map<std::string, Context> map;
+  std::unordered_set<const clang::FieldDecl *> channels;
 };
 
 struct ParticipantKey {
@@ -160,6 +184,58 @@ struct ParticipantKeyHash {
   }
 };
 
+/*
+  Participants whose projection is asked for. A participant is either asked
+  for as a whole, with every index, or for single indices. An empty demand
+  asks for every participant of the choreography.
+*/
+class ParticipantDemand {
+public:
+  ParticipantDemand() : names(), keys() {}
+
+  void addParticipant(const std::string &name) { names.insert(name); }
+  void addParticipant(const ParticipantKey &key) { keys.insert(key); }
+  // Adds "Name" or "Name[index]"
+  void parse(const std::string &spec) {
+    const size_t open = spec.find('[');
+    if (open == std::string::npos) {
+      addParticipant(spec);
+      return;
+    }
+    size_t index = 0;
+    const char *first = spec.data() + open + 1;
+    const char *last = spec.data() + spec.size() - 1;
+    auto [ptr, ec] = std::from_chars(first, last, index);
+    if (open == 0 || spec.back() != ']' || ec != std::errc{} || ptr != last) {
+      throw std::runtime_error(std::format(
+          "Participant {} is neither of the form Name nor Name[index]", spec));
+    }
+    addParticipant(ParticipantKey{spec.substr(0, open), index});
+  }
+
+  bool all() const { return names.empty() && keys.empty(); }
+  bool contains(const ParticipantKey &key) const {
+    return all() || names.contains(key.name) || keys.contains(key);
+  }
+  // Indices of name asked for, nullopt if all of them are
+  std::optional<std::vector<size_t>> getIndices(const std::string &name) const {
+    if (all() || names.contains(name)) {
+      return std::nullopt;
+    }
+    std::vector<size_t> indices{};
+    for (const ParticipantKey &key : keys) {
+      if (key.name == name) {
+        indices.push_back(key.index);
+      }
+    }
+    return indices;
+  }
+
+private:
+  std::unordered_set<std::string> names;
+  std::unordered_set<ParticipantKey, ParticipantKeyHash> keys;
+};
+
 class PchorProjection {
 public:
   PchorProjection() : projectionMap() {}
@@ -192,6 +268,36 @@ public:
   }
 
 
+  // Appends the projections of every participant in other to this
+  // projection, shared with other
+  void append(const PchorProjection &other) {
+    for (const auto &[key, projections] : other.projectionMap) {
+      append(key, projections);
+    }
+  }
+
+  // Appends projections to the projection of key, shared with projections
+  void append(const ParticipantKey &key, const ProjectionList &projections) {
+    if (!hasProjection(key)) {
+      addParticipant(key);
+    }
+    projectionMap.at(key).append(projections);
+  }
+
+  // Removes and returns the projection of key, empty if key has none
+  ProjectionList extractProjection(const ParticipantKey &key) {
+    auto node = projectionMap.extract(key);
+    if (node.empty()) {
+      return ProjectionList{};
+    }
+    return std::move(node.mapped());
+  }
+
+  const ProjectionList *getProjection(const ParticipantKey &key) const {
+    auto it = projectionMap.find(key);
+    return it != projectionMap.end() ? &it->second : nullptr;
+  }
+
   bool hasProjection(const ParticipantKey &key) const {
     return projectionMap.contains(key);
   }
@@ -0,0 +1,362 @@
+#include "CoroutineGenerator.hpp"
+#include "ChannelGenerator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace PchorAST {
+
+CoroutineGenerator::CoroutineGenerator(const PchorProjection &projection)
+    : projection(projection), bounds(projection), senders(), recievers(),
+      recieved(), fields(), channels() {
+  for (const auto &[participant, projections] : projection) {
+    collect({participant.name, participant.index}, projections);
+  }
+  sizeFields();
+}
+
+void CoroutineGenerator::collect(const Key &participant,
+                                 const ProjectionList &projections) {
+  for (const AbstractProjection &proj : projections) {
+    if (proj.getType() == ProjectionType::Rec) {
+      collect(participant, static_cast<const Prec &>(proj).getBody());
+      continue;
+    }
+    if (!proj.isComProjection()) {
+      continue;
+    }
+    const ChannelIndex channel{proj.getChannelName(), proj.getChannelIndex()};
+    channels.insert(channel.first);
+    if (proj.getType() == ProjectionType::Send ||
+        proj.getType() == ProjectionType::Select) {
+      senders[channel].insert(participant);
+    } else {
+      recievers[channel].insert(participant);
+      recieved[participant][channel.first].insert(channel.second);
+      fields[participant.first][channel.first].payloads.insert(
+          proj.getTypeName());
+    }
+    if (proj.getType() == ProjectionType::Select ||
+        proj.getType() == ProjectionType::Branch) {
+      const auto &choice = static_cast<const AbstractChoiceProjection &>(proj);
+      for (const auto &[label, branch] : choice.getBranches()) {
+        collect(participant, branch);
+      }
+    }
+  }
+}
+
+void CoroutineGenerator::sizeFields() {
+  // a field of a class holds what any one participant of it recieves over
+  // all indices of the channel
+  for (const auto &[participant, uses] : recieved) {
+    for (const auto &[channel, indices] : uses) {
+      Field &field = fields[participant.first][channel];
+      std::set<Key> from{};
+      size_t messages = 0;
+      bool bounded = true;
+      for (size_t index : indices) {
+        const auto &indexSenders = senders[{channel, index}];
+        from.insert(indexSenders.begin(), indexSenders.end());
+        const ChannelBound *bound = bounds.getBound(channel, index);
+        bounded = bounded && bound && bound->kind == BoundKind::Bounded;
+        messages += bound ? bound->messages : 0;
+      }
+      field.combining = field.combining || from.size() > 1;
+      size_t capacity =
+          std::bit_ceil(std::max<size_t>(messages, field.combining ? 2 : 1));
+      if (!bounded) {
+        capacity = std::max(capacity, ChannelGenerator::defaultCapacity);
+      }
+      field.capacity = std::max(field.capacity, capacity);
+    }
+  }
+}
+
+std::string CoroutineGenerator::generate() const {
+  std::map<std::string, std::vector<const ParticipantKey *>> classes{};
+  for (const auto &[participant, projections] : projection) {
+    classes[participant.name].push_back(&participant);
+  }
+
+  std::string header =
+      "// Generated by PChorAnalyzer from the projections of a choreography,\n"
+      "// as a starting point for its participants as coroutines. Include it\n"
+      "// after the payload and label types are declared, and fill in the\n"
+      "// payloads sent and the branches selected.\n"
+      "#pragma once\n\n"
+      "#include \"pchor/runtime/Coroutine.hpp\"\n\n";
+  for (const auto &[name, keys] : classes) {
+    header.append(std::format("class {};\n", name));
+  }
+  header.append("\n");
+
+  std::string definitions{};
+  for (auto &[name, keys] : classes) {
+    std::sort(keys.begin(), keys.end(),
+              [](const ParticipantKey *lhs, const ParticipantKey *rhs) {
+                return lhs->index < rhs->index;
+              });
+    // indices whose coroutines come out the same share one method
+    std::vector<std::pair<std::pair<std::string, std::string>,
+                          std::vector<const ParticipantKey *>>>
+        methods{};
+    for (const ParticipantKey *key : keys) {
+      auto coroutine = generateCoroutine(*projection.getProjection(*key));
+      auto method = std::find_if(
+          methods.begin(), methods.end(),
+          [&coroutine](const auto &method) { return method.first == coroutine; });
+      if (method == methods.end()) {
+        methods.emplace_back(std::move(coroutine),
+                             std::vector<const ParticipantKey *>{key});
+      } else {
+        method->second.push_back(key);
+      }
+    }
+
+    header.append(std::format("class {} {{\npublic:\n", name));
+    for (const auto &[coroutine, participants] : methods) {
+      const std::string method =
+          methods.size() == 1
+              ? std::string{"run"}
+              : std::format("run_{}", participants.front()->index);
+      const ParticipantKey &first = *participants.front();
+      header.append(std::format("  // {}: {}\n", first.toString(),
+                                projection.getProjection(first)->toString()));
+      if (participants.size() > 1) {
+        header.append(std::format("  // and {} more, up to {}\n",
+                                  participants.size() - 1,
+                                  participants.back()->toString()));
+      }
+      header.append(std::format("  PchorRuntime::Task {}({});\n", method,
+                                coroutine.first));
+      definitions.append(
+          std::format("inline PchorRuntime::Task {}::{}({}) {{\n{}}}\n\n",
+                      name, method, coroutine.first, coroutine.second));
+    }
+
+    if (auto classFields = fields.find(name); classFields != fields.end()) {
+      header.append("\n");
+      for (const auto &[channel, field] : classFields->second) {
+        if (field.payloads.size() != 1) {
+          throw std::runtime_error(std::format(
+              "Channel {} of {} carries {} payload types, which one channel "
+              "field cannot",
+              channel, name, field.payloads.size()));
+        }
+        header.append(std::format(
+            "  PchorRuntime::AsyncChannel<{}, {}{}> {};\n",
+            *field.payloads.begin(), field.capacity,
+            field.combining ? ", PchorRuntime::MpscChannel" : "", channel));
+      }
+    }
+    header.append("};\n\n");
+  }
+  header.append(definitions);
+  return header;
+}
+
+void CoroutineGenerator::write(const std::string &path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error(std::format(
+        "Could not open {} to write the coroutine skeletons to", path));
+  }
+  file << generate();
+}
+
+std::string CoroutineGenerator::peerOf(const AbstractComProjection &projection,
+                                       Scope &scope) const {
+  auto it = recievers.find(
+      {projection.getChannelName(), projection.getChannelIndex()});
+  if (it == recievers.end() || it->second.size() != 1) {
+    throw std::runtime_error(std::format(
+        "{} is not recieved by exactly one participant, so its send has no "
+        "peer",
+        projection.getChannelString()));
+  }
+  const Key &peer = *it->second.begin();
+  for (const auto &[key, parameter] : *scope.peers) {
+    if (key == peer) {
+      return parameter;
+    }
+  }
+  const std::string parameter = name(peer.first, scope);
+  scope.peers->emplace_back(peer, parameter);
+  return parameter;
+}
+
+std::string CoroutineGenerator::name(const std::string &type, Scope &scope) {
+  std::string base = type;
+  base.front() = static_cast<char>(
+      std::tolower(static_cast<unsigned char>(base.front())));
+  std::string name = base;
+  for (size_t n = 2; scope.names->contains(name); ++n) {
+    name = std::format("{}{}", base, n);
+  }
+  scope.names->insert(name);
+  return name;
+}
+
+std::pair<std::string, std::string>
+CoroutineGenerator::generateCoroutine(const ProjectionList &projections) const {
+  std::vector<std::pair<Key, std::string>> peers{};
+  std::set<std::string> names{channels};
+  std::set<std::string> continued{};
+  std::map<std::string, std::string> recieved{};
+  Scope scope{&peers, &names, {}, {}, &continued, &recieved};
+
+  std::string body = generateList(projections, scope, "", 1);
+  // payloads that are never sent on are left to be used
+  for (const auto &[variable, declaration] : recieved) {
+    if (body.find(std::format(".send({});", variable)) == std::string::npos) {
+      body.replace(body.find(declaration), 0, "[[maybe_unused]] ");
+    }
+  }
+  // a body without awaits would not be a coroutine
+  if (body.find("co_await") == std::string::npos) {
+    body.append("  co_return;\n");
+  }
+
+  std::string parameters{};
+  for (const auto &[peer, parameter] : peers) {
+    parameters.append(std::format("{}{} &{}", parameters.empty() ? "" : ", ",
+                                  peer.first, parameter));
+  }
+  return {std::move(parameters), std::move(body)};
+}
+
+std::string CoroutineGenerator::generateList(const ProjectionList &projections,
+                                             Scope scope,
+                                             const std::string &end,
+                                             size_t depth) const {
+  const std::string indent(depth * 2, ' ');
+  // nested blocks cannot fall off the end of the coroutine
+  const std::string nestedEnd = end.empty() ? "co_return;" : end;
+  std::string str{};
+  // choices and recursions end every path through them themselves
+  bool ended = false;
+
+  for (auto it = projections.begin(); it != projections.end(); ++it) {
+    const AbstractProjection &proj = *it;
+    auto following = it;
+    const bool last = ++following == projections.end();
+    ended = proj.getType() == ProjectionType::Select ||
+            proj.getType() == ProjectionType::Branch ||
+            proj.getType() == ProjectionType::Rec;
+    switch (proj.getType()) {
+    case ProjectionType::Send: {
+      const auto &com = static_cast<const AbstractComProjection &>(proj);
+      auto payload = scope.payloads.find(com.getTypeName());
+      str.append(std::format(
+          "{}co_await {}.{}.send({});\n", indent, peerOf(com, scope),
+          com.getChannelName(),
+          payload != scope.payloads.end()
+              ? payload->second
+              : std::format("{}{{}}", com.getTypeName())));
+      break;
+    }
+    case ProjectionType::Recieve: {
+      const std::string variable = name(proj.getTypeName(), scope);
+      const std::string declaration =
+          std::format("{} {} = co_await {}.recv();", proj.getTypeName(),
+                      variable, proj.getChannelName());
+      str.append(std::format("{}{}\n", indent, declaration));
+      scope.recieved->emplace(variable, declaration);
+      scope.payloads[proj.getTypeName()] = variable;
+      break;
+    }
+    case ProjectionType::Select: {
+      // the coroutine has to pick the label it sends
+      const auto &choice = static_cast<const AbstractChoiceProjection &>(proj);
+      const auto &branches = choice.getBranches();
+      const std::string peer = peerOf(choice, scope);
+      const std::string type = choice.getTypeName();
+      const std::string variable = name(type, scope);
+      str.append(std::format("{}{} {} = {}::{}; // choose the branch to take\n",
+                             indent, type, variable, type,
+                             branches.front().first));
+      for (size_t pos = 0; pos < branches.size(); ++pos) {
+        const auto &[label, branch] = branches[pos];
+        if (pos == 0) {
+          str.append(std::format("{}if ({} == {}::{}) {{\n", indent, variable,
+                                 type, label));
+        } else if (pos + 1 < branches.size()) {
+          str.append(std::format("{}}} else if ({} == {}::{}) {{\n", indent,
+                                 variable, type, label));
+        } else {
+          str.append(std::format("{}}} else {{\n", indent));
+        }
+        str.append(std::format("{}  co_await {}.{}.send({}::{});\n", indent,
+                               peer, choice.getChannelName(), type, label));
+        str.append(generateList(branch, scope, end, depth + 1));
+      }
+      str.append(std::format("{}}}\n", indent));
+      break;
+    }
+    case ProjectionType::Branch: {
+      const auto &choice = static_cast<const AbstractChoiceProjection &>(proj);
+      const std::string type = choice.getTypeName();
+      const std::string variable = name(type, scope);
+      str.append(std::format("{}const {} {} = co_await {}.recv();\n", indent,
+                             type, variable, choice.getChannelName()));
+      str.append(std::format("{}switch ({}) {{\n", indent, variable));
+      for (const auto &[label, branch] : choice.getBranches()) {
+        str.append(std::format("{}case {}::{}: {{\n", indent, type, label));
+        str.append(generateList(branch, scope, nestedEnd, depth + 1));
+        str.append(std::format("{}}}\n", indent));
+      }
+      str.append(std::format("{}}}\n", indent));
+      break;
+    }
+    case ProjectionType::Rec: {
+      const auto &rec = static_cast<const Prec &>(proj);
+      const std::string label = std::format("rec_{}", rec.getRecVar());
+      // leaving the loop falls through to what follows the recursion
+      const std::string exit =
+          last ? nestedEnd : std::format("goto {}_end;", label);
+      Scope body = scope;
+      body.loops.push_back(rec.getRecVar());
+      std::string loop =
+          generateList(rec.getBody(), std::move(body), exit, depth + 1);
+      if (scope.continued->contains(rec.getRecVar())) {
+        str.append(std::format("{}{}:\n", indent, label));
+      }
+      str.append(std::format("{}while (true) {{\n{}{}}}\n", indent, loop,
+                             indent));
+      if (!last) {
+        str.append(std::format("{}{}_end:;\n", indent, label));
+      }
+      break;
+    }
+    case ProjectionType::Continue: {
+      const auto &recVar = static_cast<const Pcontinue &>(proj).getRecVar();
+      if (std::find(scope.loops.begin(), scope.loops.end(), recVar) ==
+          scope.loops.end()) {
+        throw std::runtime_error(std::format(
+            "continue {} is outside of the recursion over {}", recVar,
+            recVar));
+      }
+      if (scope.loops.back() == recVar) {
+        str.append(std::format("{}continue;\n", indent));
+      } else {
+        // a nested loop jumps back to the start of the outer one
+        scope.continued->insert(recVar);
+        str.append(std::format("{}goto rec_{};\n", indent, recVar));
+      }
+      return str;
+    }
+    }
+  }
+
+  if (!ended && !end.empty()) {
+    str.append(std::format("{}{}\n", indent, end));
+  }
+  return str;
+}
+
+} // namespace PchorAST
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../../pchor/ast/PchorProjection.hpp"
+#include "ChannelBounds.hpp"
+#include "ContextManager.hpp"
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace PchorAST {
+
+/*
+  Generates a skeleton of every participant as a C++20 coroutine
+  (pchor/runtime/Coroutine.hpp) from the projections of a choreography, as a
+  starting point that validates against the choreography as generated.
+  Recieves become awaits on the channel fields of the participant, and sends
+  awaits on the fields of the peer, passed to the coroutine by reference:
+
+    inline PchorRuntime::Task Kernel::run(Consumer &consumer) {
+      Data data = co_await d.recv();
+      Key key = co_await k.recv();
+      co_await consumer.c.send(data);
+    }
+
+  A send passes on the latest payload of its type the coroutine has
+  recieved, or a default constructed one. Recursions become while loops,
+  branchings a switch over the recieved label, and selections an if-chain
+  over a label the coroutine has to choose. Indices of a participant whose
+  coroutines come out the same share one method.
+
+  Channel fields are AsyncChannels sized for the messages the
+  ChannelBoundAnalysis finds in flight, with a combining ring if a reciever
+  has several senders.
+*/
+class CoroutineGenerator {
+public:
+  explicit CoroutineGenerator(const PchorProjection &projection);
+
+  std::string generate() const;
+  // Writes the generated skeleton to path, throws if it cannot be written
+  void write(const std::string &path) const;
+
+private:
+  using Key = std::pair<std::string, size_t>;
+  using ChannelIndex = std::pair<std::string, size_t>;
+
+  // channel field of a participant class
+  struct Field {
+    std::set<std::string> payloads;
+    size_t capacity;
+    bool combining;
+  };
+  // names in scope while generating the body of a coroutine
+  struct Scope {
+    // peers sent to, in order of their first send, with their parameter
+    std::vector<std::pair<Key, std::string>> *peers;
+    // names taken within the coroutine
+    std::set<std::string> *names;
+    // latest recieved payload of every type
+    std::map<std::string, std::string> payloads;
+    // recursion variables of the enclosing loops, innermost last
+    std::vector<std::string> loops;
+    // recursions continued from a nested loop, which need a label
+    std::set<std::string> *continued;
+    // declarations of the recieved payloads, by variable
+    std::map<std::string, std::string> *recieved;
+  };
+
+  const PchorProjection &projection;
+  ChannelBoundAnalysis bounds;
+  std::map<ChannelIndex, std::set<Key>> senders;
+  std::map<ChannelIndex, std::set<Key>> recievers;
+  // indices of every channel a participant recieves over
+  std::map<Key, std::map<std::string, std::set<size_t>>> recieved;
+  // keyed by participant class, then channel
+  std::map<std::string, std::map<std::string, Field>> fields;
+  // names of the channel fields, which variables must not hide
+  std::set<std::string> channels;
+
+  void collect(const Key &participant, const ProjectionList &projections);
+  void sizeFields();
+  // Parameter of the peer recieving projection, added to the scope the first
+  // time it is sent to
+  std::string peerOf(const AbstractComProjection &projection,
+                     Scope &scope) const;
+  // Name for a variable of type, not yet taken in the scope
+  static std::string name(const std::string &type, Scope &scope);
+
+  // Statements of projections, ending every path that does not continue a
+  // recursion with end, or falling off if end is empty
+  std::string generateList(const ProjectionList &projections, Scope scope,
+                           const std::string &end, size_t depth) const;
+  // Parameters and body of the coroutine of a participant
+  std::pair<std::string, std::string>
+  generateCoroutine(const ProjectionList &projections) const;
+};
+
+} // namespace PchorAST
@@ -0,0 +1,189 @@
+#include "FalseSharing.hpp"
+#include "../../pchor/runtime/CacheLine.hpp"
+
+#include <clang/AST/RecordLayout.h>
+
+#include <algorithm>
+#include <map>
+#include <print>
+#include <tuple>
+#include <utility>
+
+namespace PchorAST {
+
+namespace {
+
+constexpr size_t lineSize = PchorRuntime::cacheLineSize;
+
+std::string describe(const LaidOutField &field) {
+  return std::format("{} (offset {}, {} byte{}{})",
+                     field.field->getNameAsString(), field.offset, field.size,
+                     field.size == 1 ? "" : "s",
+                     field.channel.empty()
+                         ? std::string{}
+                         : std::format(", channel {}", field.channel));
+}
+
+} // namespace
+
+FalseSharingAnalysis::FalseSharingAnalysis(clang::ASTContext &context,
+                                           CASTMapping &CASTmap,
+                                           const PchorProjection &projection,
+                                           const ChannelUseIndex &channels)
+    : context(context), reports() {
+  // the channel indices every participant recieves over, looked up from
+  // one pass over all projections
+  std::map<std::string, Recieved> recieved{};
+  for (const std::string &channel : channels.getChannels()) {
+    if (const auto *uses = channels.getUses(channel)) {
+      for (const auto &[index, use] : *uses) {
+        for (const std::string &reciever : use.recievers) {
+          recieved[reciever][channel].insert(index);
+        }
+      }
+    }
+  }
+  const Recieved none{};
+
+  // participants in a fixed order, so reports do not depend on hashing
+  std::vector<const ParticipantKey *> participants{};
+  for (const auto &[participant, projections] : projection) {
+    participants.push_back(&participant);
+  }
+  std::sort(participants.begin(), participants.end(),
+            [](const ParticipantKey *lhs, const ParticipantKey *rhs) {
+              return std::tie(lhs->name, lhs->index) <
+                     std::tie(rhs->name, rhs->index);
+            });
+
+  // the same pair of fields is reported once for all indices
+  std::map<std::pair<const clang::FieldDecl *, const clang::FieldDecl *>,
+           size_t>
+      reported{};
+  for (const ParticipantKey *participant : participants) {
+    const auto *record = llvm::dyn_cast_or_null<clang::RecordDecl>(
+        CASTmap.getMapping<const clang::Decl *>(participant->name));
+    if (!record || record->isInvalidDecl() || record->isDependentType() ||
+        !record->isCompleteDefinition()) {
+      continue;
+    }
+    const std::string name = participant->toString();
+    auto own = recieved.find(name);
+    const std::vector<LaidOutField> fields =
+        layOut(record, name, CASTmap, channels,
+               own != recieved.end() ? own->second : none);
+    const size_t alignment = static_cast<size_t>(
+        context.getASTRecordLayout(record).getAlignment().getQuantity());
+
+    for (size_t i = 0; i < fields.size(); ++i) {
+      for (size_t j = i + 1; j < fields.size(); ++j) {
+        const LaidOutField &first = fields[i];
+        const LaidOutField &second = fields[j];
+        // fields are sorted by offset, so no later field is any closer
+        if (second.offset >= first.offset + first.size + lineSize) {
+          break;
+        }
+        if ((first.channel.empty() && second.channel.empty()) ||
+            first.writers == second.writers ||
+            !mayShareLine(first, second, alignment)) {
+          continue;
+        }
+        auto [report, added] =
+            reported.try_emplace({first.field, second.field}, reports.size());
+        if (added) {
+          reports.push_back(FalseSharing{name, 0, first, second});
+        } else {
+          ++reports[report->second].others;
+        }
+      }
+    }
+  }
+}
+
+std::vector<LaidOutField> FalseSharingAnalysis::layOut(
+    const clang::RecordDecl *record, const std::string &participant,
+    CASTMapping &CASTmap, const ChannelUseIndex &channels,
+    const Recieved &recieved) const {
+  // channels recieved over, mapped to fields of the record
+  std::map<const clang::FieldDecl *, const Recieved::value_type *> mapped{};
+  for (const auto &entry : recieved) {
+    if (const auto *field = llvm::dyn_cast_or_null<clang::FieldDecl>(
+            CASTmap.getMapping<const clang::Decl *>(entry.first));
+        field && field->getParent() == record) {
+      mapped.emplace(field, &entry);
+    }
+  }
+
+  const clang::ASTRecordLayout &layout = context.getASTRecordLayout(record);
+  std::vector<LaidOutField> fields{};
+  for (const clang::FieldDecl *field : record->fields()) {
+    const size_t bits = layout.getFieldOffset(field->getFieldIndex());
+    size_t size = 0;
+    if (field->isBitField()) {
+      size = (bits % 8 + field->getBitWidthValue(context) + 7) / 8;
+    } else {
+      size = static_cast<size_t>(
+          context.getTypeSizeInChars(field->getType()).getQuantity());
+    }
+    // empty fields take up no line
+    if (size == 0 || field->isZeroSize(context)) {
+      continue;
+    }
+
+    LaidOutField laidOut{field, "", bits / 8, size, {}};
+    laidOut.writers.insert(participant);
+    if (auto channel = mapped.find(field); channel != mapped.end()) {
+      const auto &[name, indices] = *channel->second;
+      laidOut.channel = name;
+      const auto &uses = *channels.getUses(name);
+      for (size_t index : indices) {
+        const auto &senders = uses.at(index).senders;
+        laidOut.writers.insert(senders.begin(), senders.end());
+      }
+    }
+    fields.push_back(std::move(laidOut));
+  }
+  std::stable_sort(fields.begin(), fields.end(),
+                   [](const LaidOutField &lhs, const LaidOutField &rhs) {
+                     return lhs.offset < rhs.offset;
+                   });
+  return fields;
+}
+
+bool FalseSharingAnalysis::mayShareLine(const LaidOutField &first,
+                                        const LaidOutField &second,
+                                        size_t alignment) {
+  // the last byte of first and the first byte of second, where the record
+  // may start at any multiple of its alignment
+  const size_t last = first.offset + first.size - 1;
+  if (second.offset <= last) {
+    return true;
+  }
+  const size_t placement = std::min(std::max<size_t>(alignment, 1), lineSize);
+  return last % placement + (second.offset - last) < lineSize;
+}
+
+void FalseSharingAnalysis::printReports(std::FILE *out) const {
+  std::println(out, "\n\nFalse Sharing:\n-------------------");
+  if (reports.empty()) {
+    std::println(out, "No channel field shares a cache line with fields written by "
+                 "other participants");
+    return;
+  }
+  for (const FalseSharing &report : reports) {
+    std::println(out, "{}: {} and {} may share a {}-byte cache line",
+                 report.first.field->getParent()->getNameAsString(),
+                 describe(report.first), describe(report.second), lineSize);
+    std::println(out, "  in {}{}, {} is written by {}, {} by {}",
+                 report.participant,
+                 report.others == 0
+                     ? std::string{}
+                     : std::format(" and {} more", report.others),
+                 report.first.field->getNameAsString(),
+                 joinParticipants(report.first.writers),
+                 report.second.field->getNameAsString(),
+                 joinParticipants(report.second.writers));
+  }
+}
+
+} // namespace PchorAST
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../../pchor/ast/PchorProjection.hpp"
+#include "ChannelUseIndex.hpp"
+#include "ContextManager.hpp"
+
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Decl.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace PchorAST {
+
+// A field of a participant record, as laid out by the compiler
+struct LaidOutField {
+  const clang::FieldDecl *field;
+  // channel the field is mapped to, or "" for any other field
+  std::string channel;
+  size_t offset;
+  size_t size;
+  // participants writing the field, as "Name[index]"
+  std::set<std::string> writers;
+};
+
+// Two fields of a record that may share a cache line, with different writers
+struct FalseSharing {
+  // participant whose fields were found first, and how many other indices of
+  // it have the same fields sharing a line
+  std::string participant;
+  size_t others;
+  LaidOutField first;
+  LaidOutField second;
+};
+
+/*
+  Finds channel fields that may share a cache line with fields written by
+  other participants. A channel field is written by the participants sending
+  over it and by its reciever, which takes the messages out of it, while any
+  other field of a participant is taken to be written by the participant
+  alone. The writers of a field are those of the participant holding it, so
+  the fields of every index of a participant are compared separately.
+
+  The offsets and sizes of the fields come from the record layout of the
+  ASTContext. Where an object lands in memory is only known up to the
+  alignment of its record, so two fields are reported if some placement of
+  the record puts a byte of both on the same cache line. A record aligned to
+  a cache line, like the channels of pchor/runtime, places its fields
+  exactly.
+*/
+class FalseSharingAnalysis {
+public:
+  FalseSharingAnalysis(clang::ASTContext &context, CASTMapping &CASTmap,
+                       const PchorProjection &projection,
+                       const ChannelUseIndex &channels);
+
+  const std::vector<FalseSharing> &getReports() const { return reports; }
+  void printReports(std::FILE *out = stdout) const;
+
+private:
+  clang::ASTContext &context;
+  std::vector<FalseSharing> reports;
+
+  // Indices of every channel participant recieves over
+  using Recieved = std::map<std::string, std::set<size_t>>;
+
+  // Fields of the record of participant in order of their offsets, with the
+  // participants writing them
+  std::vector<LaidOutField>
+  layOut(const clang::RecordDecl *record, const std::string &participant,
+         CASTMapping &CASTmap, const ChannelUseIndex &channels,
+         const Recieved &recieved) const;
+  // True if some placement of a record aligned to alignment puts a byte of
+  // first and of second, which follows it, on one cache line
+  static bool mayShareLine(const LaidOutField &first,
+                           const LaidOutField &second, size_t alignment);
+};
+
+} // namespace PchorAST
@@ -0,0 +1,246 @@
+#include "MonitorGenerator.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+
+namespace PchorAST {
+
+namespace {
+// states and events are stored as MonitorState, with 0xFFFF reserved
+constexpr size_t maxTableSize = 0xFFFF;
+} // namespace
+
+MonitorGenerator::MonitorGenerator(const PchorProjection &projection)
+    : participants() {
+  std::map<std::string, std::vector<ParticipantActions>> indices{};
+  for (const auto &[participant, projections] : projection) {
+    indices[participant.name].push_back(
+        compile(participant.index, projections));
+  }
+  for (auto &[name, actions] : indices) {
+    std::sort(actions.begin(), actions.end(),
+              [](const ParticipantActions &lhs, const ParticipantActions &rhs) {
+                return lhs.index < rhs.index;
+              });
+    participants.emplace(name, compileParticipant(name, actions));
+  }
+}
+
+MonitorGenerator::ParticipantActions
+MonitorGenerator::compile(size_t index, const ProjectionList &projections) {
+  const LocalAutomaton automaton{projections};
+  if (automaton.size() >= maxTableSize) {
+    throw std::runtime_error(
+        std::format("Local type with {} states is too large for a monitor",
+                    automaton.size()));
+  }
+
+  ParticipantActions table{index, projections.toString(), {}, {}};
+  for (size_t state = 0; state < automaton.size(); ++state) {
+    std::vector<MonitorAction> actions{};
+    for (const auto &transition : automaton.getState(state).transitions) {
+      const auto *projection = transition.projection;
+      const std::string &channel = projection->getChannelName();
+      const size_t channelIndex = projection->getChannelIndex();
+      switch (transition.kind) {
+      case TransitionKind::Send:
+        actions.push_back(MonitorAction{"send", channel, channelIndex,
+                                        projection->getTypeName(),
+                                        transition.target});
+        break;
+      case TransitionKind::Recieve:
+        // the label of a branching is only known together with the branch
+        if (automaton.isChoice(transition.target)) {
+          for (const auto &label :
+               automaton.getState(transition.target).transitions) {
+            actions.push_back(MonitorAction{"branch", channel, channelIndex,
+                                            label.label, label.target});
+          }
+        } else {
+          actions.push_back(MonitorAction{"recv", channel, channelIndex,
+                                          projection->getTypeName(),
+                                          transition.target});
+        }
+        break;
+      case TransitionKind::Select:
+        actions.push_back(MonitorAction{"select", channel, channelIndex,
+                                        transition.label, transition.target});
+        break;
+      case TransitionKind::Label:
+        // taken together with the recieve into the choice state
+        break;
+      }
+    }
+    table.states.push_back(std::move(actions));
+    table.final.push_back(automaton.isFinal(state));
+  }
+  return table;
+}
+
+std::string MonitorGenerator::generate() const {
+  std::string header =
+      "// Generated by PChorAnalyzer from the projections of a choreography.\n"
+      "// Define PCHOR_MONITOR as 0 (or NDEBUG) to compile the monitors out.\n"
+      "#pragma once\n\n"
+      "#include \"pchor/runtime/Monitor.hpp\"\n\n"
+      "#include <cstddef>\n#include <cstdint>\n\n"
+      "namespace PchorMonitor {\n\n";
+  for (const auto &[name, participant] : participants) {
+    header.append(generateParticipant(name, participant));
+  }
+  header.append("} // namespace PchorMonitor\n");
+  return header;
+}
+
+void MonitorGenerator::write(const std::string &path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error(
+        std::format("Could not open {} to write monitors to", path));
+  }
+  file << generate();
+}
+
+MonitorGenerator::Participant MonitorGenerator::compileParticipant(
+    const std::string &name, const std::vector<ParticipantActions> &indices) {
+  // actions that need the channel index to be told apart within one index
+  using ActionKey = std::tuple<std::string, std::string, std::string>;
+  std::set<ActionKey> indexed{};
+  for (const ParticipantActions &table : indices) {
+    std::map<ActionKey, std::set<size_t>> channelIndices{};
+    for (const auto &actions : table.states) {
+      for (const MonitorAction &action : actions) {
+        ActionKey key{action.kind, action.channel, action.payload};
+        if (channelIndices[key].insert(action.index).second &&
+            channelIndices[key].size() > 1) {
+          indexed.insert(key);
+        }
+      }
+    }
+  }
+  auto eventName = [&indexed](const MonitorAction &action) {
+    if (indexed.contains(
+            ActionKey{action.kind, action.channel, action.payload})) {
+      return std::format("{}_{}_{}_{}", action.kind, action.channel,
+                         action.index, action.payload);
+    }
+    return std::format("{}_{}_{}", action.kind, action.channel,
+                       action.payload);
+  };
+
+  // events in order of appearance
+  Participant participant{};
+  std::map<std::string, size_t> eventIds{};
+  for (const ParticipantActions &table : indices) {
+    for (const auto &actions : table.states) {
+      for (const MonitorAction &action : actions) {
+        std::string event = eventName(action);
+        if (eventIds.emplace(event, participant.events.size()).second) {
+          participant.events.push_back(std::move(event));
+        }
+      }
+    }
+  }
+  const size_t eventCount = participant.events.size();
+  if (eventCount >= maxTableSize) {
+    throw std::runtime_error(std::format(
+        "Participant {} has {} events, too many for a monitor", name,
+        eventCount));
+  }
+
+  for (const ParticipantActions &table : indices) {
+    Table compiled{table.index, table.localType,
+                   std::vector<uint16_t>(table.states.size() * eventCount,
+                                         invalidState),
+                   table.final};
+    for (size_t state = 0; state < table.states.size(); ++state) {
+      for (const MonitorAction &action : table.states[state]) {
+        compiled.next[state * eventCount + eventIds.at(eventName(action))] =
+            static_cast<uint16_t>(action.target);
+      }
+    }
+    participant.tables.push_back(std::move(compiled));
+  }
+  return participant;
+}
+
+std::string
+MonitorGenerator::generateParticipant(const std::string &name,
+                                      const Participant &participant) {
+  const std::vector<std::string> &events = participant.events;
+  if (events.empty()) {
+    return std::format("// {}: no communications, not monitored\n\n", name);
+  }
+
+  std::string str = std::format("namespace {} {{\n\n", name);
+  str.append("enum Event : uint16_t {\n");
+  for (const std::string &event : events) {
+    str.append(std::format("  {},\n", event));
+  }
+  str.append("};\n\n");
+  str.append(std::format("inline constexpr std::size_t eventCount = {};\n",
+                         events.size()));
+  str.append("inline constexpr const char *eventNames[] = {\n");
+  for (const std::string &event : events) {
+    str.append(std::format("    \"{}\",\n", event));
+  }
+  str.append("};\n\n");
+
+  for (const Table &table : participant.tables) {
+    str.append(std::format("// {}[{}]: {}\n", name, table.index,
+                           table.localType));
+    str.append(std::format(
+        "inline constexpr PchorRuntime::MonitorState next{}[] = {{\n",
+        table.index));
+    for (size_t state = 0; state < table.final.size(); ++state) {
+      str.append("   ");
+      for (size_t event = 0; event < events.size(); ++event) {
+        const uint16_t target = table.next[state * events.size() + event];
+        str.append(" ")
+            .append(target == invalidState ? "0xFFFF"
+                                           : std::to_string(target))
+            .append(",");
+      }
+      str.append("\n");
+    }
+    str.append("};\n");
+    str.append(
+        std::format("inline constexpr bool final{}[] = {{", table.index));
+    for (size_t state = 0; state < table.final.size(); ++state) {
+      str.append(state == 0 ? "" : ", ");
+      str.append(table.final[state] ? "true" : "false");
+    }
+    str.append("};\n");
+    str.append(std::format(
+        "inline constexpr PchorRuntime::MonitorTable table{0}{{\n"
+        "    \"{1}[{0}]\", eventNames, eventCount, next{0}, final{0}}};\n\n",
+        table.index, name));
+  }
+
+  // indices without a projection have no table
+  const size_t first = participant.tables.front().index;
+  const size_t last = participant.tables.back().index;
+  str.append("inline constexpr const PchorRuntime::MonitorTable *tables[] = {\n");
+  auto it = participant.tables.begin();
+  for (size_t index = first; index <= last; ++index) {
+    if (it != participant.tables.end() && it->index == index) {
+      str.append(std::format("    &table{},\n", index));
+      ++it;
+    } else {
+      str.append("    nullptr,\n");
+    }
+  }
+  str.append("};\n");
+  str.append(std::format(
+      "constexpr const PchorRuntime::MonitorTable &table(std::size_t index) "
+      "{{\n  return *tables[index - {}];\n}}\n\n",
+      first));
+  str.append(std::format("}} // namespace {}\n\n", name));
+  return str;
+}
+
+} // namespace PchorAST
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../../pchor/ast/PchorAutomaton.hpp"
+#include "../../pchor/ast/PchorProjection.hpp"
+#include "ContextManager.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace PchorAST {
+
+/*
+  Generates a header with the transition table of every projected
+  participant, for the runtime conformance monitor (pchor/runtime/
+  Monitor.hpp). Tables are compiled from the local automaton of each
+  projection, with one event per send, recieve, selected label and recieved
+  label. A branching is one event per label, which takes the recieve of the
+  label and the choice of its branch in one step.
+
+  All indices of a participant share one event enumeration, so generic code
+  for Worker[i] can name its events without knowing i. An event is named
+  after its action, channel and payload (or label), like recv_c_Data, and
+  only carries the channel index if one index of the participant uses the
+  channel with more than one index:
+
+    PchorRuntime::Monitor monitor{PchorMonitor::Worker::table(i)};
+    monitor.step(PchorMonitor::Worker::recv_c_Data);
+*/
+class MonitorGenerator {
+public:
+  // Transition table of one index, laid out like PchorRuntime::MonitorTable
+  struct Table {
+    size_t index;
+    std::string localType;
+    // next[state * eventCount + event], invalidState if not allowed
+    std::vector<uint16_t> next;
+    std::vector<bool> final;
+  };
+  struct Participant {
+    std::vector<std::string> events;
+    // ordered by index
+    std::vector<Table> tables;
+  };
+  static constexpr uint16_t invalidState = 0xFFFF;
+
+  explicit MonitorGenerator(const PchorProjection &projection);
+
+  std::string generate() const;
+  // Writes the generated header to path, throws if it cannot be written
+  void write(const std::string &path) const;
+
+  // Tables of every participant, numbering events as the generated header
+  const std::map<std::string, Participant> &getParticipants() const {
+    return participants;
+  }
+
+private:
+  // an event of a participant, and the state it leads to
+  struct MonitorAction {
+    std::string kind;
+    std::string channel;
+    size_t index;
+    std::string payload;
+    size_t target;
+  };
+  struct ParticipantActions {
+    size_t index;
+    std::string localType;
+    // actions allowed in every state of the automaton
+    std::vector<std::vector<MonitorAction>> states;
+    std::vector<bool> final;
+  };
+
+  std::map<std::string, Participant> participants;
+
+  static ParticipantActions compile(size_t index,
+                                    const ProjectionList &projections);
+  // Numbers the events of all indices of a participant, and fills the tables
+  static Participant
+  compileParticipant(const std::string &name,
+                     const std::vector<ParticipantActions> &indices);
+  static std::string generateParticipant(const std::string &name,
+                                         const Participant &participant);
+};
+
+} // namespace PchorAST
@@ -0,0 +1,73 @@
+#include "RecordFieldIndex.hpp"
+
+#include <clang/AST/DeclTemplate.h>
+
+namespace PchorAST {
+
+RecordFieldIndex::RecordFieldIndex(const clang::CXXRecordDecl *record)
+    : fields() {
+  for (const clang::FieldDecl *field : record->fields()) {
+    IndexedField indexed = describe(field);
+    if (!indexed.payload.empty()) {
+      fields[indexed.payload].push_back(std::move(indexed));
+    }
+  }
+}
+
+const std::vector<IndexedField> &
+RecordFieldIndex::getFields(const std::string &payload) const {
+  static const std::vector<IndexedField> none{};
+  auto it = fields.find(payload);
+  return it != fields.end() ? it->second : none;
+}
+
+const clang::FieldDecl *RecordFieldIndex::resolve(
+    const std::string &payload, const std::string &channel,
+    const std::unordered_set<const clang::FieldDecl *> &mapped,
+    const std::unordered_set<const clang::FieldDecl *> &annotated) const {
+  const auto &candidates = getFields(payload);
+  if (candidates.empty()) {
+    return nullptr;
+  }
+  for (const IndexedField &candidate : candidates) {
+    if (candidate.field->getName() == channel) {
+      return candidate.field;
+    }
+  }
+  for (const IndexedField &candidate : candidates) {
+    if (!mapped.contains(candidate.field) &&
+        !annotated.contains(candidate.field)) {
+      return candidate.field;
+    }
+  }
+  return candidates.front().field;
+}
+
+IndexedField RecordFieldIndex::describe(const clang::FieldDecl *field) {
+  IndexedField indexed{field, "", "", 0};
+  clang::QualType type = field->getType().getCanonicalType();
+  while (type->isPointerType()) {
+    ++indexed.pointerDepth;
+    type = type->getPointeeType().getCanonicalType();
+  }
+
+  // wrappers carry their payload as first template argument
+  if (const auto *specialization =
+          llvm::dyn_cast_or_null<clang::ClassTemplateSpecializationDecl>(
+              type->getAsCXXRecordDecl())) {
+    const auto &arguments = specialization->getTemplateArgs();
+    if (arguments.size() > 0 &&
+        arguments[0].getKind() == clang::TemplateArgument::Type) {
+      indexed.wrapper =
+          specialization->getSpecializedTemplate()->getNameAsString();
+      type = arguments[0].getAsType().getCanonicalType();
+    }
+  }
+
+  if (const clang::TagDecl *payloadDecl = type->getAsTagDecl()) {
+    indexed.payload = payloadDecl->getNameAsString();
+  }
+  return indexed;
+}
+
+} // namespace PchorAST
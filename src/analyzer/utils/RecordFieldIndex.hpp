@@ -0,0 +1,60 @@
+#pragma once
+
+#include <clang/AST/Decl.h>
+#include <clang/AST/DeclCXX.h>
+#include <clang/AST/Type.h>
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace PchorAST {
+
+// A field carrying a payload, possibly behind pointers and a template
+// wrapper, e.g. std::atomic<Message> *
+struct IndexedField {
+  const clang::FieldDecl *field;
+  std::string payload; // "" if the field carries no record or enum
+  std::string wrapper; // name of the template wrapping the payload, or ""
+  unsigned pointerDepth;
+};
+
+/*
+  The fields of a record, keyed by the payload type they carry. The record is
+  indexed in one pass over its fields, after which every channel of the
+  record is resolved by a lookup instead of by running matchers over the
+  fields again.
+
+  The wrapper and pointer depth of a field are recorded for the validators,
+  which tell multicast channels apart by their wrapper, but are not part of
+  the key: a choreography names only the payload of a channel, so a lookup
+  has nothing to match them against.
+
+  Several fields may carry the same payload. A channel then resolves to the
+  field named after it, otherwise to the first such field no other channel
+  has claimed yet. Once all of them are claimed, channels share the first
+  one.
+*/
+class RecordFieldIndex {
+public:
+  explicit RecordFieldIndex(const clang::CXXRecordDecl *record);
+
+  // fields carrying payload, in declaration order
+  const std::vector<IndexedField> &getFields(const std::string &payload) const;
+
+  // nullptr if no field carries payload. A field is claimed if it is in
+  // either of mapped and annotated
+  const clang::FieldDecl *
+  resolve(const std::string &payload, const std::string &channel,
+          const std::unordered_set<const clang::FieldDecl *> &mapped,
+          const std::unordered_set<const clang::FieldDecl *> &annotated) const;
+
+  // The payload of field, with the wrapper and pointers around it
+  static IndexedField describe(const clang::FieldDecl *field);
+
+private:
+  std::unordered_map<std::string, std::vector<IndexedField>> fields;
+};
+
+} // namespace PchorAST
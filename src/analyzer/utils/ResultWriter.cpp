@@ -0,0 +1,237 @@
+#include "ResultWriter.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <print>
+#include <stdexcept>
+#include <string_view>
+
+namespace PchorAST {
+
+namespace {
+
+constexpr std::string_view sarifBegin =
+    "{\"version\":\"2.1.0\",\"$schema\":\"https://json.schemastore.org/"
+    "sarif-2.1.0.json\",\"runs\":[\n";
+
+constexpr std::string_view runBegin =
+    "{\"tool\":{\"driver\":{\"name\":\"PChorAnalyzer\",\"rules\":[{\"id\":"
+    "\"pchor-conformance\"}]}},\"results\":[\n";
+
+// closes the runs array and the log
+constexpr std::string_view sarifEnd = "]}\n";
+
+} // namespace
+
+ResultLocation
+ResultLocation::fromRange(const clang::SourceManager &sourceManager,
+                          clang::SourceRange range) {
+  const clang::SourceLocation begin =
+      sourceManager.getFileLoc(range.getBegin());
+  const clang::SourceLocation end = sourceManager.getFileLoc(range.getEnd());
+  return ResultLocation{sourceManager.getFilename(begin).str(),
+                        sourceManager.getSpellingLineNumber(begin),
+                        sourceManager.getSpellingColumnNumber(begin),
+                        sourceManager.getSpellingLineNumber(end),
+                        sourceManager.getSpellingColumnNumber(end)};
+}
+
+ResultWriter::ResultWriter(const std::string &path)
+    : file(nullptr), format(ResultFormat::JsonLines), written(0), run() {
+  if (path.ends_with(".sarif")) {
+    format = ResultFormat::Sarif;
+  }
+  if (format == ResultFormat::Sarif) {
+    // the log is read and extended in place, so it must not be truncated
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    file = fd < 0 ? nullptr : ::fdopen(fd, "r+");
+    if (fd >= 0 && !file) {
+      ::close(fd);
+    }
+  } else {
+    file = std::fopen(path.c_str(), "a");
+  }
+  if (!file) {
+    throw std::runtime_error(std::format("Failed to open results file {}: {}",
+                                         path, strerror(errno)));
+  }
+  if (format == ResultFormat::Sarif) {
+    ::flock(::fileno(file), LOCK_SH);
+    const bool log = isLog();
+    ::flock(::fileno(file), LOCK_UN);
+    if (!log) {
+      std::fclose(file);
+      throw std::runtime_error(std::format(
+          "Results file {} is not a SARIF log written by PChorAnalyzer", path));
+    }
+  }
+}
+
+ResultWriter::~ResultWriter() {
+  if (format == ResultFormat::Sarif) {
+    appendRun();
+  }
+  std::fclose(file);
+}
+
+void ResultWriter::write(const ParticipantResult &result) {
+  std::string matches{};
+  for (const ResultLocation &location : result.matches) {
+    if (!matches.empty()) {
+      matches.append(",");
+    }
+    matches.append(format == ResultFormat::Sarif ? toSarif(location)
+                                                 : toJson(location));
+  }
+  std::string failed{};
+  for (const std::string &method : result.failed) {
+    if (!failed.empty()) {
+      failed.append(",");
+    }
+    failed.append(std::format("\"{}\"", escape(method)));
+  }
+
+  if (format == ResultFormat::JsonLines) {
+    appendLine(std::format(
+        "{{\"participant\":\"{}\",\"validated\":{},\"method\":\"{}\","
+        "\"location\":{},\"matches\":[{}],\"failed\":[{}],"
+        "\"elapsedMicroseconds\":{}}}\n",
+        escape(result.participant), result.validated, escape(result.method),
+        toJson(result.methodLocation), matches, failed,
+        result.elapsed.count()));
+  } else {
+    const std::string message =
+        result.validated
+            ? std::format("{} follows its projection in {}",
+                          result.participant, result.method)
+            : std::format("No method of {} follows its projection",
+                          result.participant);
+    run.append(std::format(
+        "{}{{\"ruleId\":\"pchor-conformance\",\"level\":\"{}\","
+        "\"message\":{{\"text\":\"{}\"}},\"locations\":[{}],"
+        "\"relatedLocations\":[{}],\"properties\":{{\"participant\":"
+        "\"{}\",\"failed\":[{}],\"elapsedMicroseconds\":{}}}}}",
+        written > 0 ? ",\n" : "", result.validated ? "note" : "error",
+        escape(message),
+        result.methodLocation.file.empty() ? ""
+                                           : toSarif(result.methodLocation),
+        matches, escape(result.participant), failed,
+        result.elapsed.count()));
+  }
+  ++written;
+}
+
+void ResultWriter::appendLine(const std::string &line) {
+  // the file is opened for appending, and the line is not buffered, so it
+  // lands whole at the end of the file, after any line written under the
+  // lock by another translation unit
+  const int fd = ::fileno(file);
+  ::flock(fd, LOCK_EX);
+  size_t done = 0;
+  while (done < line.size()) {
+    const ssize_t count =
+        ::write(fd, line.data() + done, line.size() - done);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      std::println(stderr, "Failed to write to results file: {}",
+                   strerror(errno));
+      break;
+    }
+    done += static_cast<size_t>(count);
+  }
+  ::flock(fd, LOCK_UN);
+}
+
+void ResultWriter::appendRun() {
+  ::flock(::fileno(file), LOCK_EX);
+  std::fseek(file, 0, SEEK_END);
+  const long size = std::ftell(file);
+  if (size == 0) {
+    std::print(file, "{}", sarifBegin);
+  } else if (isLog()) {
+    // the new run replaces the end of the log, which is written again
+    std::fseek(file, size - static_cast<long>(sarifEnd.size()), SEEK_SET);
+    std::print(file, ",\n");
+  } else {
+    std::println(stderr, "Results file is no longer a SARIF log, {} results "
+                         "were not written",
+                 written);
+    ::flock(::fileno(file), LOCK_UN);
+    return;
+  }
+  std::print(file, "{}{}\n]}}{}", runBegin, run, sarifEnd);
+  std::fflush(file);
+  ::flock(::fileno(file), LOCK_UN);
+}
+
+bool ResultWriter::isLog() {
+  std::fseek(file, 0, SEEK_END);
+  const long size = std::ftell(file);
+  if (size == 0) {
+    return true;
+  }
+  if (size < static_cast<long>(sarifEnd.size())) {
+    return false;
+  }
+  std::fseek(file, size - static_cast<long>(sarifEnd.size()), SEEK_SET);
+  std::string end(sarifEnd.size(), '\0');
+  return std::fread(end.data(), 1, end.size(), file) == end.size() &&
+         end == sarifEnd;
+}
+
+std::string ResultWriter::escape(const std::string &str) {
+  std::string escaped{};
+  escaped.reserve(str.size());
+  for (char c : str) {
+    switch (c) {
+    case '"':
+      escaped.append("\\\"");
+      break;
+    case '\\':
+      escaped.append("\\\\");
+      break;
+    case '\n':
+      escaped.append("\\n");
+      break;
+    case '\t':
+      escaped.append("\\t");
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        escaped.append(std::format("\\u{:04x}", static_cast<unsigned>(c)));
+      } else {
+        escaped.push_back(c);
+      }
+    }
+  }
+  return escaped;
+}
+
+std::string ResultWriter::toJson(const ResultLocation &location) {
+  if (location.file.empty()) {
+    return "null";
+  }
+  return std::format("{{\"file\":\"{}\",\"startLine\":{},\"startColumn\":{},"
+                     "\"endLine\":{},\"endColumn\":{}}}",
+                     escape(location.file), location.startLine,
+                     location.startColumn, location.endLine,
+                     location.endColumn);
+}
+
+std::string ResultWriter::toSarif(const ResultLocation &location) {
+  return std::format(
+      "{{\"physicalLocation\":{{\"artifactLocation\":{{\"uri\":\"{}\"}},"
+      "\"region\":{{\"startLine\":{},\"startColumn\":{},\"endLine\":{},"
+      "\"endColumn\":{}}}}}}}",
+      escape(location.file), location.startLine, location.startColumn,
+      location.endLine, location.endColumn);
+}
+
+} // namespace PchorAST
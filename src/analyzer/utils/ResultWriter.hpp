@@ -0,0 +1,84 @@
+#pragma once
+
+#include <clang/Basic/SourceLocation.h>
+#include <clang/Basic/SourceManager.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace PchorAST {
+
+enum class ResultFormat : uint8_t {
+  JsonLines, // one JSON object per line
+  Sarif      // a SARIF 2.1.0 log with one result per participant
+};
+
+struct ResultLocation {
+  std::string file;
+  unsigned startLine;
+  unsigned startColumn;
+  unsigned endLine;
+  unsigned endColumn;
+
+  static ResultLocation fromRange(const clang::SourceManager &sourceManager,
+                                  clang::SourceRange range);
+};
+
+// Outcome of validating one participant
+struct ParticipantResult {
+  std::string participant;
+  bool validated;
+  // the method that validated, or empty
+  std::string method;
+  ResultLocation methodLocation;
+  // statements of the method and its callees taking transitions
+  std::vector<ResultLocation> matches;
+  // methods tried without success
+  std::vector<std::string> failed;
+  std::chrono::microseconds elapsed;
+};
+
+/*
+  Writes the result of every participant as soon as it is validated, so a
+  build farm can ingest results while the analysis runs. Every JSON line is
+  appended with one write under a lock on the file, which lets many
+  translation units share a file without their lines interleaving.
+  A SARIF log is a single document, so its results are held until the
+  writer is destroyed and then added to the log as one run per translation
+  unit. The file is locked while the run is added, so translation units
+  compiled in parallel can share a log as well.
+*/
+class ResultWriter {
+public:
+  // The format follows the extension of path: .sarif, or JSON lines
+  explicit ResultWriter(const std::string &path);
+  ~ResultWriter();
+
+  ResultWriter(const ResultWriter &other) = delete;
+  ResultWriter &operator=(const ResultWriter &other) = delete;
+
+  void write(const ParticipantResult &result);
+
+private:
+  std::FILE *file;
+  ResultFormat format;
+  size_t written;
+  // SARIF results not yet added to the log
+  std::string run;
+
+  // Appends line to the JSON lines in file
+  void appendLine(const std::string &line);
+  // Adds run to the log, or starts the log if the file is empty
+  void appendRun();
+  // The log in file ends like a log written by appendRun
+  bool isLog();
+
+  static std::string escape(const std::string &str);
+  static std::string toJson(const ResultLocation &location);
+  static std::string toSarif(const ResultLocation &location);
+};
+
+} // namespace PchorAST
@@ -0,0 +1,201 @@
+#include "SessionGenerator.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace PchorAST {
+
+SessionGenerator::SessionGenerator(const PchorProjection &projection)
+    : projection(projection), recievers(), channels() {
+  for (const auto &[participant, projections] : projection) {
+    collect(participant, projections);
+  }
+}
+
+void SessionGenerator::collect(const ParticipantKey &participant,
+                               const ProjectionList &projections) {
+  for (const AbstractProjection &proj : projections) {
+    if (proj.getType() == ProjectionType::Rec) {
+      collect(participant, static_cast<const Prec &>(proj).getBody());
+      continue;
+    }
+    if (!proj.isComProjection()) {
+      continue;
+    }
+    channels.insert(proj.getChannelName());
+    if (proj.getType() == ProjectionType::Recieve ||
+        proj.getType() == ProjectionType::Branch) {
+      recievers[{proj.getChannelName(), proj.getChannelIndex()}].insert(
+          participant.name);
+    }
+    if (proj.getType() == ProjectionType::Select ||
+        proj.getType() == ProjectionType::Branch) {
+      const auto &choice = static_cast<const AbstractChoiceProjection &>(proj);
+      for (const auto &[label, branch] : choice.getBranches()) {
+        collect(participant, branch);
+      }
+    }
+  }
+}
+
+std::string
+SessionGenerator::peerOf(const AbstractComProjection &projection) const {
+  auto it = recievers.find(
+      {projection.getChannelName(), projection.getChannelIndex()});
+  if (it == recievers.end() || it->second.size() != 1) {
+    return "PchorRuntime::AnyPeer";
+  }
+  return std::format("::{}", *it->second.begin());
+}
+
+std::string SessionGenerator::generate() const {
+  std::set<std::string> participants{};
+  std::vector<const ParticipantKey *> keys{};
+  for (const auto &[participant, projections] : projection) {
+    participants.insert(participant.name);
+    keys.push_back(&participant);
+  }
+  std::sort(keys.begin(), keys.end(),
+            [](const ParticipantKey *lhs, const ParticipantKey *rhs) {
+              return std::tie(lhs->name, lhs->index) <
+                     std::tie(rhs->name, rhs->index);
+            });
+
+  std::string header =
+      "// Generated by PChorAnalyzer from the projections of a choreography.\n"
+      "// Include it after the payload and label types are declared.\n"
+      "#pragma once\n\n"
+      "#include \"pchor/runtime/Session.hpp\"\n\n";
+  for (const std::string &participant : participants) {
+    header.append(std::format("class {};\n", participant));
+  }
+  header.append("\nnamespace PchorSession {\n\n");
+
+  // a channel is the field named after it, of the participant recieving
+  header.append("namespace Channels {\n");
+  for (const std::string &channel : channels) {
+    header.append(std::format(
+        "struct {0} {{\n"
+        "  template <typename Participant> static auto &of(Participant &p) {{\n"
+        "    return p.{0};\n"
+        "  }}\n"
+        "}};\n",
+        channel));
+  }
+  header.append("} // namespace Channels\n\n");
+
+  for (const ParticipantKey *participant : keys) {
+    header.append(generateParticipant(
+        *participant, *projection.getProjection(*participant)));
+  }
+  header.append("} // namespace PchorSession\n");
+  return header;
+}
+
+void SessionGenerator::write(const std::string &path) const {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error(
+        std::format("Could not open {} to write the session API to", path));
+  }
+  file << generate();
+}
+
+std::string
+SessionGenerator::generateParticipant(const ParticipantKey &participant,
+                                      const ProjectionList &projections) const {
+  const LocalAutomaton automaton{projections};
+  const std::string self = std::format("::{}", participant.name);
+  // choice states are entered through the Branch recieving their label
+  std::vector<size_t> states{};
+  for (size_t state = 0; state < automaton.size(); ++state) {
+    if (!automaton.isChoice(state)) {
+      states.push_back(state);
+    }
+  }
+
+  std::string str = std::format("namespace {}_{} {{\n// {}\n",
+                                participant.name, participant.index,
+                                projections.toString());
+  for (size_t state : states) {
+    str.append(std::format("struct s{};\n", state));
+  }
+
+  auto cases = [](const std::string &labels,
+                  const std::vector<AutomatonTransition> &transitions) {
+    std::string str{};
+    for (const auto &transition : transitions) {
+      str.append(std::format(",\n    PchorRuntime::Case<{}::{}, s{}>", labels,
+                             transition.label, transition.target));
+    }
+    return str;
+  };
+
+  for (size_t state : states) {
+    const auto &transitions = automaton.getState(state).transitions;
+    if (transitions.empty()) {
+      str.append(std::format(
+          "struct s{} : PchorRuntime::End<{}> {{\n  using End::End;\n}};\n",
+          state, self));
+      continue;
+    }
+    const AutomatonTransition &first = transitions.front();
+    const AbstractComProjection &com = *first.projection;
+    if (transitions.size() > 1 && first.kind != TransitionKind::Select) {
+      throw std::runtime_error(std::format(
+          "State {} of {} has more than one communication, which the session "
+          "API cannot express",
+          state, participant.toString()));
+    }
+    const std::string channel =
+        std::format("Channels::{}", com.getChannelName());
+
+    std::string base{};
+    std::string name{};
+    switch (first.kind) {
+    case TransitionKind::Send:
+      name = "Send";
+      base = std::format("{}, {}, {}, {}, s{}", self, peerOf(com), channel,
+                         com.getTypeName(), first.target);
+      break;
+    case TransitionKind::Recieve:
+      if (automaton.isChoice(first.target)) {
+        name = "Branch";
+        base = std::format(
+            "{}, {}{}", self, channel,
+            cases(com.getTypeName(),
+                  automaton.getState(first.target).transitions));
+      } else {
+        name = "Recv";
+        base = std::format("{}, {}, {}, s{}", self, channel,
+                           com.getTypeName(), first.target);
+      }
+      break;
+    case TransitionKind::Select:
+      name = "Select";
+      base = std::format("{}, {}, {}{}", self, peerOf(com), channel,
+                         cases(com.getTypeName(), transitions));
+      break;
+    case TransitionKind::Label:
+      throw std::runtime_error(std::format(
+          "State {} of {} continues a label outside of a choice", state,
+          participant.toString()));
+    }
+    str.append(std::format("struct s{0} : PchorRuntime::{1}<{2}> {{\n"
+                           "  using {1}::{1};\n}};\n",
+                           state, name, base));
+  }
+  str.append(std::format("\ninline s0 start({} &self) {{\n"
+                         "  return PchorRuntime::startSession<s0>(self);\n"
+                         "}}\n",
+                         self));
+  str.append(std::format("}} // namespace {}_{}\n\n", participant.name,
+                         participant.index));
+  return str;
+}
+
+} // namespace PchorAST
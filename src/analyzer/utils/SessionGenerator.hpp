@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../../pchor/ast/PchorAutomaton.hpp"
+#include "../../pchor/ast/PchorProjection.hpp"
+#include "ContextManager.hpp"
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace PchorAST {
+
+/*
+  Generates a typestate session API (pchor/runtime/Session.hpp) from the
+  projections of a choreography. Every state of the local automaton of a
+  participant becomes a struct of its own, deriving from the Send, Recv,
+  Select or Branch state of the runtime with the struct of the following
+  state, so communicating out of the order of the local type does not
+  compile:
+
+    namespace Kernel_1 {
+    struct s0 : PchorRuntime::Recv<::Kernel, Channels::d, Data, s1> {...};
+    ...
+    inline s0 start(::Kernel &self);
+    }
+
+  States refer to the following state by name instead of nesting it as a
+  template argument, so the instantiation depth and the length of the type
+  names stay constant however long the local type is, as for the unrolled
+  body of a foreach, and recursions are plain cycles between the structs.
+  Participants are the classes named after them, and channels the fields
+  named after the channel, as in the CAST mapping. The peer of a send is the
+  class of the participant recieving it, unless several participants recieve
+  over the same channel index.
+*/
+class SessionGenerator {
+public:
+  explicit SessionGenerator(const PchorProjection &projection);
+
+  std::string generate() const;
+  // Writes the generated header to path, throws if it cannot be written
+  void write(const std::string &path) const;
+
+private:
+  const PchorProjection &projection;
+  // classes of the participants recieving over every channel index
+  std::map<std::pair<std::string, size_t>, std::set<std::string>> recievers;
+  std::set<std::string> channels;
+
+  void collect(const ParticipantKey &participant,
+               const ProjectionList &projections);
+  std::string peerOf(const AbstractComProjection &projection) const;
+  std::string generateParticipant(const ParticipantKey &participant,
+                                  const ProjectionList &projections) const;
+};
+
+} // namespace PchorAST
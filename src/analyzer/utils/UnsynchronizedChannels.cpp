@@ -0,0 +1,165 @@
+#include "UnsynchronizedChannels.hpp"
+
+#include <clang/AST/Attr.h>
+#include <clang/AST/DeclCXX.h>
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <print>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace PchorAST {
+
+namespace {
+
+constexpr std::string_view concurrentAnnotation = "pchor:concurrent";
+
+// namespaces of concurrent queues
+constexpr std::array<std::string_view, 3> concurrentNamespaces = {
+    "PchorRuntime::", "boost::lockfree::", "moodycamel::"};
+
+constexpr std::array<std::string_view, 3> atomics = {"atomic", "atomic_flag",
+                                                     "atomic_ref"};
+
+constexpr std::array<std::string_view, 6> mutexes = {
+    "mutex",        "recursive_mutex",       "timed_mutex",
+    "shared_mutex", "recursive_timed_mutex", "shared_timed_mutex"};
+
+bool isAnnotated(const clang::Decl *decl) {
+  for (const auto *attr : decl->specific_attrs<clang::AnnotateAttr>()) {
+    if (attr->getAnnotation() == concurrentAnnotation) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Class of the field type, behind pointers, references and arrays
+const clang::CXXRecordDecl *recordOf(const clang::FieldDecl *field) {
+  clang::QualType type = field->getType().getCanonicalType();
+  while (!type->getPointeeType().isNull()) {
+    type = type->getPointeeType().getCanonicalType();
+  }
+  return type->getBaseElementTypeUnsafe()->getAsCXXRecordDecl();
+}
+
+bool isStd(const clang::CXXRecordDecl *record,
+           std::span<const std::string_view> names) {
+  if (!record->isInStdNamespace()) {
+    return false;
+  }
+  const std::string name = record->getNameAsString();
+  return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+} // namespace
+
+UnsynchronizedChannelAnalysis::UnsynchronizedChannelAnalysis(
+    CASTMapping &CASTmap, const ChannelUseIndex &channels)
+    : reports() {
+  for (const std::string &channel : channels.getChannels()) {
+    const auto *uses = channels.getUses(channel);
+    const auto *field = llvm::dyn_cast_or_null<clang::FieldDecl>(
+        CASTmap.getMapping<const clang::Decl *>(channel));
+    if (!uses || !field || isConcurrent(field)) {
+      continue;
+    }
+
+    UnsynchronizedChannel report{channel, field, {}, {}, nullptr, ""};
+    std::set<std::string> payloads{};
+    for (const auto &[index, use] : *uses) {
+      report.senders.insert(use.senders.begin(), use.senders.end());
+      report.recievers.insert(use.recievers.begin(), use.recievers.end());
+      payloads.insert(use.payloads.begin(), use.payloads.end());
+    }
+    // a participant sending to itself accesses the field from its own thread
+    std::set<std::string> participants = report.senders;
+    participants.insert(report.recievers.begin(), report.recievers.end());
+    if (participants.size() < 2) {
+      continue;
+    }
+    report.mutex = findMutex(field->getParent());
+    const ChannelKind kind = channels.getKind(channel);
+    if (kind != ChannelKind::None) {
+      report.replacement =
+          std::format("PchorRuntime::{}<{}>", ChannelUseIndex::getTemplate(kind),
+                      *payloads.begin());
+    }
+    reports.push_back(std::move(report));
+  }
+}
+
+bool UnsynchronizedChannelAnalysis::isConcurrent(
+    const clang::FieldDecl *field) {
+  if (isAnnotated(field)) {
+    return true;
+  }
+  const clang::CXXRecordDecl *record = recordOf(field);
+  if (!record) {
+    return false;
+  }
+  if (isAnnotated(record) || isStd(record, atomics)) {
+    return true;
+  }
+  // specializations carry the annotations of their template
+  if (const auto *special =
+          llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(record);
+      special && isAnnotated(special->getSpecializedTemplate()
+                                 ->getTemplatedDecl())) {
+    return true;
+  }
+  const std::string name = record->getQualifiedNameAsString();
+  for (std::string_view prefix : concurrentNamespaces) {
+    if (name.starts_with(prefix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const clang::FieldDecl *
+UnsynchronizedChannelAnalysis::findMutex(const clang::RecordDecl *record) {
+  for (const clang::FieldDecl *field : record->fields()) {
+    if (const auto *type = recordOf(field); type && isStd(type, mutexes)) {
+      return field;
+    }
+  }
+  return nullptr;
+}
+
+void UnsynchronizedChannelAnalysis::printReports(std::FILE *out) const {
+  std::println(out, "\n\nUnsynchronized Channels:\n-------------------");
+  if (reports.empty()) {
+    std::println(out, "Every channel shared between participants has a concurrent "
+                 "type");
+    return;
+  }
+  for (const UnsynchronizedChannel &report : reports) {
+    std::println(out, "{}::{} (channel {}) of type {} is not a concurrent queue or "
+                 "atomic,",
+                 report.field->getParent()->getNameAsString(),
+                 report.field->getNameAsString(), report.channel,
+                 report.field->getType().getAsString());
+    std::println(out, "  but is sent over by {} and recieved from by {}",
+                 joinParticipants(report.senders),
+                 joinParticipants(report.recievers));
+    if (report.mutex) {
+      std::println(out, "  {} may guard it, but serializes every access to the "
+                   "channel",
+                   report.mutex->getNameAsString());
+    }
+    if (report.replacement.empty()) {
+      std::println(out, "  --channels generates no lock-free channel for it");
+      continue;
+    }
+    std::println(out, "  --channels generates a {} for it, declared as",
+                 report.replacement);
+    std::println(out, "    PchorChannels::{} {};", report.channel,
+                 report.field->getNameAsString());
+  }
+}
+
+} // namespace PchorAST
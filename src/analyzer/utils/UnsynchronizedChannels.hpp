@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ChannelUseIndex.hpp"
+#include "ContextManager.hpp"
+
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Decl.h>
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace PchorAST {
+
+// Channel field accessed by several participants without being a concurrent
+// type
+struct UnsynchronizedChannel {
+  std::string channel;
+  const clang::FieldDecl *field;
+  // participants sending over and recieving from the channel, as
+  // "Name[index]"
+  std::set<std::string> senders;
+  std::set<std::string> recievers;
+  // mutex of the record holding the field, which may be locked around the
+  // accesses, or nullptr
+  const clang::FieldDecl *mutex;
+  // lock-free channel --channels generates for it, such as
+  // PchorRuntime::SpscChannel<Data>, or empty if it generates none
+  std::string replacement;
+};
+
+/*
+  Finds channel fields sent over and recieved from by different participants
+  whose type is not safe to share between their threads. The choreography
+  tells which participants send and recieve over a channel, and the CAST
+  mapping which field implements it. A field is taken to be synchronized if
+  its type, or the type it points to, is
+
+  - an std::atomic, std::atomic_flag or std::atomic_ref
+  - a channel of pchor/runtime, including the types --channels generates
+  - a queue of boost::lockfree or moodycamel
+  - a class or field annotated as [[clang::annotate("pchor:concurrent")]]
+
+  Any other field, such as a plain std::queue, is reported together with the
+  kind of lock-free channel that would replace it. The channels are not
+  sized here, as that explores every run of the protocol. A participant holding a mutex
+  likely locks it around the accesses, which is safe but serializes its
+  senders and reciever, so such fields are reported as well.
+*/
+class UnsynchronizedChannelAnalysis {
+public:
+  UnsynchronizedChannelAnalysis(CASTMapping &CASTmap,
+                                const ChannelUseIndex &channels);
+
+  const std::vector<UnsynchronizedChannel> &getReports() const {
+    return reports;
+  }
+  void printReports(std::FILE *out = stdout) const;
+
+private:
+  std::vector<UnsynchronizedChannel> reports;
+
+  static bool isConcurrent(const clang::FieldDecl *field);
+  // First field of record that is a mutex, or nullptr
+  static const clang::FieldDecl *findMutex(const clang::RecordDecl *record);
+};
+
+} // namespace PchorAST
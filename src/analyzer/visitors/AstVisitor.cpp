@@ -1,23 +1,47 @@
 #include "AstVisitor.hpp"
 
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace PchorAST {
 
 // Visit Declaration Nodes
 
 void CAST_PchorASTVisitor::visit(const ParticipantASTNode &node) {
-  // Simulate finding a declaration in the C++ AST
-  auto *decl = AnalyzerUtils::findDecl(clangContext, node.getName());
+  // an annotated class is taken as is, others are searched for by name
+  const clang::Decl *decl = annotations.findParticipant(node.getName());
   if (decl == nullptr) {
-    mappingSuccess = false;
-    throw std::runtime_error(
-        std::format("Declaration for {} not found\n", node.getName()));
+    decl = AnalyzerUtils::findDecl(clangContext, node.getName());
+  }
+  // a translation unit may define only some of the participants
+  if (decl == nullptr) {
+    missingParticipants.push_back(node.getName());
+    return;
   }
   ctx->addMapping(node.getName(), decl);
+  mappedParticipants.push_back(node.getName());
 }
 
 void CAST_PchorASTVisitor::visit([[maybe_unused]] const ChannelASTNode &node) {}
-void CAST_PchorASTVisitor::visit([[maybe_unused]] const LabelASTNode &node) {
-  std::println("Not Implemented Yet");
+void CAST_PchorASTVisitor::visit(const LabelASTNode &node) {
+  // labels map to an enum of the same name containing every label
+  const auto *decl = AnalyzerUtils::findEnumDecl(clangContext, node.getName());
+  if (decl == nullptr) {
+    mappingSuccess = false;
+    throw std::runtime_error(
+        std::format("Enum declaration for Label {} not found\n", node.getName()));
+  }
+  for (const std::string &label : node.getLabels()) {
+    if (!AnalyzerUtils::findEnumConstant(decl, label)) {
+      mappingSuccess = false;
+      throw std::runtime_error(std::format(
+          "Enum {} has no enumerator for label {}\n", node.getName(), label));
+    }
+  }
+  ctx->addMapping(node.getName(), decl);
 }
 void CAST_PchorASTVisitor::visit(const GlobalTypeASTNode &node) {
   node.getExprList()->accept(*this);
@@ -25,6 +49,11 @@ void CAST_PchorASTVisitor::visit(const GlobalTypeASTNode &node) {
 void CAST_PchorASTVisitor::visit([[maybe_unused]] const IndexASTNode &node) {}
 // Visit Expression Nodes
 void CAST_PchorASTVisitor::visit(const CommunicationExpr &expr) {
+  // nothing of it can be validated without one of its participants
+  if (!isMapped(expr.getSender()->getBaseParticipant()->getName()) &&
+      !isMapped(expr.getReciever()->getBaseParticipant()->getName())) {
+    return;
+  }
 
   auto *dataTypeDecl =
       AnalyzerUtils::findDecl(clangContext, expr.getDataType());
@@ -53,6 +82,22 @@ void CAST_PchorASTVisitor::visit(const CommunicationExpr &expr) {
   // channel
   expr.getChannel()->accept(*this);
 }
+void CAST_PchorASTVisitor::visit(const SelectionExpr &expr) {
+  // the label enum itself is mapped when visiting the Label declaration
+  this->currentDataType = expr.getLabel()->getName();
+  this->senderIdentifier = expr.getSender()->getBaseParticipant()->getName();
+  this->recieverIdentifier =
+      expr.getReciever()->getBaseParticipant()->getName();
+
+  if (isMapped(this->senderIdentifier) ||
+      isMapped(this->recieverIdentifier)) {
+    expr.getChannel()->accept(*this);
+  }
+
+  for (const auto &[label, body] : expr.getBranches()) {
+    body->accept(*this);
+  }
+}
 void CAST_PchorASTVisitor::visit(const ExprList &expr) {
   for (auto it = expr.begin(); it != expr.end(); ++it) {
     (*it)->accept(*this); // Read-only access
@@ -65,36 +110,60 @@ void CAST_PchorASTVisitor::visit(const ChannelExpr &expr) {
   auto reciever =
       ctx->getMapping<const clang::Decl *>(this->recieverIdentifier);
 
-  // Try Find Reciever Member
-  // Try Find Sender Member
+  const std::string &channel = expr.getBaseParticipant()->getName();
 
-  auto recieverUse = AnalyzerUtils::findMatchingMember(clangContext, reciever,
-                                                        this->currentDataType);
-  if (recieverUse) {
-    ctx->addMapping(expr.getBaseParticipant()->getName(), recieverUse);
-  } else {
-    auto senderUse = AnalyzerUtils::findMatchingMember(clangContext, sender,
-                                                        this->currentDataType);
-    if (senderUse) {
-      ctx->addMapping(expr.getBaseParticipant()->getName(), senderUse);
-    } else {
-      mappingSuccess = false;
+  // an annotated field is taken as is, in the reciever or else the sender
+  const clang::FieldDecl *channelUse =
+      annotations.findChannel(reciever, channel);
+  if (!channelUse) {
+    channelUse = annotations.findChannel(sender, channel);
+  }
+  // otherwise the channel is owned by the reciever if it can hold the data type
+  if (!channelUse && reciever) {
+    channelUse = resolveChannel(reciever, channel);
+  }
+  if (!channelUse && sender) {
+    channelUse = resolveChannel(sender, channel);
+  }
+  if (!channelUse) {
+    mappingSuccess = false;
+    throw std::runtime_error(
+        std::format("No matching member found for data type '{}' in sender "
+                    "'{}' or receiver '{}'",
+                    this->currentDataType, this->senderIdentifier,
+                    this->recieverIdentifier));
+  }
+  ctx->addChannelMapping(channel, channelUse);
+}
+bool CAST_PchorASTVisitor::isMapped(const std::string &participant) {
+  return ctx->getMapping<const clang::Decl *>(participant) != nullptr;
+}
+const clang::FieldDecl *
+CAST_PchorASTVisitor::resolveChannel(const clang::Decl *participant,
+                                     const std::string &channel) {
+  auto it = fieldIndices.find(participant);
+  if (it == fieldIndices.end()) {
+    const auto *record =
+        llvm::dyn_cast_or_null<clang::CXXRecordDecl>(participant);
+    if (!record) {
       throw std::runtime_error(
-          std::format("No matching member found for data type '{}' in sender "
-                      "'{}' or receiver '{}'",
-                      this->currentDataType, this->senderIdentifier,
-                      this->recieverIdentifier));
+          std::format("Recieved Declaration is not a class. Recieved {}",
+                      participant ? participant->getDeclKindName() : "null"));
     }
+    it = fieldIndices.emplace(participant, RecordFieldIndex{record}).first;
   }
+  // fields annotated for other channels are never guessed
+  return it->second.resolve(this->currentDataType, channel, ctx->getChannels(),
+                            annotations.getChannelFields());
 }
 void CAST_PchorASTVisitor::visit([[maybe_unused]] const IndexExpr &expr) {
   std::println("Not Implemented yet");
 }
-void CAST_PchorASTVisitor::visit([[maybe_unused]] const RecExpr &expr) {
-  std::println("Not Implemented yet");
+void CAST_PchorASTVisitor::visit(const RecExpr &expr) {
+  expr.getBody()->accept(*this);
 }
 void CAST_PchorASTVisitor::visit([[maybe_unused]] const ConExpr &expr) {
-  std::println("Not Implemented yet");
+  // continuations communicate nothing, so there is nothing to map
 }
 
 void CAST_PchorASTVisitor::visit([[maybe_unused]] const IterExpr &expr) {
@@ -126,7 +195,8 @@ void Proj_PchorASTVisitor::visit([[maybe_unused]] const LabelASTNode &node) {
                "type declaration");
 }
 void Proj_PchorASTVisitor::visit(const GlobalTypeASTNode &node) {
-  node.getExprList()->accept(*this);
+  // the projected type itself is never referenced, so it is not memoized
+  projectExprList(*node.getExprList());
 }
 
 void Proj_PchorASTVisitor::visit([[maybe_unused]] const IndexASTNode &node) {
@@ -158,21 +228,148 @@ void Proj_PchorASTVisitor::visit(const CommunicationExpr &expr) {
   // done
 }
 void Proj_PchorASTVisitor::visit(const ExprList &expr) {
+  if (!expr.isGlobalType()) {
+    projectExprList(expr);
+    return;
+  }
+
+  // referenced global type: project into a fresh fragment once per environment
+  const std::string key = getMemoKey(expr);
+  auto memo = projectionMemo.find(key);
+  if (memo == projectionMemo.end()) {
+    auto outer = this->ctx;
+    this->ctx = std::make_shared<PchorProjection>();
+    try {
+      projectExprList(expr);
+    } catch (...) {
+      this->ctx = outer;
+      throw;
+    }
+    memo = projectionMemo.emplace(key, this->ctx).first;
+    this->ctx = outer;
+  }
+  this->ctx->append(*memo->second);
+}
+
+void Proj_PchorASTVisitor::projectExprList(const ExprList &expr) {
   // visit each com expression
   for (auto it = expr.begin(); it != expr.end(); ++it) {
     (*it)->accept(*this); // Read-only access
   }
 }
-void Proj_PchorASTVisitor::visit(const ParticipantExpr &expr) {
+
+std::string Proj_PchorASTVisitor::getMemoKey(const ExprList &expr) {
+  auto identifiers = freeIdentifiers.find(&expr);
+  if (identifiers == freeIdentifiers.end()) {
+    std::unordered_set<std::string> bound{};
+    std::unordered_set<std::string> free{};
+    collectFreeIdentifiers(expr, bound, free);
+    std::vector<std::string> sorted(free.begin(), free.end());
+    // sorted so equal environments give equal keys
+    std::sort(sorted.begin(), sorted.end());
+    identifiers = freeIdentifiers.emplace(&expr, std::move(sorted)).first;
+  }
+
+  std::string key = std::format("{}@{}", expr.getGlobalTypeName(),
+                                static_cast<const void *>(&expr));
+  for (const std::string &identifier : identifiers->second) {
+    // an unbound identifier fails the projection itself
+    if (auto value = indexIdentifierMap.find(identifier);
+        value != indexIdentifierMap.end()) {
+      key += std::format(";{}={}", identifier, value->second);
+    }
+  }
+  return key;
+}
+void Proj_PchorASTVisitor::visit(const SelectionExpr &expr) {
+  const std::string labelName = expr.getLabel()->getName();
+  expr.getChannel()->accept(*this);
+  const std::string channelName = this->currentChannelName;
+  const size_t selectedChannelIndex = this->channelIndex;
+
+  const ParticipantKey senderKey = getParticipantKey(*expr.getSender());
+  const ParticipantKey recieverKey = getParticipantKey(*expr.getReciever());
+
+  // project every branch on its own, then split them up by participant
+  std::vector<std::pair<std::string, std::shared_ptr<PchorProjection>>>
+      branches{};
+  auto outer = this->ctx;
+  for (const auto &[label, body] : expr.getBranches()) {
+    this->ctx = std::make_shared<PchorProjection>();
+    try {
+      body->accept(*this);
+    } catch (...) {
+      this->ctx = outer;
+      throw;
+    }
+    branches.emplace_back(label, this->ctx);
+  }
+  this->ctx = outer;
+
+  auto select =
+      std::make_unique<Pselect>(channelName, labelName, selectedChannelIndex);
+  auto branch =
+      std::make_unique<Pbranch>(channelName, labelName, selectedChannelIndex);
+  for (auto &[label, projection] : branches) {
+    select->addBranch(label, projection->extractProjection(senderKey));
+    branch->addBranch(label, projection->extractProjection(recieverKey));
+  }
+  if (demand.contains(senderKey)) {
+    if (!this->ctx->hasProjection(senderKey)) {
+      this->ctx->addParticipant(senderKey);
+    }
+    this->ctx->addProjection(senderKey, std::move(select));
+  }
+  if (demand.contains(recieverKey)) {
+    if (!this->ctx->hasProjection(recieverKey)) {
+      this->ctx->addParticipant(recieverKey);
+    }
+    this->ctx->addProjection(recieverKey, std::move(branch));
+  }
+
+  /*
+    Participants that are not told which branch was taken must behave the
+    same in every branch, so their projections can simply be merged
+  */
+  for (const auto &[label, projection] : branches) {
+    for (const auto &[key, projections] : *projection) {
+      std::string behaviour = projections.toString();
+      for (const auto &[otherLabel, otherProjection] : branches) {
+        const ProjectionList *other = otherProjection->getProjection(key);
+        if ((other ? other->toString() : "") != behaviour) {
+          mappingSuccess = false;
+          throw std::runtime_error(std::format(
+              "Participant {} behaves differently in branches {} and {} of "
+              "selection {}, but does not take part in the selection",
+              key.toString(), label, otherLabel, labelName));
+        }
+      }
+    }
+  }
+  if (!branches.empty()) {
+    for (const auto &[key, projections] : *branches.front().second) {
+      this->ctx->append(key, projections);
+    }
+  }
+}
+
+ParticipantKey
+Proj_PchorASTVisitor::getParticipantKey(const ParticipantExpr &expr) {
   auto indexExpr = expr.getIndex();
   auto baseIndex = expr.getBaseParticipant()->getIndex();
   size_t literal = indexExpr->getLiteral(this->indexIdentifierMap);
 
-
   if(literal < baseIndex->getLower() || literal > baseIndex->getUpper()){
     throw std::runtime_error(std::format("Index expression {} evaluated to {}, which is not within the range of [{}, {}].", indexExpr->toString(), literal, baseIndex->getLower(), baseIndex->getUpper()));
   }
-  ParticipantKey key{expr.getBaseParticipant()->getName(), literal};
+  return ParticipantKey{expr.getBaseParticipant()->getName(), literal};
+}
+
+void Proj_PchorASTVisitor::visit(const ParticipantExpr &expr) {
+  ParticipantKey key = getParticipantKey(expr);
+  if (!demand.contains(key)) {
+    return;
+  }
 
   if (!this->ctx->hasProjection(key)) {
     this->ctx->addParticipant(key);
@@ -197,13 +394,62 @@ void Proj_PchorASTVisitor::visit(const ChannelExpr &expr) {
 void Proj_PchorASTVisitor::visit(const IndexExpr &expr) {
   this->channelIndex = expr.getLiteral(this->indexIdentifierMap);
 }
-void Proj_PchorASTVisitor::visit([[maybe_unused]] const RecExpr &expr) {
-  mappingSuccess = false;
-  throw std::runtime_error("Recursive Expressions not implemented");
+void Proj_PchorASTVisitor::visit(const RecExpr &expr) {
+  /*
+    The body is projected once, not unrolled. Every participant of the
+    recursion continues it wherever the body does, so the participants are
+    collected first. The second projection then knows whom a continuation
+    applies to, also in branches a participant takes no part in
+  */
+  const std::string &recVar = expr.getRecVar();
+  auto outer = this->ctx;
+  // a referenced global type may reuse the name of an enclosing recursion
+  auto shadowed = recursionScopes.extract(recVar);
+  auto restoreScope = [this, &recVar, &shadowed, &outer]() {
+    recursionScopes.erase(recVar);
+    if (!shadowed.empty()) {
+      recursionScopes.insert(std::move(shadowed));
+    }
+    this->ctx = outer;
+  };
+
+  auto participants = std::make_shared<PchorProjection>();
+  auto body = std::make_shared<PchorProjection>();
+  try {
+    this->ctx = participants;
+    expr.getBody()->accept(*this);
+
+    recursionScopes.insert_or_assign(recVar, participants);
+    this->ctx = body;
+    expr.getBody()->accept(*this);
+  } catch (...) {
+    restoreScope();
+    throw;
+  }
+  restoreScope();
+
+  for (const auto &[key, projections] : *participants) {
+    if (!this->ctx->hasProjection(key)) {
+      this->ctx->addParticipant(key);
+    }
+    this->ctx->addProjection(
+        key, std::make_unique<Prec>(recVar, body->extractProjection(key)));
+  }
 }
-void Proj_PchorASTVisitor::visit([[maybe_unused]] const ConExpr &expr) {
-  mappingSuccess = false;
-  throw std::runtime_error("Continuation Expressions not implemented");
+void Proj_PchorASTVisitor::visit(const ConExpr &expr) {
+  // while the participants of the recursion are being collected, there is
+  // nothing to continue yet
+  auto scope = recursionScopes.find(expr.getRecVar());
+  if (scope == recursionScopes.end()) {
+    return;
+  }
+  for (const auto &[key, projections] : *scope->second) {
+    if (!this->ctx->hasProjection(key)) {
+      this->ctx->addParticipant(key);
+    }
+    this->ctx->addProjection(key,
+                             std::make_unique<Pcontinue>(expr.getRecVar()));
+  }
 }
 
 void Proj_PchorASTVisitor::visit([[maybe_unused]] const IterExpr &expr) {
@@ -227,6 +473,15 @@ void Proj_PchorASTVisitor::visit(const ForEachExpr &expr) {
     std::println("The case for indeces with no upper bound has not been implemented");
     mappingSuccess = false;
   }
+  else if (auto iterations = getDemandedIterations(expr)) {
+    // only the values involving a demanded participant are projected
+    const std::string identifier = iterExpr->getIdentifierRef();
+    for (size_t el : *iterations) {
+      this->indexIdentifierMap.insert_or_assign(identifier, el);
+      expr.getBody()->accept(*this);
+    }
+    this->indexIdentifierMap.erase(identifier);
+  }
   else {
     const std::string identifier = iterExpr->getIdentifierRef();
     size_t el = iterExpr->getMin();
@@ -248,4 +503,152 @@ void Proj_PchorASTVisitor::visit(const ForEachExpr &expr) {
   }
   //set index context for this iteration, then run it
 }
-} // namespace PchorAST
\ No newline at end of file
+
+std::optional<std::vector<size_t>>
+Proj_PchorASTVisitor::getDemandedIterations(const ForEachExpr &expr) const {
+  if (demand.all()) {
+    return std::nullopt;
+  }
+  const auto iterExpr = expr.getIter();
+  const std::string &identifier = iterExpr->getIdentifierRef();
+  const auto min = static_cast<int64_t>(iterExpr->getMin());
+  const auto max = static_cast<int64_t>(iterExpr->getMax());
+
+  std::vector<const ParticipantExpr *> participants{};
+  collectParticipants(*expr.getBody(), participants);
+
+  /*
+    Every index expression is an affine function a * i + b of the iteration
+    value i, so the values giving a demanded index k are found by solving
+    a * i + b = k instead of projecting the body for each of them
+  */
+  std::vector<size_t> iterations{};
+  for (const ParticipantExpr *participant : participants) {
+    auto indices =
+        demand.getIndices(participant->getBaseParticipant()->getName());
+    if (!indices) {
+      return std::nullopt;
+    }
+    auto index =
+        participant->getIndex()->getAffine(identifier, indexIdentifierMap);
+    if (!index) {
+      // depends on an inner iteration, which is not solved for
+      return std::nullopt;
+    }
+    for (size_t demanded : *indices) {
+      const int64_t difference =
+          static_cast<int64_t>(demanded) - index->constant;
+      if (index->coefficient == 0) {
+        if (difference == 0) {
+          return std::nullopt;
+        }
+        continue;
+      }
+      if (difference % index->coefficient != 0) {
+        continue;
+      }
+      const int64_t value = difference / index->coefficient;
+      if (value >= min && value <= max) {
+        iterations.push_back(static_cast<size_t>(value));
+      }
+    }
+  }
+  std::sort(iterations.begin(), iterations.end());
+  iterations.erase(std::unique(iterations.begin(), iterations.end()),
+                   iterations.end());
+  return iterations;
+}
+
+void Proj_PchorASTVisitor::collectParticipants(
+    const ExprPchorASTNode &expr,
+    std::vector<const ParticipantExpr *> &into) {
+  switch (expr.getExprType()) {
+  case Expr::ComExpr: {
+    const auto &communication = static_cast<const CommunicationExpr &>(expr);
+    into.push_back(communication.getSender().get());
+    into.push_back(communication.getReciever().get());
+    break;
+  }
+  case Expr::SelectionExpr: {
+    const auto &selection = static_cast<const SelectionExpr &>(expr);
+    into.push_back(selection.getSender().get());
+    into.push_back(selection.getReciever().get());
+    for (const auto &[label, body] : selection.getBranches()) {
+      collectParticipants(*body, into);
+    }
+    break;
+  }
+  case Expr::AggregateExpr:
+    for (const auto &child : static_cast<const ExprList &>(expr)) {
+      collectParticipants(*child, into);
+    }
+    break;
+  case Expr::RecExpr:
+    collectParticipants(*static_cast<const RecExpr &>(expr).getBody(), into);
+    break;
+  case Expr::ForEachExpr:
+    collectParticipants(*static_cast<const ForEachExpr &>(expr).getBody(),
+                        into);
+    break;
+  default:
+    break;
+  }
+}
+
+void Proj_PchorASTVisitor::collectFreeIdentifiers(
+    const ExprPchorASTNode &expr, std::unordered_set<std::string> &bound,
+    std::unordered_set<std::string> &into) {
+  std::unordered_set<std::string> read{};
+  auto readIndex = [&read](const auto &node) {
+    if (node && node->getIndex()) {
+      node->getIndex()->collectIdentifiers(read);
+    }
+  };
+  switch (expr.getExprType()) {
+  case Expr::ComExpr: {
+    const auto &communication = static_cast<const CommunicationExpr &>(expr);
+    readIndex(communication.getSender());
+    readIndex(communication.getReciever());
+    readIndex(communication.getChannel());
+    break;
+  }
+  case Expr::SelectionExpr: {
+    const auto &selection = static_cast<const SelectionExpr &>(expr);
+    readIndex(selection.getSender());
+    readIndex(selection.getReciever());
+    readIndex(selection.getChannel());
+    for (const auto &[label, body] : selection.getBranches()) {
+      collectFreeIdentifiers(*body, bound, into);
+    }
+    break;
+  }
+  case Expr::AggregateExpr:
+    for (const auto &child : static_cast<const ExprList &>(expr)) {
+      collectFreeIdentifiers(*child, bound, into);
+    }
+    break;
+  case Expr::RecExpr:
+    collectFreeIdentifiers(*static_cast<const RecExpr &>(expr).getBody(),
+                           bound, into);
+    break;
+  case Expr::ForEachExpr: {
+    const auto &forEach = static_cast<const ForEachExpr &>(expr);
+    const std::string &identifier = forEach.getIter()->getIdentifierRef();
+    const bool shadows = !bound.insert(identifier).second;
+    collectFreeIdentifiers(*forEach.getBody(), bound, into);
+    if (!shadows) {
+      bound.erase(identifier);
+    }
+    break;
+  }
+  default:
+    break;
+  }
+  for (const std::string &identifier : read) {
+    if (!bound.contains(identifier)) {
+      into.insert(identifier);
+    }
+  }
+}
+
+} // namespace PchorAST
@@ -2,13 +2,20 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <print>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "../../pchor/ast/PchorAST.hpp"
 #include "../../pchor/ast/PchorProjection.hpp"
+#include "../utils/AnnotationIndex.hpp"
 #include "../utils/CASTAnalyzerUtils.hpp"
 #include "../utils/ContextManager.hpp"
+#include "../utils/RecordFieldIndex.hpp"
 
 namespace PchorAST {
 
@@ -27,6 +34,7 @@ public:
 
   // Visiting Expressions
   virtual void visit(const CommunicationExpr &expr) = 0;
+  virtual void visit(const SelectionExpr &expr) = 0;
   virtual void visit(const ExprList &expr) = 0;
   virtual void visit(const ParticipantExpr &expr) = 0;
   virtual void visit(const ChannelExpr &expr) = 0;
@@ -45,8 +53,11 @@ class CAST_PchorASTVisitor : public AbstractPchorASTVisitor {
 public:
   CAST_PchorASTVisitor(clang::ASTContext &clangContext)
       : AbstractPchorASTVisitor(clangContext),
-        ctx(std::make_shared<PchorAST::CASTMapping>()), currentDataType(""),
-        senderIdentifier(""), recieverIdentifier(""), mappingSuccess(true) {}
+        ctx(std::make_shared<PchorAST::CASTMapping>()),
+        annotations(clangContext), fieldIndices(), mappedParticipants(),
+        missingParticipants(),
+        currentDataType(""), senderIdentifier(""), recieverIdentifier(""),
+        mappingSuccess(true) {}
 
   ~CAST_PchorASTVisitor() = default;
 
@@ -59,6 +70,7 @@ public:
 
   // Visiting Expressions
   void visit(const CommunicationExpr &expr) override;
+  void visit(const SelectionExpr &expr) override;
   void visit(const ExprList &expr) override;
   void visit(const ParticipantExpr &expr) override;
   void visit(const ChannelExpr &expr) override;
@@ -69,25 +81,45 @@ public:
   void visit(const ForEachExpr &expr) override;
 
   std::shared_ptr<PchorAST::CASTMapping> getContext() { return ctx; }
+  // participants with and without a declaration in the translation unit
+  const std::vector<std::string> &getMappedParticipants() const {
+    return mappedParticipants;
+  }
+  const std::vector<std::string> &getMissingParticipants() const {
+    return missingParticipants;
+  }
 
   void printMappings() { ctx->printMappings(); }
 
 private:
   std::shared_ptr<PchorAST::CASTMapping> ctx;
+  // explicit mappings, tried before any heuristic search
+  AnnotationIndex annotations;
+  // fields of every participant record, indexed on first use
+  std::unordered_map<const clang::Decl *, RecordFieldIndex> fieldIndices;
+  std::vector<std::string> mappedParticipants;
+  std::vector<std::string> missingParticipants;
   std::string currentDataType;
   std::string senderIdentifier;
   std::string recieverIdentifier;
   bool mappingSuccess;
+
+  bool isMapped(const std::string &participant);
+  // Field of participant carrying the current data type for channel
+  const clang::FieldDecl *resolveChannel(const clang::Decl *participant,
+                                         const std::string &channel);
 };
 
 class Proj_PchorASTVisitor : public AbstractPchorASTVisitor {
 public:
-  Proj_PchorASTVisitor(clang::ASTContext &clangContext)
-      : AbstractPchorASTVisitor(clangContext),
+  // Projects the participants asked for by demand, every one by default
+  Proj_PchorASTVisitor(clang::ASTContext &clangContext,
+                       ParticipantDemand demand = ParticipantDemand{})
+      : AbstractPchorASTVisitor(clangContext), demand(std::move(demand)),
         indexIdentifierMap(),
-        ctx(std::make_shared<PchorProjection>()), currentDataType(""),
-        currentChannelName(""), channelIndex(), isSender(true),
-        mappingSuccess(true) {}
+        ctx(std::make_shared<PchorProjection>()), projectionMemo(),
+        freeIdentifiers(), recursionScopes(), currentDataType(""), currentChannelName(""),
+        channelIndex(), isSender(true), mappingSuccess(true) {}
 
   ~Proj_PchorASTVisitor() = default;
 
@@ -100,6 +132,7 @@ public:
 
   // Visiting Expressions
   void visit(const CommunicationExpr &expr) override;
+  void visit(const SelectionExpr &expr) override;
   void visit(const ExprList &expr) override;
   void visit(const ParticipantExpr &expr) override;
   void visit(const ChannelExpr &expr) override;
@@ -114,13 +147,44 @@ public:
   void printProjections() const { ctx->printProjections(); }
 
 private:
+  ParticipantDemand demand;
   std::unordered_map<std::string, size_t> indexIdentifierMap;
   std::shared_ptr<PchorProjection> ctx;
+  /*
+    Projections of referenced global types, keyed by the type's expression
+    list and the values of the index identifiers it reads without binding
+    them. Each type is projected once per such environment, and every
+    reference shares the memoized projections
+  */
+  std::unordered_map<std::string, std::shared_ptr<PchorProjection>>
+      projectionMemo;
+  // index identifiers read but not bound by referenced global types, sorted
+  std::unordered_map<const ExprList *, std::vector<std::string>>
+      freeIdentifiers;
+  // participants of every recursion whose body is being projected
+  std::unordered_map<std::string, std::shared_ptr<PchorProjection>>
+      recursionScopes;
   std::string currentDataType;
   std::string currentChannelName;
   size_t channelIndex;
   bool isSender;
   bool mappingSuccess;
+
+  void projectExprList(const ExprList &expr);
+  ParticipantKey getParticipantKey(const ParticipantExpr &expr);
+  std::string getMemoKey(const ExprList &expr);
+
+  // Values of the iteration of expr involving a demanded participant, in
+  // ascending order. nullopt if every value may involve one
+  std::optional<std::vector<size_t>>
+  getDemandedIterations(const ForEachExpr &expr) const;
+  static void collectParticipants(const ExprPchorASTNode &expr,
+                                  std::vector<const ParticipantExpr *> &into);
+  // Adds the index identifiers read in expr and not bound by a foreach
+  // within it, or in bound, to into
+  static void collectFreeIdentifiers(const ExprPchorASTNode &expr,
+                                     std::unordered_set<std::string> &bound,
+                                     std::unordered_set<std::string> &into);
 };
 
 } // namespace PchorAST
\ No newline at end of file
@@ -0,0 +1,470 @@
+#include "AutomatonValidator.hpp"
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+namespace PchorAST {
+
+// coroutines communicate by awaiting a send or recv of an AsyncChannel
+static std::unordered_set<std::string> sendSet{
+    "CXXOperatorCallExpr", "CallExpr", "BinaryOperator", "ExprWithCleanups",
+    "CXXMemberCallExpr", "CoawaitExpr"};
+static std::unordered_set<std::string> recieveSet{
+    "WhileStmt", "ExprWithCleanups", "CXXMemberCallExpr", "CoawaitExpr"};
+
+bool AutomatonValidator::validateFunctionDecl(
+    const clang::FunctionDecl *funcDecl) {
+  if (!funcDecl->hasBody() || !cfgCache.get(funcDecl)) {
+    return false;
+  }
+  Outcome outcome = summarise(funcDecl, automaton.getInitialState());
+  // no state is left if the body ends in a loop that serves a recursion forever
+  const bool valid =
+      !outcome.stuck &&
+      std::all_of(outcome.states.begin(), outcome.states.end(),
+                  [this](size_t state) { return automaton.isFinal(state); });
+
+  // only the paths that complete the local type are reported, or serve a
+  // recursion forever without getting stuck
+  lastMatches.clear();
+  for (size_t pos = 0; pos < outcome.states.size(); ++pos) {
+    if (automaton.isFinal(outcome.states[pos])) {
+      merge(lastMatches, outcome.matches[pos]);
+    }
+  }
+  if (!outcome.stuck) {
+    merge(lastMatches, outcome.forever);
+  }
+  const clang::SourceManager &sourceManager = context.getSourceManager();
+  std::sort(lastMatches.begin(), lastMatches.end(),
+            [&sourceManager](const clang::Stmt *lhs, const clang::Stmt *rhs) {
+              return sourceManager.isBeforeInTranslationUnit(
+                  lhs->getBeginLoc(), rhs->getBeginLoc());
+            });
+  return valid;
+}
+
+AutomatonValidator::Outcome
+AutomatonValidator::summarise(const clang::FunctionDecl *funcDecl,
+                              size_t state) {
+  MemoKey key{state, funcDecl};
+  if (auto it = summaries.find(key); it != summaries.end()) {
+    return it->second;
+  }
+  const FunctionCFG *functionCFG = cfgCache.get(funcDecl);
+  if (!functionCFG) {
+    return Outcome{StateSet{state}, false, {StmtSet{}}, {}, {}};
+  }
+  // a recursive call is taken to return in the state it was made in
+  if (activeFunctions.contains(funcDecl)) {
+    return Outcome{StateSet{state}, false, {StmtSet{}}, {}, {funcDecl}};
+  }
+
+  accessIndex.index(funcDecl);
+  activeFunctions.insert(funcDecl);
+  Outcome outcome{};
+  try {
+    outcome = analyse(*functionCFG, state);
+  } catch (...) {
+    activeFunctions.erase(funcDecl);
+    throw;
+  }
+  activeFunctions.erase(funcDecl);
+
+  // its own recursive calls are cut off the same way wherever funcDecl is
+  // called from, those of its callers depend on the call stack
+  std::erase(outcome.cutOff, funcDecl);
+  if (outcome.cutOff.empty()) {
+    summaries.insert_or_assign(key, outcome);
+  }
+  return outcome;
+}
+
+AutomatonValidator::Outcome
+AutomatonValidator::analyse(const FunctionCFG &functionCFG, size_t state) {
+  const clang::CFG &cfg = *functionCFG.cfg;
+  const size_t stateCount = automaton.size();
+  auto pairOf = [stateCount](const clang::CFGBlock &block, size_t current) {
+    return block.getBlockID() * stateCount + current;
+  };
+
+  // only the (block, state) pairs reached get an id, with where they were
+  // reached from and the statements taking transitions while processing them
+  std::unordered_map<size_t, size_t> ids{};
+  std::vector<size_t> pairs{};
+  std::vector<std::vector<size_t>> predecessors{};
+  std::vector<StmtSet> matches{};
+  auto reach = [&](size_t pair) {
+    auto [id, added] = ids.try_emplace(pair, pairs.size());
+    if (added) {
+      pairs.push_back(pair);
+      predecessors.emplace_back();
+      matches.emplace_back();
+    }
+    return std::pair{id->second, added};
+  };
+
+  // pairs entered by jumping back to the start of a loop
+  std::vector<size_t> loopEntries{};
+  std::vector<size_t> worklist{reach(pairOf(cfg.getEntry(), state)).first};
+  bool stuck = false;
+  // matched in callees on paths that never return from them
+  StmtSet forever{};
+  std::vector<const clang::FunctionDecl *> cutOff{};
+
+  while (!worklist.empty()) {
+    const size_t node = worklist.back();
+    worklist.pop_back();
+    const clang::CFGBlock &block =
+        *functionCFG.blocks[pairs[node] / stateCount];
+
+    StateSet states{pairs[node] % stateCount};
+    for (const clang::CFGElement &element : block) {
+      auto cfgStmt = element.getAs<clang::CFGStmt>();
+      if (!cfgStmt) {
+        continue;
+      }
+      StateSet next{};
+      for (size_t current : states) {
+        Outcome outcome = step(cfgStmt->getStmt(), current);
+        stuck = stuck || outcome.stuck;
+        merge(next, outcome.states);
+        for (const StmtSet &matched : outcome.matches) {
+          merge(matches[node], matched);
+        }
+        merge(forever, outcome.forever);
+        merge(cutOff, outcome.cutOff);
+      }
+      states = std::move(next);
+    }
+
+    const bool backEdge = block.getLoopTarget() != nullptr;
+    for (size_t current : states) {
+      for (const auto &[successor, entered] :
+           successors(block, current, matches[node])) {
+        const auto [target, added] = reach(pairOf(*successor, entered));
+        predecessors[target].push_back(node);
+        if (backEdge) {
+          loopEntries.push_back(target);
+        }
+        if (added) {
+          worklist.push_back(target);
+        }
+      }
+    }
+  }
+
+  // the function returns in the states reaching its exit block
+  StateSet exits{};
+  // positions in exits of the exits every pair is on a path to, found for
+  // all of them in one pass back from the exit block
+  std::vector<StateSet> exitPaths(pairs.size());
+  std::vector<size_t> pending{};
+  for (size_t current = 0; current < stateCount; ++current) {
+    auto id = ids.find(pairOf(cfg.getExit(), current));
+    if (id == ids.end()) {
+      continue;
+    }
+    exitPaths[id->second].push_back(exits.size());
+    pending.push_back(id->second);
+    exits.push_back(current);
+  }
+  while (!pending.empty()) {
+    const size_t node = pending.back();
+    pending.pop_back();
+    for (size_t predecessor : predecessors[node]) {
+      const size_t known = exitPaths[predecessor].size();
+      merge(exitPaths[predecessor], exitPaths[node]);
+      if (exitPaths[predecessor].size() != known) {
+        pending.push_back(predecessor);
+      }
+    }
+  }
+
+  // the statements matched on the paths to each exit, while the rest of
+  // the paths never return
+  std::vector<StmtSet> exitMatches(exits.size());
+  for (size_t node = 0; node < pairs.size(); ++node) {
+    if (exitPaths[node].empty()) {
+      merge(forever, matches[node]);
+    }
+    for (size_t pos : exitPaths[node]) {
+      merge(exitMatches[pos], matches[node]);
+    }
+  }
+
+  // a loop that never returns must run whole rounds of a recursion
+  for (size_t node : loopEntries) {
+    const size_t current = pairs[node] % stateCount;
+    if (exitPaths[node].empty() && !automaton.isLoopBack(current) &&
+        !automaton.isFinal(current)) {
+      stuck = true;
+    }
+  }
+  return Outcome{exits, stuck, std::move(exitMatches), std::move(forever),
+                 std::move(cutOff)};
+}
+
+AutomatonValidator::Outcome AutomatonValidator::step(const clang::Stmt *stmt,
+                                                     size_t state) {
+  MemoKey key{state, stmt};
+  if (auto it = memo.find(key); it != memo.end()) {
+    return it->second;
+  }
+  Outcome outcome{};
+  size_t target = matchTransition(stmt, state);
+  if (target != LocalAutomaton::noState) {
+    outcome = Outcome{StateSet{target}, false, {StmtSet{stmt}}, {}, {}};
+  } else {
+    outcome = stepCall(stmt, state);
+  }
+  if (outcome.cutOff.empty()) {
+    memo.insert_or_assign(key, outcome);
+  }
+  return outcome;
+}
+
+size_t AutomatonValidator::matchTransition(const clang::Stmt *stmt,
+                                           size_t state) {
+  // a receive is decided by the condition its loop waits on
+  const auto *whileStmt = llvm::dyn_cast<clang::WhileStmt>(stmt);
+  const auto accesses =
+      accessIndex.getAccesses(whileStmt ? whileStmt->getCond() : stmt);
+  if (accesses.empty()) {
+    return LocalAutomaton::noState;
+  }
+  const std::string type = stmt->getStmtClassName();
+
+  for (const auto &transition : automaton.getState(state).transitions) {
+    const auto *channelDecl =
+        getMapping(transition.projection->getChannelName());
+    const auto *typeDecl = getMapping(transition.projection->getTypeName());
+    if (!channelDecl || !typeDecl) {
+      throw std::runtime_error(
+          std::format("Failed to Retrieve data from CASTmap"));
+    }
+
+    switch (transition.kind) {
+    case TransitionKind::Send:
+      if (sendSet.contains(type) &&
+          ChannelAccessIndex::contains(accesses, channelDecl,
+                                       AccessKind::Write) &&
+          AnalyzerUtils::validateSendExpression(stmt, channelDecl, typeDecl,
+                                                context)) {
+        return fanOutTarget(transition, channelDecl);
+      }
+      break;
+    case TransitionKind::Recieve:
+      if (recieveSet.contains(type) &&
+          ChannelAccessIndex::contains(accesses, channelDecl) &&
+          AnalyzerUtils::validateRecieveExpression(stmt, channelDecl,
+                                                   typeDecl, context)) {
+        return transition.target;
+      }
+      break;
+    case TransitionKind::Select:
+      if (sendSet.contains(type) &&
+          ChannelAccessIndex::contains(accesses, channelDecl,
+                                       AccessKind::Write)) {
+        const auto *label = AnalyzerUtils::findSelectedLabel(
+            stmt, channelDecl, typeDecl, context);
+        if (label && label->getName() == transition.label) {
+          return transition.target;
+        }
+      }
+      break;
+    case TransitionKind::Label:
+      break;
+    }
+  }
+  return LocalAutomaton::noState;
+}
+
+AutomatonValidator::Outcome
+AutomatonValidator::stepCall(const clang::Stmt *stmt, size_t state) {
+  const std::string type = stmt->getStmtClassName();
+  if (!sendSet.contains(type) && !recieveSet.contains(type)) {
+    return Outcome{StateSet{state}, false, {StmtSet{}}, {}, {}};
+  }
+  const clang::FunctionDecl *callee =
+      AnalyzerUtils::findFunctionDefinition(stmt, context);
+  // the standard library does not communicate over protocol channels
+  if (!callee || !callee->hasBody() ||
+      context.getSourceManager().isInSystemHeader(callee->getLocation())) {
+    return Outcome{StateSet{state}, false, {StmtSet{}}, {}, {}};
+  }
+  // neither does code that never reaches a channel, however much of it runs
+  if (!callGraph.mayCommunicate(callee)) {
+    return Outcome{StateSet{state}, false, {StmtSet{}}, {}, {}};
+  }
+  return summarise(callee, state);
+}
+
+AutomatonValidator::Successors
+AutomatonValidator::successors(const clang::CFGBlock &block, size_t state,
+                               std::vector<const clang::Stmt *> &matches) {
+  if (automaton.isChoice(state)) {
+    return choiceSuccessors(block, state);
+  }
+  Successors result{};
+
+  // a receive waits in a loop on the channel, and is done once it is left
+  if (const auto *whileStmt =
+          llvm::dyn_cast_or_null<clang::WhileStmt>(block.getTerminatorStmt())) {
+    size_t target = matchTransition(whileStmt, state);
+    if (target != LocalAutomaton::noState) {
+      merge(matches, std::vector<const clang::Stmt *>{whileStmt});
+      if (block.succ_size() == 2) {
+        if (const clang::CFGBlock *after =
+                block.succ_begin()[1].getReachableBlock()) {
+          result.emplace_back(after, target);
+        }
+      }
+      return result;
+    }
+  }
+
+  for (const auto &adjacent : block.succs()) {
+    if (const clang::CFGBlock *successor = adjacent.getReachableBlock()) {
+      result.emplace_back(successor, state);
+    }
+  }
+  return result;
+}
+
+AutomatonValidator::Successors
+AutomatonValidator::choiceSuccessors(const clang::CFGBlock &block,
+                                     size_t state) {
+  /*
+    A label has been received, and the code decides how to continue by
+    comparing it against the enumerators of the label enum
+  */
+  const auto &transitions = automaton.getState(state).transitions;
+  const auto *labelDecl =
+      getMapping(transitions.front().projection->getTypeName());
+  const clang::Stmt *terminator = block.getTerminatorStmt();
+  Successors result{};
+
+  // index of the transition taking label, transitions.size() if none does
+  auto transitionOf = [&transitions](const clang::EnumConstantDecl *label) {
+    size_t pos = 0;
+    while (label && pos < transitions.size() &&
+           label->getName() != transitions[pos].label) {
+      ++pos;
+    }
+    return label ? pos : transitions.size();
+  };
+
+  if (const auto *ifStmt = llvm::dyn_cast_or_null<clang::IfStmt>(terminator);
+      ifStmt && block.succ_size() == 2) {
+    const auto comparison = AnalyzerUtils::findLabelComparison(
+        ifStmt->getCond(),
+        getMapping(transitions.front().projection->getChannelName()),
+        labelDecl, context);
+    size_t pos = transitionOf(comparison.label);
+    if (pos < transitions.size()) {
+      // with two labels, not taking one of them means taking the other
+      size_t labelEntry = transitions[pos].target;
+      size_t otherEntry = state;
+      if (transitions.size() == 2) {
+        otherEntry = transitions[1 - pos].target;
+      }
+      if (!comparison.equal) {
+        std::swap(labelEntry, otherEntry);
+      }
+      if (const clang::CFGBlock *then =
+              block.succ_begin()[0].getReachableBlock()) {
+        result.emplace_back(then, labelEntry);
+      }
+      if (const clang::CFGBlock *otherwise =
+              block.succ_begin()[1].getReachableBlock()) {
+        result.emplace_back(otherwise, otherEntry);
+      }
+      return result;
+    }
+  }
+
+  if (llvm::isa_and_nonnull<clang::SwitchStmt>(terminator)) {
+    std::vector<bool> handled(transitions.size(), false);
+    // the default case, or the code after the switch if there is none
+    std::vector<const clang::CFGBlock *> unmatched{};
+    for (const auto &adjacent : block.succs()) {
+      const clang::CFGBlock *successor = adjacent.getReachableBlock();
+      if (!successor) {
+        continue;
+      }
+      const auto *caseStmt =
+          llvm::dyn_cast_or_null<clang::CaseStmt>(successor->getLabel());
+      if (!caseStmt) {
+        unmatched.push_back(successor);
+        continue;
+      }
+      size_t pos = transitionOf(AnalyzerUtils::findLabelReference(
+          caseStmt->getLHS(), labelDecl, context));
+      if (pos < transitions.size()) {
+        handled[pos] = true;
+        result.emplace_back(successor, transitions[pos].target);
+      }
+    }
+    // labels without a case leave the choice unresolved
+    if (std::find(handled.begin(), handled.end(), false) != handled.end()) {
+      for (const clang::CFGBlock *successor : unmatched) {
+        result.emplace_back(successor, state);
+      }
+    }
+    return result;
+  }
+
+  // code that does not inspect the label keeps the choice open
+  for (const auto &adjacent : block.succs()) {
+    if (const clang::CFGBlock *successor = adjacent.getReachableBlock()) {
+      result.emplace_back(successor, state);
+    }
+  }
+  return result;
+}
+
+size_t AutomatonValidator::fanOutTarget(const AutomatonTransition &transition,
+                                        const clang::Decl *channelDecl) const {
+  const auto *field = llvm::dyn_cast<clang::FieldDecl>(channelDecl);
+  if (!field ||
+      RecordFieldIndex::describe(field).wrapper != multicastWrapper) {
+    return transition.target;
+  }
+  // one send to a multicast channel reaches every reciever, so it takes the
+  // sends to the other indices of the channel following it as well
+  const auto *projection = transition.projection;
+  std::unordered_set<size_t> indices{projection->getChannelIndex()};
+  size_t target = transition.target;
+  while (true) {
+    const auto &next = automaton.getState(target).transitions;
+    if (next.size() != 1 || next.front().kind != TransitionKind::Send ||
+        next.front().projection->getChannelName() !=
+            projection->getChannelName() ||
+        next.front().projection->getTypeName() != projection->getTypeName() ||
+        !indices.insert(next.front().projection->getChannelIndex()).second) {
+      return target;
+    }
+    target = next.front().target;
+  }
+}
+
+const clang::Decl *
+AutomatonValidator::getMapping(const std::string &name) const {
+  return CASTmap->getMapping<const clang::Decl *>(name);
+}
+
+template <typename T>
+void AutomatonValidator::merge(std::vector<T> &into,
+                               const std::vector<T> &from) {
+  for (const T &value : from) {
+    auto pos = std::lower_bound(into.begin(), into.end(), value);
+    if (pos == into.end() || *pos != value) {
+      into.insert(pos, value);
+    }
+  }
+}
+
+} // namespace PchorAST
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <clang/AST/ASTContext.h>
+#include <clang/AST/Decl.h>
+#include <clang/AST/Stmt.h>
+#include <clang/Analysis/CFG.h>
+
+#include "../../pchor/ast/PchorAutomaton.hpp"
+#include "../utils/CASTAnalyzerUtils.hpp"
+#include "../utils/CFGCache.hpp"
+#include "../utils/ChannelAccessIndex.hpp"
+#include "../utils/ChannelCallGraph.hpp"
+#include "../utils/ContextManager.hpp"
+#include "../utils/RecordFieldIndex.hpp"
+
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace PchorAST {
+
+/*
+  Validates function bodies against the local automaton of a participant.
+  The CFG of a function is paired with the automaton: the (CFG block,
+  automaton state) pairs are recorded as they are reached, and each pair is
+  processed once. Every statement is therefore matched once per
+  state it can be reached in, whatever the number of paths through the code,
+  and branches, loops, breaks and returns follow the edges of the CFG.
+
+  A send to a MulticastChannel field reaches every reciever of the
+  channel, so it takes the whole run of sends over the channel's indices
+  that follows in the automaton, as projected from a foreach.
+
+  Coroutines recieve and send by awaiting recv and send on an AsyncChannel
+  field, which are matched like the waiting loops and assignments of
+  threads.
+
+  Statements are only handed to the matchers of a transition if the channel
+  access index records a use of its channel within them, which rules out
+  most statements without searching them.
+
+  Calls are summarised by the states their callee can return in, remembered
+  per (state, callee). A recursive call is taken to return in the state it
+  was made in, so outcomes that cut off a function further up the call
+  stack depend on how it was reached and are not remembered. Callees that the call graph shows never reach a
+  channel are stepped over without being analysed. Loops are matched against
+  the cycles of recursions. A loop that never reaches the end of its function
+  must get back to a recursion with every round it takes, otherwise it is
+  stuck.
+*/
+class AutomatonValidator {
+public:
+  explicit AutomatonValidator(clang::ASTContext &context,
+                              std::shared_ptr<CASTMapping> &CASTmap,
+                              const LocalAutomaton &automaton,
+                              CFGCache &cfgCache,
+                              ChannelAccessIndex &accessIndex,
+                              ChannelCallGraph &callGraph)
+      : context(context), CASTmap(CASTmap), automaton(automaton),
+        cfgCache(cfgCache), accessIndex(accessIndex), callGraph(callGraph),
+        memo(), summaries(), activeFunctions(), lastMatches() {}
+
+  // True if every path through the body of funcDecl ends in a final state
+  bool validateFunctionDecl(const clang::FunctionDecl *funcDecl);
+
+  // Statements that took a transition on the paths of the last validation
+  // ending in a final state, including those in callees, in source order
+  const std::vector<const clang::Stmt *> &getMatches() const {
+    return lastMatches;
+  }
+
+private:
+  // sorted and without duplicates
+  using StateSet = std::vector<size_t>;
+  using Successors = std::vector<std::pair<const clang::CFGBlock *, size_t>>;
+
+  struct MemoKey {
+    size_t state;
+    const void *node;
+    bool operator==(const MemoKey &other) const {
+      return state == other.state && node == other.node;
+    }
+  };
+  struct MemoKeyHash {
+    size_t operator()(const MemoKey &key) const {
+      return std::hash<const void *>{}(key.node) ^ (key.state << 1);
+    }
+  };
+  // sorted by address and without duplicates
+  using StmtSet = std::vector<const clang::Stmt *>;
+  // states reached after a statement or function, whether a loop on the
+  // way was found to be stuck, and the statements taking transitions on the
+  // paths ending in each of the states, in the order of states, and on the
+  // paths that never return. cutOff holds the functions whose recursive
+  // calls were cut off by the guard on the way, sorted by address
+  struct Outcome {
+    StateSet states;
+    bool stuck;
+    std::vector<StmtSet> matches;
+    StmtSet forever;
+    std::vector<const clang::FunctionDecl *> cutOff;
+  };
+
+  clang::ASTContext &context;
+  std::shared_ptr<CASTMapping> &CASTmap;
+  const LocalAutomaton &automaton;
+  CFGCache &cfgCache;
+  ChannelAccessIndex &accessIndex;
+  ChannelCallGraph &callGraph;
+  // keyed by statement
+  std::unordered_map<MemoKey, Outcome, MemoKeyHash> memo;
+  // keyed by function
+  std::unordered_map<MemoKey, Outcome, MemoKeyHash> summaries;
+  // guards against following recursive calls forever, see Outcome::cutOff
+  std::unordered_set<const clang::FunctionDecl *> activeFunctions;
+  std::vector<const clang::Stmt *> lastMatches;
+
+  // template of the runtime's one-to-many channel
+  static constexpr std::string_view multicastWrapper = "MulticastChannel";
+
+  Outcome summarise(const clang::FunctionDecl *funcDecl, size_t state);
+  Outcome analyse(const FunctionCFG &functionCFG, size_t state);
+
+  Outcome step(const clang::Stmt *stmt, size_t state);
+  // Transitions of state matched directly by stmt, noState if none does
+  size_t matchTransition(const clang::Stmt *stmt, size_t state);
+  // Target of a send over channelDecl, after the sends a multicast channel
+  // takes along with it
+  size_t fanOutTarget(const AutomatonTransition &transition,
+                      const clang::Decl *channelDecl) const;
+  Outcome stepCall(const clang::Stmt *stmt, size_t state);
+
+  // Successors of block taken in state, each with the state it is entered in.
+  // A receive in the terminator of block is added to matches
+  Successors successors(const clang::CFGBlock &block, size_t state,
+                        StmtSet &matches);
+  Successors choiceSuccessors(const clang::CFGBlock &block, size_t state);
+
+  const clang::Decl *getMapping(const std::string &name) const;
+  // merges sorted vectors without duplicates
+  template <typename T>
+  static void merge(std::vector<T> &into, const std::vector<T> &from);
+};
+
+} // namespace PchorAST
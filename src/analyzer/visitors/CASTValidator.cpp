@@ -1,23 +1,27 @@
 #include "CASTValidator.hpp"
+#include "AutomatonValidator.hpp"
+
+#include <algorithm>
+#include <chrono>
 
 namespace PchorAST {
 
-void CASTValidator::printValidations() {
-  std::println("\n\nSuccessfull Validations:\n-------------------");
+void CASTValidator::printValidations(std::FILE *out) const {
+  std::println(out, "\n\nSuccessfull Validations:\n-------------------");
   for (const auto &[key, values] : successfullValidations) {
-    std::print("{}: ", key);
+    std::print(out, "{}: ", key);
     for (const auto &str : values) {
-      std::print("{} ", str);
+      std::print(out, "{} ", str);
     }
-    std::println("");
+    std::println(out, "");
   }
-  std::println("\n\nFailed Validations:\n-------------------");
+  std::println(out, "\n\nFailed Validations:\n-------------------");
   for (const auto &[key, values] : failedValidations) {
-    std::print("{}: ", key);
+    std::print(out, "{}: ", key);
     for (const auto &str : values) {
-      std::print("{} ", str);
+      std::print(out, "{} ", str);
     }
-    std::println("");
+    std::println(out, "");
   }
 }
 clang::FunctionDecl *CASTValidator::validateFuncDecl(
@@ -57,7 +61,16 @@ bool CASTValidator::validateProjection(
     clang::ASTContext &Context, std::shared_ptr<CASTMapping> &CASTmap,
     std::shared_ptr<PchorProjection> &projectionMap) {
 
+  // every method is turned into a CFG once, however many participants try it
+  CFGCache cfgCache{Context};
+  // and has its channel uses indexed once
+  ChannelAccessIndex accessIndex{CASTmap->getChannels()};
+  ChannelCallGraph callGraph{Context, accessIndex};
+
   for (const auto &[participantName, projections] : *projectionMap) {
+    const auto start = std::chrono::steady_clock::now();
+    ParticipantResult result{participantName.toString(), false, "", {}, {},
+                             {}, std::chrono::microseconds{0}};
 
     const auto* record = CASTmap->getMapping<const clang::Decl*>(participantName.name);
     const auto* castRecord = llvm::dyn_cast<clang::CXXRecordDecl>(record);
@@ -67,6 +80,24 @@ bool CASTValidator::validateProjection(
           std::format("Participant {} did not map to a record in the CASTmapping. Instead, mapped to:  {}\n",  participantName.name, record->getDeclKindName()));
     }
 
+    // compiled once and shared by all candidate methods of the participant
+    LocalAutomaton automaton{projections};
+    AutomatonValidator automatonValidator{Context, CASTmap, automaton,
+                                          cfgCache, accessIndex, callGraph};
+
+    // a method can only follow the protocol if it uses a channel the
+    // participant communicates over first
+    std::vector<const clang::FieldDecl *> firstChannels{};
+    for (const auto &transition :
+         automaton.getState(automaton.getInitialState()).transitions) {
+      const auto *channel = llvm::dyn_cast_or_null<clang::FieldDecl>(
+          CASTmap->getMapping<const clang::Decl *>(
+              transition.projection->getChannelName()));
+      if (channel) {
+        firstChannels.push_back(channel);
+      }
+    }
+
     auto methods = std::vector<clang::CXXMethodDecl*>{};
 
     for(auto* method: castRecord->methods() ){
@@ -91,32 +122,43 @@ bool CASTValidator::validateProjection(
         successfullValidations[funcName] = std::vector<std::string>{};
       }
 
-      const clang::Stmt *body = fullDecl->getBody();
-
-      auto elm = body->children();
-      auto itr = elm.begin();
-      auto end = elm.end();
-
-      auto projectionNode = projections.begin();
-      AbstractProjection* nestedFunctionNext = nullptr;
-      
-      bool successFullMapping = projectionNode->validateFunctionDecl(Context, CASTmap, itr, end, nestedFunctionNext);
-
-      if (itr != end) {
-        llvm::errs() << std::format("Warning: Not all statements in {} consumed "
-                                    "by projections. Stopped at: {}\n",
-                                    funcName, itr->getStmtClassName());
-      }
+      const bool candidate =
+          firstChannels.empty() ||
+          std::any_of(firstChannels.begin(), firstChannels.end(),
+                      [&callGraph, fullDecl](const clang::FieldDecl *channel) {
+                        return callGraph.mayUse(fullDecl, channel);
+                      });
+      bool successFullMapping =
+          candidate && automatonValidator.validateFunctionDecl(fullDecl);
 
       if (successFullMapping) {
         //to begin with, we only need one sucessfull mapping for each
         successfullValidations[funcName].push_back(participantName.toString());
+        if (results) {
+          const auto &sourceManager = Context.getSourceManager();
+          result.validated = true;
+          result.method = fullDecl->getQualifiedNameAsString();
+          result.methodLocation = ResultLocation::fromRange(
+              sourceManager, fullDecl->getSourceRange());
+          for (const clang::Stmt *stmt : automatonValidator.getMatches()) {
+            result.matches.push_back(ResultLocation::fromRange(
+                sourceManager, stmt->getSourceRange()));
+          }
+        }
         break;
       } else {
         failedValidations[funcName].push_back(participantName.toString());
+        result.failed.push_back(funcName);
       }
 
     }
+
+    // streamed right away, so results are not held back until the end
+    if (results) {
+      result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+      results->write(result);
+    }
   }
 
   return true;
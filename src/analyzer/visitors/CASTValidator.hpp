@@ -1,17 +1,26 @@
 #pragma once
 
+#include "../../pchor/ast/PchorAutomaton.hpp"
 #include "../../pchor/ast/PchorProjection.hpp"
 #include "../utils/CASTAnalyzerUtils.hpp"
+#include "../utils/CFGCache.hpp"
+#include "../utils/ChannelAccessIndex.hpp"
+#include "../utils/ChannelCallGraph.hpp"
 #include "../utils/ContextManager.hpp"
+#include "../utils/ResultWriter.hpp"
 #include <clang/AST/Decl.h>
 
+#include <cstdio>
+
 namespace PchorAST {
 
 class CASTValidator {
 public:
-  explicit CASTValidator() : successfullValidations(), failedValidations() {}
+  // results, if given, receives the outcome of every participant
+  explicit CASTValidator(ResultWriter *results = nullptr)
+      : results(results), successfullValidations(), failedValidations() {}
 
-  void printValidations();
+  void printValidations(std::FILE *out = stdout) const;
 
   clang::FunctionDecl *validateFuncDecl(
       std::shared_ptr<CASTMapping> CASTMap,
@@ -23,6 +32,7 @@ public:
                           std::shared_ptr<PchorProjection> &projectionMap);
 
 private:
+  ResultWriter *results;
   std::unordered_map<std::string, std::vector<std::string>>
       successfullValidations;
   std::unordered_map<std::string, std::vector<std::string>> failedValidations;
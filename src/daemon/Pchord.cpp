@@ -0,0 +1,141 @@
+#include "PchordServer.hpp"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+#ifndef PCHOR_CLANG_RESOURCE_DIR
+#define PCHOR_CLANG_RESOURCE_DIR ""
+#endif
+
+/*
+  Usage:
+    pchord --socket=<path> --serve [--resource-dir=<dir>] [--debug]
+    pchord --socket=<path> --cor=<path_to_cor-file> <source> [-- <args>...]
+    pchord --socket=<path> --invalidate <source>
+    pchord --socket=<path> --shutdown
+*/
+
+namespace {
+
+int sendRequest(const std::string &socketPath, const std::string &request) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1 ||
+      connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1) {
+    llvm::errs() << "Error: Could not connect to pchord at " << socketPath
+                 << ": " << strerror(errno) << "\n";
+    return 1;
+  }
+
+  std::string line = request + "\n";
+  size_t written = 0;
+  while (written < line.size()) {
+    ssize_t n = write(fd, line.data() + written, line.size() - written);
+    if (n <= 0) {
+      close(fd);
+      return 1;
+    }
+    written += static_cast<size_t>(n);
+  }
+
+  char buffer[4096];
+  ssize_t n;
+  while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+    llvm::outs().write(buffer, static_cast<size_t>(n));
+  }
+  close(fd);
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string socketPath;
+  std::string corFilePath;
+  std::string resourceDir{PCHOR_CLANG_RESOURCE_DIR};
+  std::string invalidatePath;
+  bool serve = false;
+  bool shutdown = false;
+  bool debug = false;
+  std::vector<std::string> sources{};
+  std::vector<std::string> compilerArgs{};
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    if (arg == "--") {
+      compilerArgs.assign(argv + i + 1, argv + argc);
+      break;
+    }
+    if (arg.starts_with("--socket=")) {
+      socketPath = arg.substr(9);
+    } else if (arg.starts_with("--cor=")) {
+      corFilePath = std::filesystem::absolute(arg.substr(6)).string();
+    } else if (arg.starts_with("--resource-dir=")) {
+      resourceDir = arg.substr(15);
+    } else if (arg == "--serve") {
+      serve = true;
+    } else if (arg == "--shutdown") {
+      shutdown = true;
+    } else if (arg == "--debug") {
+      debug = true;
+    } else if (arg == "--invalidate" && i + 1 < argc) {
+      invalidatePath = argv[++i];
+    } else {
+      sources.push_back(std::filesystem::absolute(arg).string());
+    }
+  }
+
+  if (socketPath.empty()) {
+    llvm::errs() << "Error: No socket specified. Use --socket=<path>\n";
+    return 1;
+  }
+
+  if (serve) {
+    try {
+      PchorAST::PchordServer server{socketPath, resourceDir, debug};
+      server.serve();
+    } catch (const std::exception &e) {
+      llvm::errs() << "pchord: " << e.what() << "\n";
+      return 1;
+    }
+    return 0;
+  }
+
+  if (shutdown) {
+    return sendRequest(socketPath, "shutdown");
+  }
+  std::string cwd = std::filesystem::current_path().string();
+  if (!invalidatePath.empty()) {
+    return sendRequest(socketPath,
+                       std::format("invalidate\t{}\t{}", cwd, invalidatePath));
+  }
+
+  if (corFilePath.empty() || sources.empty()) {
+    llvm::errs() << "Error: check requests need --cor=<path_to_file> and at "
+                    "least one source file\n";
+    return 1;
+  }
+
+  int status = 0;
+  for (const auto &source : sources) {
+    std::string request =
+        std::format("check\t{}\t{}\t{}", cwd, corFilePath, source);
+    for (const auto &arg : compilerArgs) {
+      request += "\t" + arg;
+    }
+    status |= sendRequest(socketPath, request);
+  }
+  return status;
+}
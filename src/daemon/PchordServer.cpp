@@ -0,0 +1,383 @@
+#include "PchordServer.hpp"
+#include "../analyzer/PchorAnalysis.hpp"
+
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Basic/SourceManager.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <print>
+#include <stdexcept>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace PchorAST {
+
+static std::filesystem::file_time_type lastWriteTime(const std::string &path) {
+  std::error_code ec;
+  auto time = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    // a missing file always counts as changed
+    return std::filesystem::file_time_type::min();
+  }
+  return time;
+}
+
+// compiler arguments naming a file or directory, given joined or separate.
+// -include-pch comes before -include, which is a prefix of it
+static constexpr std::array<std::string_view, 10> pathFlags = {
+    "-I",        "-F",          "-isystem", "-iquote",  "-idirafter",
+    "-isysroot", "-include-pch", "-include", "-imacros", "--sysroot="};
+
+static void writeAll(int fd, const std::string &data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    written += static_cast<size_t>(n);
+  }
+}
+
+PchordServer::~PchordServer() {
+  if (listenFd != -1) {
+    close(listenFd);
+    unlink(socketPath.c_str());
+  }
+}
+
+std::vector<std::string>
+PchordServer::splitRequest(const std::string &request) {
+  std::vector<std::string> fields{};
+  size_t begin = 0;
+  while (begin <= request.size()) {
+    size_t tab = request.find('\t', begin);
+    if (tab == std::string::npos) {
+      fields.emplace_back(request.substr(begin));
+      break;
+    }
+    fields.emplace_back(request.substr(begin, tab - begin));
+    begin = tab + 1;
+  }
+  return fields;
+}
+
+std::string PchordServer::resolvePath(const std::filesystem::path &cwd,
+                                      const std::string &path) {
+  std::filesystem::path resolved{path};
+  if (resolved.is_relative()) {
+    resolved = cwd / resolved;
+  }
+  return std::filesystem::weakly_canonical(resolved).string();
+}
+
+std::vector<std::string>
+PchordServer::resolveArgs(const std::filesystem::path &cwd,
+                          const std::vector<std::string> &args) {
+  std::vector<std::string> resolved{};
+  for (size_t i = 0; i < args.size(); ++i) {
+    const std::string &arg = args[i];
+    bool isPath = false;
+    for (std::string_view flag : pathFlags) {
+      if (arg == flag && !flag.ends_with('=') && i + 1 < args.size()) {
+        resolved.push_back(arg);
+        resolved.push_back(resolvePath(cwd, args[++i]));
+        isPath = true;
+        break;
+      }
+      if (arg.size() > flag.size() && arg.starts_with(flag)) {
+        resolved.push_back(std::format(
+            "{}{}", flag, resolvePath(cwd, arg.substr(flag.size()))));
+        isPath = true;
+        break;
+      }
+    }
+    if (!isPath) {
+      resolved.push_back(arg);
+    }
+  }
+  // any other relative path is looked up from the client's directory as well
+  resolved.push_back(std::format("-working-directory={}", cwd.string()));
+  return resolved;
+}
+
+void PchordServer::serve() {
+  std::signal(SIGPIPE, SIG_IGN);
+
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(addr.sun_path)) {
+    throw std::runtime_error(
+        std::format("Socket path {} is too long", socketPath));
+  }
+  std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+  listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd == -1) {
+    throw std::runtime_error(
+        std::format("Failed to create socket: {}", strerror(errno)));
+  }
+  unlink(socketPath.c_str());
+  if (bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == -1 ||
+      listen(listenFd, 16) == -1) {
+    throw std::runtime_error(std::format("Failed to listen on {}: {}",
+                                         socketPath, strerror(errno)));
+  }
+  llvm::outs() << "pchord listening on " << socketPath << "\n";
+  llvm::outs().flush();
+
+  bool shutdown = false;
+  while (!shutdown) {
+    int clientFd = accept(listenFd, nullptr, nullptr);
+    if (clientFd == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(
+          std::format("Failed to accept connection: {}", strerror(errno)));
+    }
+
+    std::string request{};
+    char buffer[4096];
+    while (request.find('\n') == std::string::npos) {
+      ssize_t n = read(clientFd, buffer, sizeof(buffer));
+      if (n <= 0) {
+        break;
+      }
+      request.append(buffer, static_cast<size_t>(n));
+    }
+    if (auto newline = request.find('\n'); newline != std::string::npos) {
+      request.resize(newline);
+    }
+
+    std::string response;
+    try {
+      response = handleRequest(request, shutdown);
+    } catch (const std::exception &e) {
+      response = std::format("pchord: error: {}\n", e.what());
+    }
+    writeAll(clientFd, response);
+    close(clientFd);
+  }
+}
+
+std::string PchordServer::handleRequest(const std::string &request,
+                                        bool &shutdown) {
+  auto fields = splitRequest(request);
+
+  if (fields[0] == "shutdown") {
+    shutdown = true;
+    return "pchord: shutting down\n";
+  }
+  // relative paths are the client's, the daemon's own directory is not used
+  auto workingDirectory = [&fields]() {
+    const std::filesystem::path cwd{fields[1]};
+    if (!cwd.is_absolute()) {
+      throw std::runtime_error(
+          std::format("{} expects an absolute working directory, got '{}'",
+                      fields[0], fields[1]));
+    }
+    return cwd;
+  };
+
+  if (fields[0] == "invalidate") {
+    if (fields.size() != 3) {
+      throw std::runtime_error(
+          "invalidate expects a working directory and one source file");
+    }
+    const std::string sourcePath = resolvePath(workingDirectory(), fields[2]);
+    std::erase_if(translationUnits, [&sourcePath](const auto &entry) {
+      return entry.first.first == sourcePath;
+    });
+    return std::format("pchord: invalidated {}\n", sourcePath);
+  }
+  if (fields[0] == "check") {
+    if (fields.size() < 4) {
+      throw std::runtime_error(
+          "check expects a working directory, a .cor-file and a source file");
+    }
+    const std::filesystem::path cwd = workingDirectory();
+    return check(resolvePath(cwd, fields[2]), resolvePath(cwd, fields[3]),
+                 resolveArgs(cwd, {fields.begin() + 4, fields.end()}));
+  }
+  throw std::runtime_error(std::format("Unknown request '{}'", fields[0]));
+}
+
+std::shared_ptr<SymbolTable>
+PchordServer::getChoreography(const std::string &corFilePath, bool &changed) {
+  auto mtime = lastWriteTime(corFilePath);
+  auto it = choreographies.find(corFilePath);
+  if (it != choreographies.end() && it->second.mtime == mtime) {
+    changed = false;
+    return it->second.sTable;
+  }
+
+  changed = true;
+  auto &cached = choreographies[corFilePath];
+  if (cached.parser) {
+    cached.parser->reparse();
+  } else {
+    cached.parser = std::make_unique<PchorParser>(corFilePath);
+    cached.parser->genTokens();
+    cached.parser->parse();
+  }
+  if (debug) {
+    cached.parser->printAST();
+  }
+  cached.sTable = cached.parser->getChorAST();
+  cached.mtime = mtime;
+  return cached.sTable;
+}
+
+bool PchordServer::isUpToDate(const CachedTranslationUnit &cached) const {
+  if (!cached.unit) {
+    return false;
+  }
+  for (const auto &[path, mtime] : cached.dependencies) {
+    if (lastWriteTime(path) != mtime) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void PchordServer::collectDependencies(CachedTranslationUnit &cached) {
+  cached.dependencies.clear();
+  const clang::SourceManager &SM = cached.unit->getSourceManager();
+  for (auto it = SM.fileinfo_begin(); it != SM.fileinfo_end(); ++it) {
+    if (auto entry = it->second->OrigEntry) {
+      std::string path = entry->getName().str();
+      cached.dependencies.insert_or_assign(path, lastWriteTime(path));
+    }
+  }
+}
+
+void PchordServer::parseTranslationUnit(CachedTranslationUnit &cached,
+                                        const std::string &sourcePath,
+                                        std::FILE *out) {
+  if (cached.unit) {
+    // the precompiled preamble is reused as long as the headers are unchanged
+    if (cached.unit->Reparse(pchContainerOps)) {
+      cached.unit.reset();
+      throw std::runtime_error(
+          std::format("Failed to reparse translation unit {}", sourcePath));
+    }
+  } else {
+    std::vector<const char *> argv{"clang++"};
+    for (const auto &arg : cached.args) {
+      argv.push_back(arg.c_str());
+    }
+    argv.push_back(sourcePath.c_str());
+
+    // diagnostics are stored by the ASTUnit and reported with the request
+    auto diags = clang::CompilerInstance::createDiagnostics(
+        new clang::DiagnosticOptions(), new clang::IgnoringDiagConsumer());
+    cached.unit = clang::ASTUnit::LoadFromCommandLine(
+        argv.data(), argv.data() + argv.size(), pchContainerOps, diags,
+        resourceDir, /*StorePreamblesInMemory=*/true,
+        /*PreambleStoragePath=*/"", /*OnlyLocalDecls=*/false,
+        clang::CaptureDiagsKind::All, /*RemappedFiles=*/{},
+        /*RemappedFilesKeepOriginalName=*/true,
+        /*PrecompilePreambleAfterNParses=*/1);
+    if (!cached.unit) {
+      throw std::runtime_error(
+          std::format("Failed to parse translation unit {}", sourcePath));
+    }
+  }
+  for (auto diag = cached.unit->stored_diag_begin();
+       diag != cached.unit->stored_diag_end(); ++diag) {
+    if (diag->getLevel() < clang::DiagnosticsEngine::Warning) {
+      continue;
+    }
+    const clang::FullSourceLoc &loc = diag->getLocation();
+    std::println(out, "{}{}: {}",
+                 loc.isValid() ? loc.printToString(loc.getManager()) + ": "
+                               : std::string{},
+                 diag->getLevel() >= clang::DiagnosticsEngine::Error
+                     ? "error"
+                     : "warning",
+                 diag->getMessage().str());
+  }
+  if (cached.unit->getDiagnostics().hasErrorOccurred()) {
+    std::println(out,
+                 "Warning: {} has compilation errors. Validation may be "
+                 "incomplete",
+                 sourcePath);
+  }
+  collectDependencies(cached);
+  cached.dependencies.insert_or_assign(sourcePath, lastWriteTime(sourcePath));
+}
+
+std::string PchordServer::check(const std::string &corFilePath,
+                                const std::string &sourcePath,
+                                const std::vector<std::string> &args) {
+  bool corChanged = false;
+  auto sTable = getChoreography(corFilePath, corChanged);
+
+  // different compiler flags need a preamble of their own
+  auto &cached = translationUnits[{sourcePath, args}];
+  cached.args = args;
+
+  bool unitChanged = !isUpToDate(cached);
+  if (!unitChanged && cached.resultValid && cached.corFilePath == corFilePath &&
+      cached.corMtime == choreographies.at(corFilePath).mtime) {
+    return cached.result + "pchord: cached\n";
+  }
+
+  cached.resultValid = false;
+  std::string output = captureOutput([&](std::FILE *out) {
+    if (unitChanged) {
+      parseTranslationUnit(cached, sourcePath, out);
+    }
+    runChoreographyAnalysis(cached.unit->getASTContext(), sTable, debug,
+                            false, "", {}, "", "", "", "", false, false,
+                            out);
+  });
+
+  cached.corFilePath = corFilePath;
+  cached.corMtime = choreographies.at(corFilePath).mtime;
+  cached.result = std::move(output);
+  cached.resultValid = true;
+
+  return cached.result +
+         std::format("pchord: validated ({}{})\n",
+                     unitChanged ? "reparsed translation unit" : "reused AST",
+                     corChanged ? ", reparsed choreography" : "");
+}
+
+std::string
+PchordServer::captureOutput(const std::function<void(std::FILE *)> &analysis) {
+  char *buffer = nullptr;
+  size_t size = 0;
+  std::FILE *out = open_memstream(&buffer, &size);
+  if (!out) {
+    throw std::runtime_error(std::format(
+        "Failed to create output stream for request: {}", strerror(errno)));
+  }
+
+  try {
+    analysis(out);
+  } catch (const std::exception &e) {
+    std::println(out, "pchord: error: {}", e.what());
+  }
+  std::fclose(out);
+
+  std::string output{buffer, size};
+  std::free(buffer);
+  return output;
+}
+
+} // namespace PchorAST
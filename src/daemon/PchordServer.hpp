@@ -0,0 +1,118 @@
+#pragma once
+
+#include <clang/Frontend/ASTUnit.h>
+#include <clang/Serialization/PCHContainerOperations.h>
+
+#include "../pchor/parser/PchorParser.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PchorAST {
+
+/*
+  pchord keeps the expensive parts of a validation run alive between requests:
+  parsed choreographies, clang ASTUnits with a precompiled preamble for the
+  headers of a translation unit, and the output of the last analysis of each
+  translation unit. A check request only reparses what changed on disk.
+
+  Requests are single lines of tab separated fields sent over a Unix socket:
+    check <cwd> <cor-file> <source-file> [<compiler arg>...]
+    invalidate <cwd> <source-file>
+    shutdown
+  The connection is closed once the response has been written.
+
+  The working directory of a request must be absolute. The daemon never
+  changes its own: the files and the path arguments of the compiler (-I,
+  -isystem, -include, ...) are resolved against the working directory of the
+  request, which clang is also given as -working-directory. Caches are keyed
+  on the canonical paths, and translation units on their resolved arguments
+  as well.
+  The report of a request is written to a stream of its own, so only debug
+  dumps reach the output of the daemon.
+*/
+
+struct CachedChoreography {
+  // kept alive so edits are parsed incrementally through PchorParser::reparse
+  std::unique_ptr<PchorParser> parser;
+  std::shared_ptr<SymbolTable> sTable;
+  std::filesystem::file_time_type mtime;
+};
+
+struct CachedTranslationUnit {
+  std::unique_ptr<clang::ASTUnit> unit;
+  std::vector<std::string> args;
+  // files seen by the last parse, used to decide whether a reparse is needed
+  std::unordered_map<std::string, std::filesystem::file_time_type> dependencies;
+
+  std::string corFilePath;
+  std::filesystem::file_time_type corMtime;
+  std::string result;
+  bool resultValid = false;
+};
+
+class PchordServer {
+public:
+  explicit PchordServer(const std::string &socketPath,
+                        const std::string &resourceDir, bool debug)
+      : socketPath(socketPath), resourceDir(resourceDir), debug(debug),
+        listenFd(-1),
+        pchContainerOps(std::make_shared<clang::PCHContainerOperations>()),
+        choreographies(), translationUnits() {}
+  ~PchordServer();
+
+  PchordServer(const PchordServer &other) = delete;
+  PchordServer &operator=(const PchordServer &other) = delete;
+
+  // Blocks and serves requests until a shutdown request is received
+  void serve();
+
+  static std::vector<std::string> splitRequest(const std::string &request);
+  // Canonical form of path, taken relative to cwd
+  static std::string resolvePath(const std::filesystem::path &cwd,
+                                 const std::string &path);
+  // Compiler arguments with every path made absolute against cwd
+  static std::vector<std::string>
+  resolveArgs(const std::filesystem::path &cwd,
+              const std::vector<std::string> &args);
+
+private:
+  std::string socketPath;
+  std::string resourceDir;
+  bool debug;
+  int listenFd;
+
+  std::shared_ptr<clang::PCHContainerOperations> pchContainerOps;
+  std::unordered_map<std::string, CachedChoreography> choreographies;
+  // keyed by source file and compiler arguments
+  std::map<std::pair<std::string, std::vector<std::string>>,
+           CachedTranslationUnit>
+      translationUnits;
+
+  std::string handleRequest(const std::string &request, bool &shutdown);
+
+  std::string check(const std::string &corFilePath,
+                    const std::string &sourcePath,
+                    const std::vector<std::string> &args);
+
+  std::shared_ptr<SymbolTable> getChoreography(const std::string &corFilePath,
+                                               bool &changed);
+
+  bool isUpToDate(const CachedTranslationUnit &cached) const;
+  void parseTranslationUnit(CachedTranslationUnit &cached,
+                            const std::string &sourcePath, std::FILE *out);
+  static void collectDependencies(CachedTranslationUnit &cached);
+
+  // Runs analysis on a stream of its own, whose contents are returned
+  static std::string
+  captureOutput(const std::function<void(std::FILE *)> &analysis);
+};
+
+} // namespace PchorAST
@@ -33,6 +33,10 @@ void CommunicationExpr::accept(AbstractPchorASTVisitor &visitor) const {
   visitor.visit(*this);
 }
 
+void SelectionExpr::accept(AbstractPchorASTVisitor &visitor) const {
+  visitor.visit(*this);
+}
+
 void ExprList::accept(AbstractPchorASTVisitor &visitor) const {
   visitor.visit(*this);
 }
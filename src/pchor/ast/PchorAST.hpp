@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
 #include <limits>
 #include <memory> // For std::shared_ptr
+#include <optional>
 #include <print>
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../parser/PchorTokenizer.hpp"
@@ -15,8 +18,6 @@ namespace PchorAST {
 
 class AbstractPchorASTVisitor; // forward declaration of class
 
-struct Token;
-
 // Forward declaration of AbstractPchorASTVisitor
 class ExprPchorASTNode;
 class ExprList;
@@ -50,6 +51,12 @@ enum class ArithmeticExpr : uint8_t {
   Subtraction
 };
 
+// coefficient * variable + constant
+struct AffineIndex {
+  int64_t coefficient;
+  int64_t constant;
+};
+
 struct BaseArithmeticExpr {
   ArithmeticExpr exprType;
   BaseArithmeticExpr(ArithmeticExpr exprType): exprType(exprType) {}
@@ -59,6 +66,13 @@ struct BaseArithmeticExpr {
   virtual std::string toString() const = 0;
   virtual void print() const = 0;
   virtual size_t eval(std::unordered_map<std::string, size_t>& ctx) const = 0;
+  // The expression as an affine function of variable, with every other
+  // identifier taken from ctx. nullopt if ctx does not bind one of them
+  virtual std::optional<AffineIndex>
+  affine(const std::string &variable,
+         const std::unordered_map<std::string, size_t> &ctx) const = 0;  // Adds every identifier the expression reads to into
+  virtual void
+  collectIdentifiers(std::unordered_set<std::string> &into) const = 0;
 };
 
 struct LiteralExpr : public BaseArithmeticExpr {
@@ -73,6 +87,14 @@ struct LiteralExpr : public BaseArithmeticExpr {
     std::println("{}", this->toString());
   }
   size_t eval([[maybe_unused]] std::unordered_map<std::string, size_t>& ctx) const override { return value; }
+  std::optional<AffineIndex>
+  affine([[maybe_unused]] const std::string &variable,
+         [[maybe_unused]] const std::unordered_map<std::string, size_t> &ctx)
+      const override {
+    return AffineIndex{0, static_cast<int64_t>(value)};
+  }
+  void collectIdentifiers(
+      [[maybe_unused]] std::unordered_set<std::string> &into) const override {}
 };
 
 struct IdentifierExpr: public BaseArithmeticExpr {
@@ -89,6 +111,21 @@ struct IdentifierExpr: public BaseArithmeticExpr {
     }
     return ctx.at(this->name);
   }
+  std::optional<AffineIndex>
+  affine(const std::string &variable,
+         const std::unordered_map<std::string, size_t> &ctx) const override {
+    if (this->name == variable) {
+      return AffineIndex{1, 0};
+    }
+    auto it = ctx.find(this->name);
+    if (it == ctx.end()) {
+      return std::nullopt;
+    }
+    return AffineIndex{0, static_cast<int64_t>(it->second)};
+  }
+  void collectIdentifiers(std::unordered_set<std::string> &into) const override {
+    into.insert(this->name);
+  }
 
 };
 
@@ -101,7 +138,10 @@ struct BaseBinaryOpExpr : public BaseArithmeticExpr {
   std::string toString() const override = 0;
   void print() const override = 0;
   size_t eval(std::unordered_map<std::string, size_t>& ctx) const override = 0;
-  
+  void collectIdentifiers(std::unordered_set<std::string> &into) const override {
+    lhs->collectIdentifiers(into);
+    rhs->collectIdentifiers(into);
+  }
 };
 
 struct AdditionExpr: public BaseBinaryOpExpr {
@@ -124,6 +164,17 @@ struct AdditionExpr: public BaseBinaryOpExpr {
       }
       return lhs->eval(ctx) + rhs->eval(ctx);
     }
+    std::optional<AffineIndex>
+    affine(const std::string &variable,
+           const std::unordered_map<std::string, size_t> &ctx) const override {
+      auto l = lhs->affine(variable, ctx);
+      auto r = rhs->affine(variable, ctx);
+      if (!l || !r) {
+        return std::nullopt;
+      }
+      return AffineIndex{l->coefficient + r->coefficient,
+                         l->constant + r->constant};
+    }
 };
 struct SubstractionExpr: public BaseBinaryOpExpr {
     SubstractionExpr(std::unique_ptr<BaseArithmeticExpr> lhs, std::unique_ptr<BaseArithmeticExpr> rhs): BaseBinaryOpExpr(ArithmeticExpr::Subtraction, std::move(lhs), std::move(rhs)) {}
@@ -144,6 +195,17 @@ struct SubstractionExpr: public BaseBinaryOpExpr {
       }
       return lhs->eval(ctx) - rhs->eval(ctx);
     }
+    std::optional<AffineIndex>
+    affine(const std::string &variable,
+           const std::unordered_map<std::string, size_t> &ctx) const override {
+      auto l = lhs->affine(variable, ctx);
+      auto r = rhs->affine(variable, ctx);
+      if (!l || !r) {
+        return std::nullopt;
+      }
+      return AffineIndex{l->coefficient - r->coefficient,
+                         l->constant - r->constant};
+    }
 };
 
 
@@ -199,11 +261,10 @@ protected:
 
 class IndexASTNode : public DeclPchorASTNode {
 public:
-  explicit IndexASTNode(std::string_view name, Token &lower_token,
-                        Token &upper_token)
+  explicit IndexASTNode(std::string_view name, std::string_view lower,
+                        std::string_view upper)
       : DeclPchorASTNode(Decl::Index_Decl, std::move(name)),
-        lower(parseLiteral(lower_token.value)),
-        upper(parseLiteral(upper_token.value)) {}
+        lower(parseLiteral(lower)), upper(parseLiteral(upper)) {}
 
   explicit IndexASTNode(const std::string &name, size_t lower, size_t upper)
       : DeclPchorASTNode(Decl::Index_Decl, std::move(name)), lower(lower),
@@ -294,6 +355,7 @@ public:
   bool isLabel(const std::string &label) const {
     return labels.contains(label);
   }
+  const std::unordered_set<std::string> &getLabels() const { return labels; }
 
   void accept(AbstractPchorASTVisitor &visitor) const override;
 
@@ -343,6 +405,14 @@ public:
   std::string getName() const { return baseIndex->getName(); }
   bool isExprLiteral() const { return isLiteral; }
   size_t getLiteral(std::unordered_map<std::string, size_t> &ctx) const { return literal->eval(ctx); }
+  std::optional<AffineIndex>
+  getAffine(const std::string &variable,
+            const std::unordered_map<std::string, size_t> &ctx) const {
+    return literal->affine(variable, ctx);
+  }
+  void collectIdentifiers(std::unordered_set<std::string> &into) const {
+    literal->collectIdentifiers(into);
+  }
 
 protected:
   std::shared_ptr<IndexASTNode> baseIndex;
@@ -440,12 +510,19 @@ protected:
 
 class ExprList : public ExprPchorASTNode {
 public:
-  explicit ExprList() : ExprPchorASTNode(Expr::AggregateExpr), exprlist() {}
+  explicit ExprList()
+      : ExprPchorASTNode(Expr::AggregateExpr), exprlist(), globalTypeName() {}
 
   void addExpr(std::shared_ptr<ExprPchorASTNode> expr) {
     exprlist.emplace_back(expr);
   }
 
+  // Set for the body of a named global type, which may be referenced (and
+  // shared) by later global types
+  void setGlobalTypeName(std::string_view name) { globalTypeName = name; }
+  bool isGlobalType() const { return !globalTypeName.empty(); }
+  const std::string &getGlobalTypeName() const { return globalTypeName; }
+
   void print() const override {
     std::println("Expression List of: ");
     for (const std::shared_ptr<ExprPchorASTNode> &expr : exprlist) {
@@ -478,13 +555,62 @@ public:
 
 protected:
   std::vector<std::shared_ptr<ExprPchorASTNode>> exprlist;
+  std::string globalTypeName;
 };
 /*
-Recexpr is defined as a initial state X(index list)
-and substitution for X, which is a Expr-list, which must end with a
-Continuation-Expr
+  Selection of a label from a Label declaration, followed by the expression
+  list of the selected branch:
+  P -> Q: ch<Label>{ l1: <ExprList> l2: <ExprList> ... }
+*/
+class SelectionExpr : public ExprPchorASTNode {
+public:
+  explicit SelectionExpr(
+      std::shared_ptr<ParticipantExpr> sender,
+      std::shared_ptr<ParticipantExpr> reciever,
+      std::shared_ptr<ChannelExpr> channel, std::shared_ptr<LabelASTNode> label,
+      std::vector<std::pair<std::string, std::shared_ptr<ExprList>>> branches)
+      : ExprPchorASTNode(Expr::SelectionExpr), sender(std::move(sender)),
+        reciever(std::move(reciever)), channel(std::move(channel)),
+        label(std::move(label)), branches(std::move(branches)) {}
+
+  void accept(AbstractPchorASTVisitor &visitor) const override;
+
+  void print() const override {
+    std::println("{}", this->toString());
+  }
+
+  virtual std::string toString() const override {
+    std::string str = std::format("Selection Expression:\nSender: {}\nReceiver: {}\nChannel: {}\nLabel: {}\n", sender->toString(), reciever->toString(), channel->toString(), label->getName());
+    for (const auto &[name, body] : branches) {
+      str.append(std::format("Branch {}:\n{}", name, body->toString()));
+    }
+    return str;
+  }
+
+  std::shared_ptr<ParticipantExpr> getSender() const { return sender; }
+  std::shared_ptr<ParticipantExpr> getReciever() const { return reciever; }
+  std::shared_ptr<ChannelExpr> getChannel() const { return channel; }
+  std::shared_ptr<LabelASTNode> getLabel() const { return label; }
+  const std::vector<std::pair<std::string, std::shared_ptr<ExprList>>> &
+  getBranches() const {
+    return branches;
+  }
+
+protected:
+  std::shared_ptr<ParticipantExpr> sender;
+  std::shared_ptr<ParticipantExpr> reciever;
+  std::shared_ptr<ChannelExpr> channel;
+  std::shared_ptr<LabelASTNode> label;
+  // in order of appearance in the .cor-file
+  std::vector<std::pair<std::string, std::shared_ptr<ExprList>>> branches;
+};
+
+/*
+  Recursion over a body of expressions. Paths through the body end either in
+  a continuation of the recursion, which runs the body again, or in 'end',
+  which leaves the recursion and continues after it. Recursions are not
+  parameterised by indices yet, so the index domains are left empty
 */
-//these exist but are not implemented
 class ConExpr : public ExprPchorASTNode {
 public:
   explicit ConExpr(const std::string &recVar,
@@ -494,9 +620,11 @@ public:
 
   void accept(AbstractPchorASTVisitor &visitor) const override;
 
-  void print() const override { std::println("We print recursive expr"); }
-  virtual std::string toString() const override  {
-    return "";
+  const std::string &getRecVar() const { return recVar; }
+
+  void print() const override { std::println("{}", this->toString()); }
+  virtual std::string toString() const override {
+    return std::format("Continue Expression: {}\n", recVar);
   }
 protected:
   std::string recVar;
@@ -513,15 +641,19 @@ public:
 
   void accept(AbstractPchorASTVisitor &visitor) const override;
 
-  void print() const override { std::println("We print recursive expr"); }
-  virtual std::string toString() const  override {
-    return "";
+  const std::string &getRecVar() const { return recVar; }
+  std::shared_ptr<ExprList> getBody() const { return body; }
+
+  void print() const override { std::println("{}", this->toString()); }
+  virtual std::string toString() const override {
+    return std::format("Recursion Expression {}:\n{}", recVar,
+                       body->toString());
   }
+
 protected:
   std::string recVar; // Ie X..
   std::shared_ptr<std::vector<IndexExpr>> indexDomain;
-  std::shared_ptr<ExprList> body; // final element of list must be a
-                                  // continuation
+  std::shared_ptr<ExprList> body;
 };
 
 class IterExpr: public ExprPchorASTNode {
@@ -591,7 +723,11 @@ public:
   explicit GlobalTypeASTNode(std::string_view name,
                              std::shared_ptr<ExprList> expr)
       : DeclPchorASTNode(Decl::Global_Type_Decl, name),
-        expr_ptr(std::move(expr)) {}
+        expr_ptr(std::move(expr)) {
+    if (expr_ptr) {
+      expr_ptr->setGlobalTypeName(name);
+    }
+  }
 
   explicit GlobalTypeASTNode(std::string_view name)
       : DeclPchorASTNode(Decl::Global_Type_Decl, name) {}
@@ -0,0 +1,154 @@
+#include "PchorAutomaton.hpp"
+
+namespace PchorAST {
+
+LocalAutomaton::LocalAutomaton(const ProjectionList &projections)
+    : states(), loopBacks() {
+  size_t initial = addState();
+  size_t finalState = compile(projections, initial, noState);
+  states[finalState].isFinal = true;
+}
+
+bool LocalAutomaton::isChoice(size_t state) const {
+  const auto &transitions = states[state].transitions;
+  return !transitions.empty() &&
+         transitions.front().kind == TransitionKind::Label;
+}
+
+size_t LocalAutomaton::addState() {
+  states.push_back(AutomatonState{{}, false, false});
+  return states.size() - 1;
+}
+
+void LocalAutomaton::addTransition(size_t from, TransitionKind kind,
+                                   const AbstractComProjection *projection,
+                                   const std::string &label, size_t target) {
+  states[from].transitions.push_back(
+      AutomatonTransition{kind, projection, label, target});
+}
+
+size_t LocalAutomaton::compile(const ProjectionList &projections, size_t from,
+                               size_t exit) {
+  size_t current = from;
+  for (auto itr = projections.begin(); itr != projections.end(); ++itr) {
+    if (itr->getType() == ProjectionType::Continue) {
+      // only reached if the list starts with it, which projection rules out
+      break;
+    }
+    // a continuation ends its list, so the projection before it loops back
+    auto nextItr = std::next(itr);
+    const bool continues =
+        nextItr != projections.end() &&
+        nextItr->getType() == ProjectionType::Continue;
+    const bool last = nextItr == projections.end();
+    size_t target = noState;
+    if (continues) {
+      target = loopBacks.at(static_cast<const Pcontinue &>(*nextItr).getRecVar());
+    } else if (last && exit != noState) {
+      target = exit;
+    } else {
+      target = addState();
+    }
+
+    switch (itr->getType()) {
+    case ProjectionType::Send:
+      addTransition(current, TransitionKind::Send,
+                    static_cast<const AbstractComProjection *>(&*itr), "",
+                    target);
+      break;
+    case ProjectionType::Recieve:
+      addTransition(current, TransitionKind::Recieve,
+                    static_cast<const AbstractComProjection *>(&*itr), "",
+                    target);
+      break;
+    case ProjectionType::Select: {
+      const auto *select = static_cast<const Pselect *>(&*itr);
+      for (const auto &[label, branch] : select->getBranches()) {
+        addTransition(current, TransitionKind::Select, select, label,
+                      compileBranch(branch, target));
+      }
+      break;
+    }
+    case ProjectionType::Branch: {
+      const auto *branching = static_cast<const Pbranch *>(&*itr);
+      size_t choice = addState();
+      addTransition(current, TransitionKind::Recieve, branching, "", choice);
+      for (const auto &[label, branch] : branching->getBranches()) {
+        addTransition(choice, TransitionKind::Label, branching, label,
+                      compileBranch(branch, target));
+      }
+      break;
+    }
+    case ProjectionType::Rec: {
+      const auto *rec = static_cast<const Prec *>(&*itr);
+      size_t loopBack = addState();
+      states[loopBack].isLoopBack = true;
+      // referenced global types may reuse the name of an enclosing recursion
+      auto shadowed = loopBacks.extract(rec->getRecVar());
+      loopBacks.insert_or_assign(rec->getRecVar(), loopBack);
+      // paths through the body that do not continue leave the recursion
+      compile(rec->getBody(), current, target);
+      loopBacks.erase(rec->getRecVar());
+      if (!shadowed.empty()) {
+        loopBacks.insert(std::move(shadowed));
+      }
+      // the recursion starts in current, whose transitions all stem from it
+      states[loopBack].transitions = states[current].transitions;
+      break;
+    }
+    case ProjectionType::Continue:
+      break;
+    }
+    current = target;
+  }
+  return current;
+}
+
+size_t LocalAutomaton::compileBranch(const ProjectionList &branch,
+                                     size_t exit) {
+  // empty branches continue directly after the choice
+  if (branch.empty()) {
+    return exit;
+  }
+  if (branch.begin()->getType() == ProjectionType::Continue) {
+    return loopBacks.at(
+        static_cast<const Pcontinue &>(*branch.begin()).getRecVar());
+  }
+  size_t entry = addState();
+  compile(branch, entry, exit);
+  return entry;
+}
+
+std::string LocalAutomaton::toString() const {
+  std::string str{};
+  for (size_t state = 0; state < states.size(); ++state) {
+    str.append(std::format("q{}{}{}:", state, states[state].isFinal ? "*" : "",
+                           states[state].isLoopBack ? "'" : ""));
+    for (const auto &transition : states[state].transitions) {
+      std::string action =
+          std::format("{}[{}]", transition.projection->getChannelName(),
+                      transition.projection->getChannelIndex());
+      switch (transition.kind) {
+      case TransitionKind::Send:
+        action = std::format("!{}<{}>", action,
+                             transition.projection->getTypeName());
+        break;
+      case TransitionKind::Recieve:
+        action = std::format("?{}<{}>", action,
+                             transition.projection->getTypeName());
+        break;
+      case TransitionKind::Select:
+        action = std::format("!{}<{}>", action, transition.label);
+        break;
+      case TransitionKind::Label:
+        action = std::format("&{}", transition.label);
+        break;
+      }
+      str.append(std::format(" {} -> q{}", action, transition.target));
+    }
+    str.append("\n");
+  }
+  return str;
+}
+
+} // namespace PchorAST
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PchorProjection.hpp"
+
+namespace PchorAST {
+
+/*
+  Deterministic automaton of a participant's local type. Communications are
+  transitions between consecutive states. A selection has one transition per
+  label out of the selecting state, while a branching receives the label into
+  a choice state, from which the code may continue with any of the labels.
+  The branches of a choice rejoin in the state following it.
+
+  A recursion is compiled once: its continuations are back edges into a
+  loop-back state, a copy of the state the recursion starts in. Reaching it
+  means one full round of the recursion has been taken, which lets the
+  validator tell loops that progress through the protocol from loops that
+  are stuck. The automaton stays proportional to the text of the protocol
+  rather than to the number of rounds taken.
+*/
+enum class TransitionKind : uint8_t {
+  Send,    // !ch<T>
+  Recieve, // ?ch<T>, including the receive of a label
+  Select,  // !ch<Label> of one specific label
+  Label    // continuation of a received label
+};
+
+struct AutomatonTransition {
+  TransitionKind kind;
+  // communication of the transition. Label transitions refer to the Pbranch
+  // that received the label
+  const AbstractComProjection *projection;
+  std::string label;
+  size_t target;
+};
+
+struct AutomatonState {
+  std::vector<AutomatonTransition> transitions;
+  bool isFinal;
+  bool isLoopBack;
+};
+
+class LocalAutomaton {
+public:
+  static constexpr size_t noState = std::numeric_limits<size_t>::max();
+
+  explicit LocalAutomaton(const ProjectionList &projections);
+
+  LocalAutomaton(const LocalAutomaton &other) = delete;
+  LocalAutomaton &operator=(const LocalAutomaton &other) = delete;
+
+  size_t getInitialState() const { return 0; }
+  const AutomatonState &getState(size_t state) const { return states[state]; }
+  bool isFinal(size_t state) const { return states[state].isFinal; }
+  // reached by continuing a recursion
+  bool isLoopBack(size_t state) const { return states[state].isLoopBack; }
+  // the choice state left by a received label, which only has Label transitions
+  bool isChoice(size_t state) const;
+  size_t size() const { return states.size(); }
+
+  std::string toString() const;
+
+private:
+  std::vector<AutomatonState> states;
+  // loop-back state of every recursion variable while compiling
+  std::unordered_map<std::string, size_t> loopBacks;
+
+  size_t addState();
+  void addTransition(size_t from, TransitionKind kind,
+                     const AbstractComProjection *projection,
+                     const std::string &label, size_t target);
+
+  // Compiles non-empty projections starting in state from. The last
+  // projection ends in exit, or in a fresh state if exit is noState. Returns
+  // the state reached after the last projection
+  size_t compile(const ProjectionList &projections, size_t from, size_t exit);
+  // Compiles a branch ending in exit and returns the state it starts in
+  size_t compileBranch(const ProjectionList &branch, size_t exit);
+};
+
+} // namespace PchorAST
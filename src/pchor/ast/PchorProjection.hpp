@@ -7,17 +7,21 @@
 #include <unordered_set>
 #include <memory>
 #include <iterator>
-
-#include <clang/AST/ASTContext.h>
-#include <clang/AST/Stmt.h>
-#include <clang/AST/StmtIterator.h>
+#include <utility>
+#include <vector>
 
 namespace PchorAST {
 
-class CASTMapping;
 class ProjectionList;
 
-enum class ProjectionType : uint8_t { Send, Recieve };
+enum class ProjectionType : uint8_t {
+  Send,
+  Recieve,
+  Select,
+  Branch,
+  Rec,
+  Continue
+};
 
 class AbstractProjection {
 public:
@@ -31,20 +35,10 @@ public:
   virtual std::string getChannelName() const = 0;
   virtual size_t getChannelIndex() const = 0;
 
-  ProjectionType getType() { return type; }
-
-  virtual bool
-  validateFunctionDecl(clang::ASTContext &context,
-                       std::shared_ptr<PchorAST::CASTMapping> &CASTmap,
-                       clang::Stmt::const_child_iterator &itr,
-                       clang::Stmt::const_child_iterator &end,
-                       AbstractProjection*& parentScopeProjectionPtr) = 0;
+  ProjectionType getType() const { return type; }
 
 protected:
   ProjectionType type;
-  std::unique_ptr<AbstractProjection> next;
-
-  friend class ProjectionList;
 };
 
 class AbstractComProjection : public AbstractProjection {
@@ -61,12 +55,6 @@ public:
   std::string getTypeName() const override { return typeName; }
   std::string getChannelName() const override { return channelName; }
   size_t getChannelIndex() const override { return channelIndex; }
-  virtual bool
-  validateFunctionDecl(clang::ASTContext &context,
-                       std::shared_ptr<PchorAST::CASTMapping> &CASTmap,
-                       clang::Stmt::const_child_iterator &itr,
-                       clang::Stmt::const_child_iterator &end,
-                       AbstractProjection*& parentScopeProjectionPtr) override = 0;
 
 protected:
   std::string channelName;
@@ -90,12 +78,6 @@ public:
                this->typeName);
   }
 
-  bool validateFunctionDecl(clang::ASTContext &context,
-                            std::shared_ptr<PchorAST::CASTMapping> &CASTmap,
-                            clang::Stmt::const_child_iterator &itr,
-                            clang::Stmt::const_child_iterator &end,
-                            AbstractProjection*& parentScopeProjectionPtr) override;
-
 private:
 };
 
@@ -117,125 +99,196 @@ public:
                this->typeName);
   }
 
-  bool validateFunctionDecl(clang::ASTContext &context,
-                            std::shared_ptr<PchorAST::CASTMapping> &CASTmap,
-                            clang::Stmt::const_child_iterator &itr,
-                            clang::Stmt::const_child_iterator &end,
-                            AbstractProjection*& parentScopeProjectionPtr) override;
-
 private:
 };
 
 
+/*
+  Local type of a participant. Projections are immutable once appended, so a
+  list holds them by shared pointer: appending another list, as at every
+  reference to a memoized global type, shares its projections (and with them
+  their branches and bodies) instead of copying them
+*/
 class ProjectionList {
 public:
-  ProjectionList(): head(nullptr), tail(nullptr) {}
+  ProjectionList() : projections() {}
   ~ProjectionList() = default;
-  
-  ProjectionList(const ProjectionList& other) = delete;
-  ProjectionList& operator=(const ProjectionList& other) = delete;
-  
-  ProjectionList(ProjectionList&& other) noexcept
-      : head(std::move(other.head)), tail(other.tail) {
-      other.tail = nullptr;
-  }
 
-  ProjectionList& operator=(ProjectionList&& other) noexcept {
-      if (this != &other) {
-          head = std::move(other.head);
-          tail = other.tail;
-          other.tail = nullptr;
-      }
-      return *this;
-  }
+  ProjectionList(const ProjectionList &other) = delete;
+  ProjectionList &operator=(const ProjectionList &other) = delete;
+
+  ProjectionList(ProjectionList &&other) noexcept = default;
+  ProjectionList &operator=(ProjectionList &&other) noexcept = default;
 
   class Iterator {
   public:
     using difference_type = std::ptrdiff_t;
     using value_type = AbstractProjection;
+    using Base =
+        std::vector<std::shared_ptr<const AbstractProjection>>::const_iterator;
 
-    Iterator() : current(nullptr) {}
-    Iterator(AbstractProjection* ptr) : current(ptr) {}
-
-    //implement copy constructiona/assignment
-
-    Iterator(const Iterator& other) : current(other.current) {}
-
-    Iterator& operator=(const Iterator& other) {
-      if(this != &other){
-        current = other.current;
-      }
-      return *this;
-    }
-    Iterator(Iterator&& other) noexcept {
-      current = std::move(other.current);
-      other.current = nullptr;
-    }
-
-    Iterator& operator=(Iterator&& other) noexcept {
-      if(this != &other){
-        current = std::move(other.current);
-        other.current = nullptr;
-      }
-      return *this;
-    }
+    Iterator() : current() {}
+    explicit Iterator(Base current) : current(current) {}
 
-    Iterator& operator++() {
-      if(current) {
-        current = current->next.get();
-      }
+    Iterator &operator++() {
+      ++current;
       return *this;
     }
-    Iterator operator++(int)
-    {
-        auto tmp = *this;
-        ++*this;
-        return tmp;
-    }
-    AbstractProjection& operator*() const {
-      return *current;
-    }
-    AbstractProjection* operator->() const {
-      return current;
+    Iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
     }
+    const AbstractProjection &operator*() const { return **current; }
+    const AbstractProjection *operator->() const { return current->get(); }
 
-    bool operator!=(const Iterator& other) const {
+    bool operator!=(const Iterator &other) const {
       return current != other.current;
     }
-    bool operator==(const Iterator& other) const {
+    bool operator==(const Iterator &other) const {
       return current == other.current;
     }
-  
+
   private:
-    AbstractProjection* current;
+    Base current;
   };
-  
-
-  void appendBack(std::unique_ptr<AbstractProjection> proj){
-      if(!head) {
-        head = std::move(proj);
-        tail = head.get();
-      }
-      else {
-        tail->next = std::move(proj);
-        tail = tail->next.get();
-      }
+
+  void appendBack(std::unique_ptr<AbstractProjection> proj) {
+    projections.push_back(std::move(proj));
+  }
+
+  // Appends the projections of other, in order, shared with other
+  void append(const ProjectionList &other) {
+    projections.insert(projections.end(), other.projections.begin(),
+                       other.projections.end());
+  }
+
+  std::string toString() const {
+    std::string str{};
+    for (const auto &proj : *this) {
+      str.append(proj.toString());
+    }
+    return str;
   }
 
-  bool empty() const { return head == nullptr; }
+  bool empty() const { return projections.empty(); }
 
-  Iterator begin() { return Iterator(head.get()); }
-  Iterator end() { return Iterator(nullptr); }
-  Iterator begin() const { return Iterator(head.get()); }
-  Iterator end() const { return Iterator(nullptr); }
-  AbstractProjection* front() {return head.get(); }
-  AbstractProjection* back() { return tail; }
+  Iterator begin() const { return Iterator(projections.begin()); }
+  Iterator end() const { return Iterator(projections.end()); }
+  const AbstractProjection *front() const {
+    return empty() ? nullptr : projections.front().get();
+  }
+  const AbstractProjection *back() const {
+    return empty() ? nullptr : projections.back().get();
+  }
 
 private:
-  std::unique_ptr<AbstractProjection> head;
-  AbstractProjection* tail;
+  std::vector<std::shared_ptr<const AbstractProjection>> projections;
 };
 
 static_assert(std::forward_iterator<ProjectionList::Iterator>);
+
+/*
+  Projection of a selection. The label type is the name of the Label
+  declaration, and every branch holds the projection of the expression list
+  following its label
+*/
+class AbstractChoiceProjection : public AbstractComProjection {
+public:
+  AbstractChoiceProjection(ProjectionType type, const std::string &channelName,
+                           const std::string &labelName,
+                           std::size_t channelIndex)
+      : AbstractComProjection(type, channelName, labelName, channelIndex),
+        branches() {}
+
+  void addBranch(const std::string &label, ProjectionList projections) {
+    branches.emplace_back(label, std::move(projections));
+  }
+  const std::vector<std::pair<std::string, ProjectionList>> &
+  getBranches() const {
+    return branches;
+  }
+
+  void print() const override { std::print("{}", this->toString()); }
+
+protected:
+  std::vector<std::pair<std::string, ProjectionList>> branches;
+
+  std::string branchesToString() const;
+};
+
+// Internal choice: the participant sends the label of the branch it takes
+class Pselect : public AbstractChoiceProjection {
+public:
+  Pselect(const std::string &channelName, const std::string &labelName,
+          std::size_t channelIndex)
+      : AbstractChoiceProjection(ProjectionType::Select, channelName,
+                                 labelName, channelIndex) {}
+  ~Pselect() = default;
+
+  std::string toString() const override;
+};
+
+// External choice: the participant continues with the branch it receives
+class Pbranch : public AbstractChoiceProjection {
+public:
+  Pbranch(const std::string &channelName, const std::string &labelName,
+          std::size_t channelIndex)
+      : AbstractChoiceProjection(ProjectionType::Branch, channelName,
+                                 labelName, channelIndex) {}
+  ~Pbranch() = default;
+
+  std::string toString() const override;
+};
+/*
+  Projection of a recursion. Paths through the body end either in a Pcontinue
+  of the same recursion, which runs the body again, or fall through to the
+  projections following the recursion
+*/
+class Prec : public AbstractProjection {
+public:
+  Prec(const std::string &recVar, ProjectionList body)
+      : AbstractProjection(ProjectionType::Rec), recVar(recVar),
+        body(std::move(body)) {}
+  ~Prec() = default;
+
+  std::string toString() const override;
+  void print() const override { std::print("{}", this->toString()); }
+
+  bool isComProjection() const override { return false; }
+  std::string getTypeName() const override { return ""; }
+  std::string getChannelName() const override { return ""; }
+  size_t getChannelIndex() const override { return 0; }
+
+  const std::string &getRecVar() const { return recVar; }
+  const ProjectionList &getBody() const { return body; }
+
+private:
+  std::string recVar;
+  ProjectionList body;
+};
+
+// Back edge to the start of the enclosing recursion over recVar
+class Pcontinue : public AbstractProjection {
+public:
+  explicit Pcontinue(const std::string &recVar)
+      : AbstractProjection(ProjectionType::Continue), recVar(recVar) {}
+  ~Pcontinue() = default;
+
+  std::string toString() const override {
+    return std::format("continue {}.", this->recVar);
+  }
+  void print() const override { std::print("{}", this->toString()); }
+
+  bool isComProjection() const override { return false; }
+  std::string getTypeName() const override { return ""; }
+  std::string getChannelName() const override { return ""; }
+  size_t getChannelIndex() const override { return 0; }
+
+  const std::string &getRecVar() const { return recVar; }
+
+private:
+  std::string recVar;
+};
 // expand with further constructs down the line
 } // namespace PchorAST
@@ -1,20 +1,31 @@
 #pragma once
-#include <cctype>
 #include <cerrno>
+#include <cstdint>
 #include <cstring>
 #include <fcntl.h>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
 
 namespace PchorAST {
+/*
+  Read-only mapping of a .cor-file. The contents are left untouched so token
+  offsets can be mapped back to exact lines and columns; comments and
+  whitespace are skipped by the lexer. Offsets are stored in 32 bits, so
+  files are limited to 4GiB.
+*/
 class PchorFileWrapper {
-  std::string buffer;
+  const char *data;
+  size_t size;
 
 public:
-  explicit PchorFileWrapper(const std::string &filePath) {
+  explicit PchorFileWrapper(const std::string &filePath)
+      : data(nullptr), size(0) {
     int fd = open(filePath.c_str(), O_RDONLY);
     if (fd == -1) {
       throw std::runtime_error("Failed to open file: " +
@@ -22,60 +33,41 @@ public:
     }
 
     // Get the file size
-    off_t fileSize = lseek(fd, 0, SEEK_END);
-    if (fileSize == -1) {
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) == -1) {
       close(fd);
       throw std::runtime_error("Failed to determine file size: " +
                                std::string(strerror(errno)));
     }
-    lseek(fd, 0, SEEK_SET); // Reset file descriptor to the beginning
-
-    // Read the entire file into a temporary buffer
-    std::string tempBuffer(fileSize, '\0');
-    ssize_t bytesRead = read(fd, tempBuffer.data(), fileSize);
-    if (bytesRead < 0) {
+    if (static_cast<uint64_t>(fileStat.st_size) >
+        std::numeric_limits<uint32_t>::max()) {
       close(fd);
-      throw std::runtime_error("Failed to read file: " +
-                               std::string(strerror(errno)));
+      throw std::runtime_error("File too large: " + filePath);
     }
-    close(fd);
-
-    // Process the buffer to preserve spaces between tokens and handle comments
-    bool inComment = false;
-    bool lastWasSpace = false;
-    for (size_t i = 0; i < tempBuffer.size(); ++i) {
-      char c = tempBuffer[i];
-
-      if (inComment) {
-        if (c == '\n') {
-          inComment = false;
-          buffer.push_back(c);
-        }
-        continue;
-      }
+    size = static_cast<size_t>(fileStat.st_size);
 
-      if (c == '/' && i + 1 < tempBuffer.size() && tempBuffer[i + 1] == '/') {
-        inComment = true;
-        ++i;
-        continue;
+    // mmap rejects empty mappings, an empty file is just an empty buffer
+    if (size > 0) {
+      void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("Failed to map file: " +
+                                 std::string(strerror(errno)));
       }
+      data = static_cast<const char *>(mapping);
+    }
+    close(fd);
+  }
 
-      if (std::isspace(c)) {
-        if (c == '\n') {
-          buffer.push_back(c);
-          lastWasSpace = false;
-        } else if (!lastWasSpace) {
-          buffer.push_back(' ');
-          lastWasSpace = true;
-        }
-      } else {
-        buffer.push_back(c);
-        lastWasSpace = false;
-      }
+  ~PchorFileWrapper() {
+    if (data != nullptr) {
+      munmap(const_cast<char *>(data), size);
     }
-    buffer.push_back(' ');
   }
 
-  const std::string &getBuffer() const { return buffer; }
+  PchorFileWrapper(const PchorFileWrapper &other) = delete;
+  PchorFileWrapper &operator=(const PchorFileWrapper &other) = delete;
+
+  std::string_view getBuffer() const { return std::string_view(data, size); }
 };
-} // namespace PchorAST
\ No newline at end of file
+} // namespace PchorAST
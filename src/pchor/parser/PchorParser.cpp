@@ -1,4 +1,6 @@
 #include "PchorParser.hpp"
+#include <algorithm>
+#include <cctype>
 #include <string>
 
 namespace PchorAST {
@@ -6,40 +8,32 @@ namespace PchorAST {
 // HelperFunctions
 
 std::vector<Token>::iterator
-PchorParser::findEndofScope(std::vector<Token>::iterator &itr,
-                            const std::vector<Token>::iterator &end) {
-  auto endofScope = itr;
-  endofScope++;
-  while (endofScope != end && endofScope->value != "}") {
-    if (endofScope->value == "{") {
-      endofScope = findEndofScope(endofScope, end);
-    }
-    endofScope++;
-  }
-  if (endofScope == end) {
+PchorParser::findMatchingBracket(std::vector<Token>::iterator &itr,
+                                 const std::vector<Token>::iterator &end) {
+  // lookup in the bracket table the lexer computed alongside the tokens
+  const auto &scopeTable = lexer->getScopeTable();
+  size_t pos = static_cast<size_t>(std::distance(tokens.begin(), itr));
+  size_t match = pos < scopeTable.size() ? scopeTable[pos]
+                                         : PchorLexer::noMatchingScope;
+
+  if (match == PchorLexer::noMatchingScope || match <= pos ||
+      match >= static_cast<size_t>(std::distance(tokens.begin(), end))) {
     throw std::runtime_error(
-        "End of Scope not found. Scope Initiater found at: " + itr->toString());
+        "End of Scope not found. Scope Initiater found at: " + lexer->toString(*itr));
   }
-  return endofScope;
+  return tokens.begin() + match;
 }
 
+std::vector<Token>::iterator
+PchorParser::findEndofScope(std::vector<Token>::iterator &itr,
+                            const std::vector<Token>::iterator &end) {
+  return findMatchingBracket(itr, end);
+}
 
 std::vector<Token>::iterator
 PchorParser::findEndofIterScope(std::vector<Token>::iterator &itr,
                             const std::vector<Token>::iterator &end) {
-  auto endofScope = itr;
-  endofScope++;
-  while (endofScope != end && endofScope->value != ")") {
-    if (endofScope->value == "(") {
-      endofScope = findEndofIterScope(endofScope, end);
-    }
-    endofScope++;
-  }
-  if (endofScope == end) {
-    throw std::runtime_error(
-        "End of Scope not found. Scope Initiater found at: " + itr->toString());
-  }
-  return endofScope;
+  return findMatchingBracket(itr, end);
 }
 // Parsing Tree
 void SymbolTable::addDeclaration(const std::string &name,
@@ -71,53 +65,262 @@ void PchorParser::printTokenList() const {
   std::println("\n\nToken List provided by "
                "PchorLexer\n--------------------------------");
   for (const Token &t : tokens) {
-    std::println("{}", t.toString());
+    std::print("{}", lexer->toString(t));
   }
 }
 
 void PchorParser::genTokens() { tokens = lexer->genTokens(); }
+
+void PchorParser::reparse() {
+  lexer = std::make_unique<PchorLexer>(filePath);
+  symbolTable = std::make_shared<SymbolTable>();
+  genTokens();
+  parse();
+}
+
+std::vector<Token>::iterator
+PchorParser::findEndofDecl(std::vector<Token>::iterator &itr,
+                           const std::vector<Token>::iterator &end) {
+  /*
+    Locates the final token of the declaration starting at itr without
+    parsing it. Returns end if the declaration is malformed, in which case
+    the declaration is simply parsed (and the parser reports the error)
+  */
+  if (itr->type == TokenType::Keyword) {
+    if (lexer->getText(*itr) != "Index" && lexer->getText(*itr) != "Participant" &&
+        lexer->getText(*itr) != "Channel" && lexer->getText(*itr) != "Label") {
+      return end;
+    }
+    auto scope = itr;
+    while (scope != end && scope->type != TokenType::EndOfFile &&
+           lexer->getText(*scope) != "{") {
+      scope++;
+    }
+    if (scope == end || scope->type == TokenType::EndOfFile) {
+      return end;
+    }
+    try {
+      return findEndofScope(scope, end);
+    } catch (const std::runtime_error &) {
+      return end;
+    }
+  }
+
+  if (itr->type == TokenType::Identifier) {
+    auto endofDecl = itr;
+    try {
+      while (endofDecl != end && lexer->getText(*endofDecl) != "end") {
+        if (endofDecl->type == TokenType::Symbol && lexer->getText(*endofDecl) == "{") {
+          endofDecl = findEndofScope(endofDecl, end);
+        }
+        endofDecl++;
+      }
+    } catch (const std::runtime_error &) {
+      return end;
+    }
+    return endofDecl;
+  }
+  return end;
+}
+
+std::string
+PchorParser::getDeclText(std::vector<Token>::iterator itr,
+                         const std::vector<Token>::iterator &declEnd) const {
+  std::string text{};
+  for (; itr != declEnd; ++itr) {
+    text.append(lexer->getText(*itr));
+    text.push_back(' ');
+  }
+  text.append(lexer->getText(*declEnd));
+  return text;
+}
+
+void PchorParser::addDiagnostic(std::vector<Token>::iterator itr,
+                                const std::vector<Token>::iterator &end,
+                                const std::exception &error) {
+  if (itr == end) {
+    // report errors at the end of a scope on its final token
+    --itr;
+  }
+  PchorDiagnostic diagnostic{lexer->getLine(*itr), lexer->getColumn(*itr), "",
+                             "", std::string(lexer->getText(*itr))};
+  if (const auto *syntaxError = dynamic_cast<const PchorSyntaxError *>(&error)) {
+    diagnostic.message = syntaxError->getContext();
+    diagnostic.expected = syntaxError->getExpected();
+  } else {
+    diagnostic.message = error.what();
+    while (!diagnostic.message.empty() &&
+           std::isspace(static_cast<unsigned char>(diagnostic.message.back()))) {
+      diagnostic.message.pop_back();
+    }
+  }
+  diagnostics.push_back(std::move(diagnostic));
+}
+
+void PchorParser::synchronizeDecl(std::vector<Token>::iterator &itr,
+                                  const std::vector<Token>::iterator &declStart,
+                                  const std::vector<Token>::iterator &end) {
+  if (std::distance(itr, end) <= 0) {
+    itr = std::prev(end);
+    return;
+  }
+  if (itr == declStart) {
+    ++itr;
+  }
+  while (itr != end && itr->type != TokenType::EndOfFile) {
+    if (itr->type == TokenType::Keyword &&
+        (lexer->getText(*itr) == "Index" || lexer->getText(*itr) == "Participant" ||
+         lexer->getText(*itr) == "Channel" || lexer->getText(*itr) == "Label")) {
+      return;
+    }
+    auto next = std::next(itr);
+    if (itr->type == TokenType::Identifier && next != end &&
+        next->type == TokenType::Symbol && lexer->getText(*next) == "=") {
+      return;
+    }
+    ++itr;
+  }
+}
+
+void PchorParser::synchronizeExpr(std::vector<Token>::iterator &itr,
+                                  const std::vector<Token>::iterator &end) {
+  if (std::distance(itr, end) <= 0) {
+    itr = end;
+    return;
+  }
+  const auto &scopeTable = lexer->getScopeTable();
+  while (itr != end && lexer->getText(*itr) != ".") {
+    // step over nested bodies, their '.' belong to inner expression lists
+    size_t pos = static_cast<size_t>(std::distance(tokens.begin(), itr));
+    size_t match = scopeTable[pos];
+    if (match != PchorLexer::noMatchingScope && match > pos &&
+        tokens.begin() + match < end) {
+      itr = tokens.begin() + match;
+    }
+    ++itr;
+  }
+}
+
+bool PchorParser::isReusable(const ParsedDecl &decl) const {
+  for (const auto &[name, node] : decl.dependencies) {
+    if (symbolTable->resolve(name) != node) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void PchorParser::parse() {
 
   // create default index for literal 1
-  symbolTable->addDeclaration("PchorUnaryIndex", std::make_shared<IndexASTNode>(
-                                                     "PchorUnaryIndex", 1, 1));
+  if (!unaryIndex) {
+    unaryIndex = std::make_shared<IndexASTNode>("PchorUnaryIndex", 1, 1);
+  }
+  symbolTable->addDeclaration("PchorUnaryIndex", unaryIndex);
 
   auto itr = tokens.begin();
   const auto end = tokens.end();
+
+  std::unordered_map<std::string, ParsedDecl> currentDecls{};
+  reusedDecls = 0;
+  diagnostics.clear();
   /*
       Parsing of outer expressions, where expressions are limited to
      declarations of Indeces, Participants, Channels and Global Types
   */
 
-  while (itr->type != TokenType::EndOfFile && itr != end) {
-    switch (itr->type) {
-    case TokenType::Keyword:
-      if (itr->value == "Index") {
-        parseIndexDecl(itr, end);
-      } else if (itr->value == "Participant") {
-        parseParticipantDecl(itr, end);
-      } else if (itr->value == "Channel") {
-        parseChannelDecl(itr, end);
-      } else if (itr->value == "Label") {
-        parseLabelDecl(itr, end);
-      } else {
-        throw std::runtime_error("Token: " + itr->toString() +
-                                 "cannot be an Outer Expression");
+  while (itr != end && itr->type != TokenType::EndOfFile) {
+    const auto declStart = itr;
+    const size_t previousErrors = diagnostics.size();
+    auto declEnd = findEndofDecl(itr, end);
+    if (declEnd == end) {
+      try {
+        parseDecl(itr, end);
+        ++itr;
+      } catch (const std::exception &e) {
+        addDiagnostic(itr, end, e);
+        synchronizeDecl(itr, declStart, end);
+      }
+      continue;
+    }
+
+    std::string declText = getDeclText(itr, declEnd);
+    auto previous = parsedDecls.find(declText);
+    if (previous != parsedDecls.end() && isReusable(previous->second)) {
+      symbolTable->addDeclaration(previous->second.node->getName(),
+                                  previous->second.node);
+      currentDecls.insert_or_assign(declText, previous->second);
+      reusedDecls++;
+      itr = declEnd;
+      ++itr;
+      continue;
+    }
+
+    ParsedDecl parsed{};
+    for (auto depItr = itr; depItr != declEnd; ++depItr) {
+      if (depItr->type == TokenType::Identifier) {
+        parsed.dependencies.emplace_back(std::string(lexer->getText(*depItr)),
+                                         symbolTable->resolve(lexer->getText(*depItr)));
       }
-      break;
-    case TokenType::Identifier:
-      parseGlobalTypeDecl(itr, end);
-      break;
-    default:
-      throw std::runtime_error(
-          "Token: " + itr->toString() +
-          "cannot be an Outer Expression Keyword or Identifier");
+    }
+
+    try {
+      parseDecl(itr, end);
+    } catch (const std::exception &e) {
+      addDiagnostic(itr, end, e);
+      synchronizeDecl(itr, declStart, end);
+      continue;
+    }
+
+    // declarations containing recovered errors are not reused next time
+    if (itr == declEnd && diagnostics.size() == previousErrors) {
+      parsed.node = *symbolTable->back();
+      currentDecls.insert_or_assign(declText, std::move(parsed));
     }
     ++itr;
   }
+  parsedDecls = std::move(currentDecls);
+
+  if (!diagnostics.empty()) {
+    std::string report = std::format(
+        "Parsing failed with {} error(s):", diagnostics.size());
+    for (const PchorDiagnostic &diagnostic : diagnostics) {
+      report += "\n" + diagnostic.toString();
+    }
+    throw std::runtime_error(report);
+  }
+  if (reusedDecls > 0) {
+    std::println("Reused {} unchanged declarations", reusedDecls);
+  }
   std::println("Succesfully parsed file");
 }
 
+void PchorParser::parseDecl(std::vector<Token>::iterator &itr,
+                            const std::vector<Token>::iterator &end) {
+  switch (itr->type) {
+  case TokenType::Keyword:
+    if (lexer->getText(*itr) == "Index") {
+      parseIndexDecl(itr, end);
+    } else if (lexer->getText(*itr) == "Participant") {
+      parseParticipantDecl(itr, end);
+    } else if (lexer->getText(*itr) == "Channel") {
+      parseChannelDecl(itr, end);
+    } else if (lexer->getText(*itr) == "Label") {
+      parseLabelDecl(itr, end);
+    } else {
+      throw PchorSyntaxError("'Index', 'Participant', 'Channel', 'Label' or a global type Identifier");
+    }
+    break;
+  case TokenType::Identifier:
+    parseGlobalTypeDecl(itr, end);
+    break;
+  default:
+    throw std::runtime_error(
+        "Token: " + lexer->toString(*itr) +
+        "cannot be an Outer Expression Keyword or Identifier");
+  }
+}
+
 void PchorParser::parseIndexDecl(std::vector<Token>::iterator &itr,
                                  const std::vector<Token>::iterator &end) {
   /*
@@ -129,62 +332,55 @@ void PchorParser::parseIndexDecl(std::vector<Token>::iterator &itr,
     throw std::runtime_error(
         "Incomplete Index declaration: not enough tokens remaining.");
   }
-  if (itr->value != "Index") {
-    throw std::runtime_error("Expected 'Index' keyword, but got: " +
-                             itr->toString());
+  if (lexer->getText(*itr) != "Index") {
+    throw PchorSyntaxError("'Index' keyword");
   }
 
   ++itr;
 
   if (itr == end || itr->type != TokenType::Identifier) {
-    throw std::runtime_error("Expected Identifier after 'Index', but got: " +
-                             itr->toString());
+    throw PchorSyntaxError("Identifier after 'Index'");
   }
-  std::string_view indexName = itr->value;
+  std::string_view indexName = lexer->getText(*itr);
   ++itr;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "{") {
-    throw std::runtime_error("Expected '{' after Identifier, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "{") {
+    throw PchorSyntaxError("'{' after Identifier");
   }
   ++itr; // Move to the next token
 
-  if (itr == end || (itr->type != TokenType::Literal && itr->value != "n")) {
-    throw std::runtime_error("Expected lower bound literal or 'n', but got: " +
-                             itr->toString());
+  if (itr == end || (itr->type != TokenType::Literal && lexer->getText(*itr) != "n")) {
+    throw PchorSyntaxError("lower bound literal or 'n'");
   }
 
   Token lowerToken = *itr;
   ++itr;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != ".") {
-    throw std::runtime_error("Expected '.' after lower bound, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != ".") {
+    throw PchorSyntaxError("'.' after lower bound");
   }
   ++itr;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != ".") {
-    throw std::runtime_error("Expected '..' after lower bound, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != ".") {
+    throw PchorSyntaxError("'..' after lower bound");
   }
   ++itr;
 
-  if (itr == end || (itr->type != TokenType::Literal && itr->value != "n")) {
-    throw std::runtime_error("Expected upper bound literal or 'n', but got: " +
-                             itr->toString());
+  if (itr == end || (itr->type != TokenType::Literal && lexer->getText(*itr) != "n")) {
+    throw PchorSyntaxError("upper bound literal or 'n'");
   }
   Token upperToken = *itr;
   ++itr;
 
   // verify }
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "}") {
-    throw std::runtime_error("Expected '}' after upper bound, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "}") {
+    throw PchorSyntaxError("'}' after upper bound");
   }
 
   // Create the IndexASTNode and add it to the symbol table
   auto indexNode =
-      std::make_shared<IndexASTNode>(indexName, lowerToken, upperToken);
+      std::make_shared<IndexASTNode>(indexName, lexer->getText(lowerToken),
+                                     lexer->getText(upperToken));
   symbolTable->addDeclaration(std::string(indexName), indexNode);
 }
 
@@ -201,23 +397,20 @@ void PchorParser::parseParticipantDecl(
         "Incomplete Index declaration: not enough tokens remaining.");
   }
 
-  if (itr->value != "Participant") {
-    throw std::runtime_error("Expected 'Participant' keyword, but got: " +
-                             itr->toString());
+  if (lexer->getText(*itr) != "Participant") {
+    throw PchorSyntaxError("'Participant' keyword");
   }
 
   itr++;
 
   if (itr == end || itr->type != TokenType::Identifier) {
-    throw std::runtime_error(
-        "Expected Identifier after 'Participant', but got: " + itr->toString());
+    throw PchorSyntaxError("Identifier after 'Participant'");
   }
-  std::string participantName = std::string(itr->value);
+  std::string participantName = std::string(lexer->getText(*itr));
   ++itr;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "{") {
-    throw std::runtime_error("Expected '{' after Identifier, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "{") {
+    throw PchorSyntaxError("'{' after Identifier");
   }
   ++itr;
 
@@ -226,37 +419,31 @@ void PchorParser::parseParticipantDecl(
 
   switch (itr->type) {
   case TokenType::Identifier:
-    ASTNode = symbolTable->resolve(itr->value);
+    ASTNode = symbolTable->resolve(lexer->getText(*itr));
     if (ASTNode == nullptr) {
-      throw std::runtime_error("Declaration for Identifier " + itr->toString() +
-                               "not found");
+      throw std::runtime_error("Declaration for Identifier not found");
     }
     if (!(ASTNode->getDeclType() == Decl::Index_Decl)) {
-      throw std::runtime_error("Namespace " + itr->toString() +
-                               "is not an Index type");
+      throw std::runtime_error("Namespace is not an Index type");
     }
     IdxNode = std::dynamic_pointer_cast<IndexASTNode>(ASTNode);
     break;
   case TokenType::Literal:
-    if (itr->value.at(0) != '1') {
-      throw std::runtime_error(std::format(
-          "Only  literal allowed in participant declaration is '1'. Found {}",
-          itr->toString()));
+    if (lexer->getText(*itr).at(0) != '1') {
+      throw PchorSyntaxError(
+          "'1', the only literal allowed in participant declaration");
     }
     ASTNode = symbolTable->resolve(std::string("PchorUnaryIndex"));
     //no need for check as PchorUnaryIndex is always defined
     IdxNode = std::dynamic_pointer_cast<IndexASTNode>(ASTNode);
     break;
   default:
-    throw std::runtime_error(
-        "Expected Literal or Identifier of Index, but found: " +
-        itr->toString());
+    throw PchorSyntaxError("Literal or Identifier of Index");
   }
   ++itr;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "}") {
-    throw std::runtime_error("Expected '}' after Identifier, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "}") {
+    throw PchorSyntaxError("'}' after Identifier");
   }
   auto Participant =
       std::make_shared<ParticipantASTNode>(participantName, IdxNode);
@@ -275,21 +462,18 @@ void PchorParser::parseChannelDecl(std::vector<Token>::iterator &itr,
         "Incomplete Index declaration: not enough tokens remaining.");
   }
 
-  if (itr->value != "Channel") {
-    throw std::runtime_error("Expected 'Channel' keyword, but got: " +
-                             itr->toString());
+  if (lexer->getText(*itr) != "Channel") {
+    throw PchorSyntaxError("'Channel' keyword");
   }
   ++itr;
   if (itr == end || itr->type != TokenType::Identifier) {
-    throw std::runtime_error("Expected Identifier after 'Channel', but got: " +
-                             itr->toString());
+    throw PchorSyntaxError("Identifier after 'Channel'");
   }
-  std::string channelName = std::string(itr->value);
+  std::string channelName = std::string(lexer->getText(*itr));
   ++itr;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "{") {
-    throw std::runtime_error("Expected '{' after Identifier, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "{") {
+    throw PchorSyntaxError("'{' after Identifier");
   }
 
   std::shared_ptr<DeclPchorASTNode> ASTNode;
@@ -298,19 +482,17 @@ void PchorParser::parseChannelDecl(std::vector<Token>::iterator &itr,
 
   switch (itr->type) {
   case TokenType::Identifier:
-    ASTNode = symbolTable->resolve(itr->value);
+    ASTNode = symbolTable->resolve(lexer->getText(*itr));
     if (ASTNode == nullptr) {
-      throw std::runtime_error("Declaration for Identifier " + itr->toString() +
-                               "not found");
+      throw std::runtime_error("Declaration for Identifier not found");
     }
     if (!(ASTNode->getDeclType() == Decl::Index_Decl)) {
-      throw std::runtime_error("Namespace " + itr->toString() +
-                               "is not an Index type");
+      throw std::runtime_error("Namespace is not an Index type");
     }
     IdxNode = std::dynamic_pointer_cast<IndexASTNode>(ASTNode);
     break;
   case TokenType::Literal:
-    if (itr->value.at(0) != '1') {
+    if (lexer->getText(*itr).at(0) != '1') {
       throw std::runtime_error(
           "Only unary Channels can be declared with literal Type");
     }
@@ -319,15 +501,12 @@ void PchorParser::parseChannelDecl(std::vector<Token>::iterator &itr,
     IdxNode = std::dynamic_pointer_cast<IndexASTNode>(ASTNode);
     break;
   default:
-    throw std::runtime_error(
-        "Expected Literal or Identifier of Index, but found: " +
-        itr->toString());
+    throw PchorSyntaxError("Literal or Identifier of Index");
   }
   itr++;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "}") {
-    throw std::runtime_error("Expected '}' after Identifier, but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "}") {
+    throw PchorSyntaxError("'}' after Identifier");
   }
 
   auto Channel = std::make_shared<ChannelASTNode>(channelName, IdxNode);
@@ -348,35 +527,21 @@ void PchorParser::parseLabelDecl(std::vector<Token>::iterator &itr,
         "Incomplete Index declaration: not enough tokens remaining.");
   }
 
-  if (itr->value != "Label") {
-    throw std::runtime_error("Expected 'Channel' keyword, but got: " +
-                             itr->toString());
+  if (lexer->getText(*itr) != "Label") {
+    throw PchorSyntaxError("'Label' keyword");
   }
   ++itr;
   if (itr == end || itr->type != TokenType::Identifier) {
-    throw std::runtime_error("Expected Identifier after 'Channel', but got: " +
-                             itr->toString());
+    throw PchorSyntaxError("Identifier after 'Label'");
   }
-  std::string labelName = std::string(itr->value);
+  std::string labelName = std::string(lexer->getText(*itr));
   ++itr;
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "{") {
-    throw std::runtime_error("Expected Identifier after 'Channel', but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "{") {
+    throw PchorSyntaxError("'{' after Identifier");
   }
 
-  auto endofScope = itr;
-
-  while (endofScope != end && endofScope->type != TokenType::Symbol &&
-         endofScope->value != "}") {
-    endofScope++;
-  }
-
-  if (endofScope == end) {
-    throw std::runtime_error(
-        "Scope not closed for identifier list of Label Declaration" +
-        itr->toString());
-  }
+  auto endofScope = findEndofScope(itr, end);
   itr++;
 
   // find endofscope such that we can parse all identifiers inbetween
@@ -385,12 +550,11 @@ void PchorParser::parseLabelDecl(std::vector<Token>::iterator &itr,
 
   while (itr != endofScope) {
     if (itr->type == TokenType::Identifier) {
-      identifierSet.insert(std::string(itr->value));
+      identifierSet.insert(std::string(lexer->getText(*itr)));
       itr++;
     } else {
-      throw std::runtime_error("Identifier List may only consist of "
-                               "identifiers. Instead, parser recieved: " +
-                               itr->toString());
+      throw PchorSyntaxError("identifiers",
+                             "Identifier List may only consist of identifiers");
     }
   }
 
@@ -409,26 +573,24 @@ void PchorParser::parseGlobalTypeDecl(std::vector<Token>::iterator &itr,
   <Identifier> = <aggregate>
   */
   if (itr->type != TokenType::Identifier) {
-    throw std::runtime_error(
+    throw PchorSyntaxError(
+        "an identifier",
         "Statement inferred to be a global Type declaration as no explicit "
-        "keyword has been used.\n Expected an identifier but got: " +
-        itr->toString());
+        "keyword has been used");
   }
-  std::string globalTypeName = std::string(itr->value);
+  std::string globalTypeName = std::string(lexer->getText(*itr));
 
   itr++;
-  if (itr->type != TokenType::Symbol && itr->value != "=") {
-    throw std::runtime_error(
-        "Expected '=' followed by Global Type Declaration. Got: " +
-        itr->toString());
+  if (itr->type != TokenType::Symbol && lexer->getText(*itr) != "=") {
+    throw PchorSyntaxError("'=' followed by Global Type Declaration");
   }
 
   itr++;
 
   auto endofScope = itr;
 
-  while (endofScope != end && endofScope->value != "end") {
-    if (endofScope->type == TokenType::Symbol && endofScope->value == "{") {
+  while (endofScope != end && lexer->getText(*endofScope) != "end") {
+    if (endofScope->type == TokenType::Symbol && lexer->getText(*endofScope) == "{") {
         endofScope = findEndofScope(endofScope, end);
     }
     endofScope++;
@@ -456,15 +618,15 @@ PchorParser::parseExpressionList(std::vector<Token>::iterator &itr,
   std::shared_ptr<ExprList> expr = std::make_shared<ExprList>();
   /*
       DEBUG
-      std::println("for expression list begin is {} and end is {}", itr->toString(), end->toString());
+      std::println("for expression list begin is {} and end is {}", lexer->toString(*itr), lexer->toString(*end));
   */
   while (itr != end) {
     /* DEBUG
-      std::println("current itr is {}", itr->toString());
+      std::println("current itr is {}", lexer->toString(*itr));
      std::println("itr == end is {}", itr == end);
      std::println("distance from itr to end: {}", std::distance(itr, end));
     */
-
+    try {
     switch (itr->type) {
     // has to be a communication expression
     case TokenType::Identifier: {
@@ -476,9 +638,9 @@ PchorParser::parseExpressionList(std::vector<Token>::iterator &itr,
       which is n tokens
       */
       // can be identifier of Participant or identifier for other global type
-      auto identified = symbolTable->resolve(itr->value);
+      auto identified = symbolTable->resolve(lexer->getText(*itr));
       if(identified == nullptr){
-        throw std::runtime_error(std::format("Identifier for declared global type expected: Identifier {} not declared", itr->value));
+        throw PchorSyntaxError("Identifier of a declared global type");
       }
       auto endofExpr = itr;
 
@@ -486,13 +648,17 @@ PchorParser::parseExpressionList(std::vector<Token>::iterator &itr,
       case Decl::Participant_Decl:
         /*DEBUG
               std::println("we enter setup for communication expression");
-              std::println("itr is {}, end is {}", itr->toString(), end->toString());
+              std::println("itr is {}, end is {}", lexer->toString(*itr), lexer->toString(*end));
         */
 
-        while (endofExpr != end && endofExpr->value != ".") {
+        while (endofExpr != end && lexer->getText(*endofExpr) != ".") {
+          // the branches of a selection contain expression lists of their own
+          if (endofExpr->type == TokenType::Symbol && lexer->getText(*endofExpr) == "{") {
+            endofExpr = findMatchingBracket(endofExpr, end);
+          }
           endofExpr++;
         }
-        //std::println("itr is {}, endofExpr is {}", itr->toString(), endofExpr->toString());
+        //std::println("itr is {}, endofExpr is {}", lexer->toString(*itr), lexer->toString(*endofExpr));
         expr->addExpr(parseCommunicationExpr(itr, endofExpr));
         break;
       case Decl::Global_Type_Decl:
@@ -500,15 +666,14 @@ PchorParser::parseExpressionList(std::vector<Token>::iterator &itr,
         itr++;
         break;
       default: {
-        throw std::runtime_error("Expected Global_Type expression, found: " +
-                                 itr->toString());
+        throw PchorSyntaxError("Global_Type expression");
         break;
       }
       }
       break;
     }
     case TokenType::Keyword: {
-      if (itr->value == "end") {
+      if (lexer->getText(*itr) == "end") {
         /*DEBUG
             std::println("do we enter this section?");
             std::println("distance from itr to end before ++: {}", std::distance(itr, end));
@@ -519,34 +684,42 @@ PchorParser::parseExpressionList(std::vector<Token>::iterator &itr,
         std::println("distance from itr to end after ++: {}", std::distance(itr, end));
         */
         break;
-      } else if (itr->value == "foreach") {
+      } else if (lexer->getText(*itr) == "foreach") {
         itr++;
         expr->addExpr(parseForEachExpr(itr, end));
         //std::println("does something go wrong here?");
         break;
+      } else if (lexer->getText(*itr) == "rec") {
+        itr++;
+        expr->addExpr(parseRecursiveExpr(itr, end));
+        break;
+      } else if (lexer->getText(*itr) == "continue") {
+        itr++;
+        expr->addExpr(parseContinueExpr(itr, end));
+        break;
       } else {
-        throw std::runtime_error("expected valid keyword for body of GlobalTypeDecl. Found: " +
-                                 itr->toString());
+        throw PchorSyntaxError("valid keyword for body of GlobalTypeDecl");
       }
       break;
     }
     case TokenType::Symbol: {
-      if (itr->value == ".") {
+      if (lexer->getText(*itr) == ".") {
         itr++;
       } else {
-        throw std::runtime_error(
-            "Expected continuation of expression list '.'. Found: " +
-            itr->toString());
+        throw PchorSyntaxError("continuation of expression list '.'");
       }
 
       break;
     }
     default: {
-      throw std::runtime_error("Expected expression type but got: " +
-                               itr->toString());
+      throw PchorSyntaxError("expression type");
       break;
     }
     }
+    } catch (const std::exception &e) {
+      addDiagnostic(itr, end, e);
+      synchronizeExpr(itr, end);
+    }
   }
   return expr;
 }
@@ -564,25 +737,21 @@ PchorParser::parseIterExpr(std::vector<Token>::iterator &itr, const std::vector<
   //1. assume we have non-existant identifier
 
   if(itr->type != TokenType::Identifier) {
-    throw std::runtime_error(
-      std::format("Expected Index Identifier. Instead, found: {}", itr->toString())
-    );
+    throw PchorSyntaxError("Index Identifier");
   }
 
-  if(std::shared_ptr<DeclPchorASTNode> decl = symbolTable->resolve(itr->value)) {
+  if(std::shared_ptr<DeclPchorASTNode> decl = symbolTable->resolve(lexer->getText(*itr))) {
     throw std::runtime_error(
-      std::format("Invalid identifier for IterIndex. Identifier {} has previously been declared as {}.",itr->value, decl->toString())
+      std::format("Invalid identifier for IterIndex. Identifier {} has previously been declared as {}.",lexer->getText(*itr), decl->toString())
     );
   }
 
-  std::string identifier{itr->value};
+  std::string identifier{lexer->getText(*itr)};
   itr++;
   //2. check for which of the three cases we have (i.e, which symbol is used)
 
   if(itr->type != TokenType::Symbol){
-    throw std::runtime_error(
-      std::format("Expected one of the symbols ('<', '>', ':'), but found: {}", itr->toString())
-    );
+    throw PchorSyntaxError("one of the symbols ('<', '>', ':')");
   }
   //plan, we allow for three patterns. 
   /*
@@ -593,15 +762,15 @@ PchorParser::parseIterExpr(std::vector<Token>::iterator &itr, const std::vector<
   size_t min;
   size_t max;
   std::shared_ptr<IndexASTNode> IndexASTDecl = nullptr;
-  if(itr->value == ":"){
+  if(lexer->getText(*itr) == ":"){
     //we expect the name of an index, where we copy the min and max straight to our setup
     itr++;
     if(itr->type != TokenType::Identifier){
-      throw std::runtime_error(std::format("Expected an Identifier for a Index Declaration, recieved {}", itr->toString()));
+      throw PchorSyntaxError("an Identifier for a Index Declaration");
     }
-    auto elem = symbolTable->resolve(itr->value);
+    auto elem = symbolTable->resolve(lexer->getText(*itr));
     if(!elem || elem->getDeclType() != Decl::Index_Decl){
-        throw std::runtime_error(std::format("Identifier {} did not map to an index declaration", itr->value));
+        throw PchorSyntaxError("Identifier of an Index declaration");
     }
     //we now have our base index.. now we get the base modifier
     IndexASTDecl = std::dynamic_pointer_cast<IndexASTNode>(elem);
@@ -610,22 +779,22 @@ PchorParser::parseIterExpr(std::vector<Token>::iterator &itr, const std::vector<
     max = IndexASTDecl->getUpper();
     itr++;
   }
-  else if(itr->value == "<"){
+  else if(lexer->getText(*itr) == "<"){
     itr++;
     //we assume max here 
-    if(itr->type != TokenType::Keyword || itr->value != "max"){
-      throw std::runtime_error(std::format("Following the symbol, '<' in a IterExpr, a max operator must occur. Instead, found: {}", itr->toString()));
+    if(itr->type != TokenType::Keyword || lexer->getText(*itr) != "max"){
+      throw PchorSyntaxError("'max' operator following the symbol '<' in a IterExpr");
     }
 
     itr++;
     max = parseMaxExpr(itr, end, IndexASTDecl)-1;
     min = IndexASTDecl->getLower();
   }
-  else if(itr->value == ">"){
+  else if(lexer->getText(*itr) == ">"){
     itr++;
     //we assume max here 
-    if(itr->type != TokenType::Keyword || itr->value != "min"){
-      throw std::runtime_error(std::format("Following the symbol, '<' in a IterExpr, a max operator must occur. Instead, found: {}", itr->toString()));
+    if(itr->type != TokenType::Keyword || lexer->getText(*itr) != "min"){
+      throw PchorSyntaxError("'max' operator following the symbol '<' in a IterExpr");
     }
 
     itr++;
@@ -633,12 +802,10 @@ PchorParser::parseIterExpr(std::vector<Token>::iterator &itr, const std::vector<
     max = IndexASTDecl->getUpper();
   }
   else {
-    throw std::runtime_error(
-      std::format("Expected one of the symbols ('<', '>', ':'), but found: {}", itr->toString())
-    );
+    throw PchorSyntaxError("one of the symbols ('<', '>', ':')");
   }
-  if(itr->type != TokenType::Symbol || itr->value != ")"){
-    throw std::runtime_error(std::format("Expected Iteration Expression to be closed by ')'. Instead, found: {}", itr->value));
+  if(itr->type != TokenType::Symbol || lexer->getText(*itr) != ")"){
+    throw PchorSyntaxError("Iteration Expression to be closed by ')'");
   }
   itr++;
   return std::make_shared<IterExpr>(IndexASTDecl, min, max, identifier);
@@ -651,47 +818,42 @@ PchorParser::parseForEachExpr(std::vector<Token>::iterator &itr, const std::vect
     forEach has been consumed and we have the expr of type
     forEach(<IterExpr>){<ExprList}.
   */
-  if(itr->type !=  TokenType::Symbol || itr->value != "("){
-    throw std::runtime_error(
-      std::format("Expected '(' after forEach Expr, found {}", itr->toString())
-    );
+  if(itr->type !=  TokenType::Symbol || lexer->getText(*itr) != "("){
+    throw PchorSyntaxError("'(' after forEach Expr");
   }
   std::vector<Token>::iterator endOfIterExpr = findEndofIterScope(itr, end);
   itr++;
   std::shared_ptr<IterExpr> iterExpr = parseIterExpr(itr, endOfIterExpr);
 
-  if(itr->type != TokenType::Symbol || itr->value != "{"){
-      throw std::runtime_error(
-        std::format("Expected '{{' after forEach Expr, found {}", itr->toString())
-      );
+  if(itr->type != TokenType::Symbol || lexer->getText(*itr) != "{"){
+      throw PchorSyntaxError("'{' after forEach Expr");
   }
   std::vector<Token>::iterator endOfExprListScope = findEndofScope(itr, end);
-  if(endOfExprListScope->type != TokenType::Symbol || endOfExprListScope->value != "}"){
-    throw std::runtime_error(std::format("Body of foreach expression must end in '}}'. Instead, parser found: {}", endOfExprListScope->toString()));
+  if(endOfExprListScope->type != TokenType::Symbol || lexer->getText(*endOfExprListScope) != "}"){
+    throw std::runtime_error(std::format("Body of foreach expression must end in '}}'. Instead, parser found: {}", lexer->toString(*endOfExprListScope)));
   }
   itr++; //enter scope
   //std::println("we enter parseexpressionlist from foreach");
   std::shared_ptr<ExprList> exprList = parseExpressionList(itr, endOfExprListScope);
-  if(itr->type != TokenType::Symbol || itr->value != "}"){
-    throw std::runtime_error(std::format("Parser failed to parse body of forEach Statement. Stopped at {}", itr->toString()));
+  if(itr->type != TokenType::Symbol || lexer->getText(*itr) != "}"){
+    throw PchorSyntaxError("'}' closing the body of forEach Statement");
   }
   itr++;
   //std::println("do we make it past here?");
   return std::make_shared<ForEachExpr>(iterExpr, exprList);
 }
 
-std::shared_ptr<CommunicationExpr>
+std::shared_ptr<ExprPchorASTNode>
 PchorParser::parseCommunicationExpr(std::vector<Token>::iterator &itr,
                                     const std::vector<Token>::iterator &end) {
 
   // parseSender
   
-  auto sender = symbolTable->resolve(itr->value);
+  auto sender = symbolTable->resolve(lexer->getText(*itr));
   //std::println("We have sucessfully identified sender: {}", sender->getName());
 
   if (!sender || sender->getDeclType() != Decl::Participant_Decl) {
-    throw std::runtime_error("Expected Participant Identifier, but got: " +
-                             itr->toString());
+    throw PchorSyntaxError("Participant Identifier");
   }
 
   auto senderAST = std::dynamic_pointer_cast<ParticipantASTNode>(sender);
@@ -701,18 +863,10 @@ PchorParser::parseCommunicationExpr(std::vector<Token>::iterator &itr,
   itr++;
   //std::println("we successfully converted sender and begin to enter indexsection");
   // either beginning of index expr or com operator
-  if (itr->type == TokenType::Symbol && itr->value == "[") {
-    auto endofIndex = itr;
-
-    while (endofIndex != end && endofIndex->value != "]") {
-      endofIndex++;
-    }
-    if (endofIndex == end || endofIndex->value != "]") {
-      throw std::runtime_error("Expected ']', but found: " +
-                               endofIndex->toString());
-    }
+  if (itr->type == TokenType::Symbol && lexer->getText(*itr) == "[") {
+    auto endofIndex = findMatchingBracket(itr, end);
 
-    //std::println("we found index and the end of the expr. Begin {}. End {}.", itr->toString(), endofIndex->toString());
+    //std::println("we found index and the end of the expr. Begin {}. End {}.", lexer->toString(*itr), lexer->toString(*endofIndex));
     senderIndex = parseIndexExpr(senderAST->getIndex(), itr, endofIndex);
     //std::println("we successfully leave indexmanagement");
   } else {
@@ -724,18 +878,16 @@ PchorParser::parseCommunicationExpr(std::vector<Token>::iterator &itr,
   std::shared_ptr<ParticipantExpr> senderexpr =
       std::make_shared<ParticipantExpr>(senderAST, senderIndex);
 
-  if (itr == end || itr->type != TokenType::Symbol || itr->value != "->") {
-    throw std::runtime_error("Expected communication operator '->', but got: " +
-                             itr->toString());
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "->") {
+    throw PchorSyntaxError("communication operator '->'");
   }
 
   itr++;
   // parseReciever
 
-  auto reciever = symbolTable->resolve(itr->value);
+  auto reciever = symbolTable->resolve(lexer->getText(*itr));
   if (!sender || sender->getDeclType() != Decl::Participant_Decl) {
-    throw std::runtime_error("Expected Participant Identifier, but got: " +
-                             itr->toString());
+    throw PchorSyntaxError("Participant Identifier");
   }
 
   auto recieverAST = std::dynamic_pointer_cast<ParticipantASTNode>(reciever);
@@ -744,16 +896,8 @@ PchorParser::parseCommunicationExpr(std::vector<Token>::iterator &itr,
   itr++;
 
   // either index or : operator
-  if (itr->type == TokenType::Symbol && itr->value == "[") {
-    auto endofIndex = itr;
-
-    while (endofIndex != end && endofIndex->value != "]") {
-      endofIndex++;
-    }
-    if (endofIndex == end || endofIndex->value != "]") {
-      throw std::runtime_error("Expected ']', but found: " +
-                               endofIndex->toString());
-    }
+  if (itr->type == TokenType::Symbol && lexer->getText(*itr) == "[") {
+    auto endofIndex = findMatchingBracket(itr, end);
     recieverIndex = parseIndexExpr(recieverAST->getIndex(), itr, endofIndex);
   } else {
     recieverIndex = std::make_shared<IndexExpr>(
@@ -764,19 +908,16 @@ PchorParser::parseCommunicationExpr(std::vector<Token>::iterator &itr,
   std::shared_ptr<ParticipantExpr> recieverexpr =
       std::make_shared<ParticipantExpr>(recieverAST, recieverIndex);
 
-  if (itr->type != TokenType::Symbol || itr->value != ":") {
-    throw std::runtime_error("Communication statement requires specifier ':'. "
-                             "Instead, parser recieved: " +
-                             itr->toString());
+  if (itr->type != TokenType::Symbol || lexer->getText(*itr) != ":") {
+    throw PchorSyntaxError("specifier ':'", "Communication statement");
   }
 
   itr++;
-  auto channel = symbolTable->resolve(itr->value);
+  auto channel = symbolTable->resolve(lexer->getText(*itr));
 
   if (!channel || channel->getDeclType() != Decl::Channel_Decl) {
-    throw std::runtime_error("Communication statement requires reference to "
-                             "declared channel. Instead, parser recieved: " +
-                             itr->toString());
+    throw PchorSyntaxError("reference to declared channel",
+                           "Communication statement");
   }
 
   auto channelAST = std::dynamic_pointer_cast<ChannelASTNode>(channel);
@@ -784,16 +925,8 @@ PchorParser::parseCommunicationExpr(std::vector<Token>::iterator &itr,
 
   itr++;
 
-  if (itr->type == TokenType::Symbol && itr->value == "[") {
-    auto endofIndex = itr;
-
-    while (endofIndex != end && endofIndex->value != "]") {
-      endofIndex++;
-    }
-    if (endofIndex == end || endofIndex->value != "]") {
-      throw std::runtime_error("Expected ']', but found: " +
-                               endofIndex->toString());
-    }
+  if (itr->type == TokenType::Symbol && lexer->getText(*itr) == "[") {
+    auto endofIndex = findMatchingBracket(itr, end);
     channelIndex = parseIndexExpr(channelAST->getIndex(), itr, endofIndex);
   } else {
     channelIndex = std::make_shared<IndexExpr>(
@@ -804,29 +937,120 @@ PchorParser::parseCommunicationExpr(std::vector<Token>::iterator &itr,
   std::shared_ptr<ChannelExpr> channelexpr =
       std::make_shared<ChannelExpr>(channelAST, channelIndex);
 
-  if (itr->type != TokenType::Symbol || itr->value != "<") {
-    throw std::runtime_error("Expected '<' but recieved: " + itr->toString());
+  if (itr->type != TokenType::Symbol || lexer->getText(*itr) != "<") {
+    throw PchorSyntaxError("'<'");
   }
 
   itr++;
 
   if (itr->type != TokenType::Identifier) {
-    throw std::runtime_error("Expected DataType Namespace, but recieved: " +
-                             itr->toString());
+    throw PchorSyntaxError("DataType Namespace");
   }
-  std::string dataType = std::string(itr->value);
+  std::string dataType = std::string(lexer->getText(*itr));
   itr++;
 
-  if (itr->type != TokenType::Symbol || itr->value != ">") {
-    throw std::runtime_error("Expected '>' but recieved: " + itr->toString());
+  if (itr->type != TokenType::Symbol || lexer->getText(*itr) != ">") {
+    throw PchorSyntaxError("'>'");
   }
 
   // go to next expression
   itr++;
+
+  // communicating a declared label selects one of the branches that follow
+  auto label = symbolTable->resolve(dataType);
+  if (label && label->getDeclType() == Decl::Label_Decl) {
+    return parseSelectionExpr(senderexpr, recieverexpr, channelexpr,
+                              std::dynamic_pointer_cast<LabelASTNode>(label),
+                              itr, end);
+  }
+  if (itr != end && itr->type == TokenType::Symbol && lexer->getText(*itr) == "{") {
+    throw std::runtime_error(std::format(
+        "Only communication of a declared Label may be followed by branches. "
+        "{} is not a Label",
+        dataType));
+  }
   return std::make_shared<CommunicationExpr>(senderexpr, recieverexpr,
                                              channelexpr, dataType, nullptr);
 }
 
+bool PchorParser::isBranchStart(const std::vector<Token>::iterator &itr,
+                                const std::vector<Token>::iterator &begin,
+                                const std::vector<Token>::iterator &end,
+                                const LabelASTNode &label) const {
+  /*
+    A branch starts with <label> ':'. The receiver of a communication is
+    also followed by ':', but is always preceded by '->'
+  */
+  if (itr->type != TokenType::Identifier ||
+      !label.isLabel(std::string(lexer->getText(*itr)))) {
+    return false;
+  }
+  auto next = std::next(itr);
+  if (next == end || next->type != TokenType::Symbol || lexer->getText(*next) != ":") {
+    return false;
+  }
+  return itr == begin || lexer->getText(*std::prev(itr)) != "->";
+}
+
+std::shared_ptr<SelectionExpr> PchorParser::parseSelectionExpr(
+    std::shared_ptr<ParticipantExpr> sender,
+    std::shared_ptr<ParticipantExpr> reciever,
+    std::shared_ptr<ChannelExpr> channel, std::shared_ptr<LabelASTNode> label,
+    std::vector<Token>::iterator &itr,
+    const std::vector<Token>::iterator &end) {
+  /*
+    Declaration Semantics
+    {<label>: <ExprList> <label>: <ExprList> ...}
+    where every label is declared in label, and occurs at most once
+  */
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "{") {
+    throw PchorSyntaxError(
+        std::format("'{{' after selection of Label {}", label->getName()));
+  }
+  auto endofScope = findEndofScope(itr, end);
+  itr++;
+  const auto scopeBegin = itr;
+
+  std::vector<std::pair<std::string, std::shared_ptr<ExprList>>> branches{};
+  while (itr != endofScope) {
+    if (!isBranchStart(itr, scopeBegin, endofScope, *label)) {
+      throw PchorSyntaxError(
+          std::format("'<label>:' for a label of {}", label->getName()));
+    }
+    std::string branchLabel{lexer->getText(*itr)};
+    for (const auto &[name, body] : branches) {
+      if (name == branchLabel) {
+        throw std::runtime_error(std::format(
+            "Label {} occurs more than once in selection", branchLabel));
+      }
+    }
+    itr += 2;
+
+    // the branch body extends to the next label at this depth
+    auto endofBranch = itr;
+    while (endofBranch != endofScope &&
+           !isBranchStart(endofBranch, scopeBegin, endofScope, *label)) {
+      if (endofBranch->type == TokenType::Symbol &&
+          (lexer->getText(*endofBranch) == "{" || lexer->getText(*endofBranch) == "(" ||
+           lexer->getText(*endofBranch) == "[")) {
+        endofBranch = findMatchingBracket(endofBranch, endofScope);
+      }
+      endofBranch++;
+    }
+    branches.emplace_back(branchLabel, parseExpressionList(itr, endofBranch));
+    itr = endofBranch;
+  }
+
+  if (branches.empty()) {
+    throw std::runtime_error(std::format(
+        "Selection of Label {} requires at least one branch", label->getName()));
+  }
+  // step past '}'
+  itr++;
+  return std::make_shared<SelectionExpr>(sender, reciever, channel, label,
+                                         std::move(branches));
+}
+
 std::shared_ptr<IndexExpr>
 PchorParser::parseIndexExpr(std::shared_ptr<IndexASTNode> indexType,
                             std::vector<Token>::iterator &itr,
@@ -843,8 +1067,7 @@ PchorParser::parseIndexExpr(std::shared_ptr<IndexASTNode> indexType,
   std::shared_ptr<IndexExpr> expr = std::make_shared<IndexExpr>(indexType, std::move(aritExpr), isLiteral);
 
   if (itr != end) {
-    throw std::runtime_error("Expected end of index expression ']'. Found: " +
-                             itr->toString());
+    throw PchorSyntaxError("end of index expression ']'");
   }
   if (expr == nullptr) {
     std::println("Not Implemented");
@@ -852,36 +1075,106 @@ PchorParser::parseIndexExpr(std::shared_ptr<IndexASTNode> indexType,
   itr++;
   return expr;
 }
-// Todo: Implement recursive expression parser
 std::shared_ptr<RecExpr> PchorParser::parseRecursiveExpr(
-    [[maybe_unused]] std::vector<Token>::iterator &itr,
-    [[maybe_unused]] const std::vector<Token>::iterator &end) {
-  std::println("Not Implemented");
-  return nullptr;
+    std::vector<Token>::iterator &itr,
+    const std::vector<Token>::iterator &end) {
+  /*
+    rec has been consumed and we have the expr of type
+    rec <RecVar>{<ExprList>}
+    where every path through the ExprList ends in 'end' or 'continue <RecVar>'
+  */
+  if (itr == end || itr->type != TokenType::Identifier) {
+    throw PchorSyntaxError("recursion variable after rec");
+  }
+  std::string recVar{lexer->getText(*itr)};
+  if (auto decl = symbolTable->resolve(recVar)) {
+    throw std::runtime_error(std::format(
+        "Invalid recursion variable. Identifier {} has previously been "
+        "declared as {}.",
+        recVar, decl->toString()));
+  }
+  if (std::find(recursionScopes.begin(), recursionScopes.end(), recVar) !=
+      recursionScopes.end()) {
+    throw std::runtime_error(std::format(
+        "Recursion variable {} is already bound by an enclosing recursion",
+        recVar));
+  }
+  itr++;
+
+  if (itr == end || itr->type != TokenType::Symbol || lexer->getText(*itr) != "{") {
+    throw PchorSyntaxError(
+        std::format("'{{' after recursion variable {}", recVar));
+  }
+  auto endofScope = findEndofScope(itr, end);
+  itr++; // enter scope
+
+  recursionScopes.push_back(recVar);
+  std::shared_ptr<ExprList> body;
+  try {
+    body = parseExpressionList(itr, endofScope);
+  } catch (...) {
+    recursionScopes.pop_back();
+    throw;
+  }
+  recursionScopes.pop_back();
+
+  if (body->begin() != body->end() &&
+      (*body->begin())->getExprType() == Expr::ConExpr) {
+    throw std::runtime_error(std::format(
+        "Recursion {} continues without communicating first", recVar));
+  }
+  // step past '}'
+  itr++;
+  return std::make_shared<RecExpr>(recVar, nullptr, body);
+}
+
+std::shared_ptr<ConExpr>
+PchorParser::parseContinueExpr(std::vector<Token>::iterator &itr,
+                               const std::vector<Token>::iterator &end) {
+  /*
+    continue has been consumed and we have the expr of type
+    continue <RecVar>
+    which must be the last expression of its expression list
+  */
+  if (itr == end || itr->type != TokenType::Identifier) {
+    throw PchorSyntaxError("recursion variable after continue");
+  }
+  std::string recVar{lexer->getText(*itr)};
+  if (std::find(recursionScopes.begin(), recursionScopes.end(), recVar) ==
+      recursionScopes.end()) {
+    throw std::runtime_error(std::format(
+        "continue {} is not inside a recursion over {}", recVar, recVar));
+  }
+  itr++;
+  if (itr != end) {
+    throw PchorSyntaxError(
+        "end of expression list", std::format("continue {}", recVar));
+  }
+  return std::make_shared<ConExpr>(recVar, nullptr);
 }
 
 size_t PchorParser::parseMaxExpr(std::vector<Token>::iterator &itr, const std::vector<Token>::iterator &end, std::shared_ptr<IndexASTNode>& nodePtr) {
   
-  if(itr->type != TokenType::Symbol || itr->value != "(") {
-    throw std::runtime_error(std::format("Expected symbol, '(', following min-operator. Instead, found: {}", itr->toString()));
+  if(itr->type != TokenType::Symbol || lexer->getText(*itr) != "(") {
+    throw PchorSyntaxError("symbol '(' following the max-operator");
   }
   itr++;
 
   if(itr->type != TokenType::Identifier) {
-    throw std::runtime_error(std::format("Expected Identifier as argument for min-operator. Instead, found: {}", itr->toString()));
+    throw PchorSyntaxError("Identifier as argument for the max-operator");
   }
-  auto elem = symbolTable->resolve(itr->value);
+  auto elem = symbolTable->resolve(lexer->getText(*itr));
 
   if(!elem || elem->getDeclType() != Decl::Index_Decl) {
-    throw std::runtime_error(std::format("Identifier {} did not map to an index declaration", itr->value));
+    throw PchorSyntaxError("Identifier of an Index declaration");
   }
 
   nodePtr = std::dynamic_pointer_cast<IndexASTNode>(elem);
 
   itr++;
 
-  if(itr->type != TokenType::Symbol || itr->value != ")") {
-    throw std::runtime_error(std::format("Expected symbol, '(', following min-operator. Instead, found: {}", itr->toString()));
+  if(itr->type != TokenType::Symbol || lexer->getText(*itr) != ")") {
+    throw PchorSyntaxError("symbol ')' closing the max-operator");
   }
   itr++;
 
@@ -890,26 +1183,26 @@ size_t PchorParser::parseMaxExpr(std::vector<Token>::iterator &itr, const std::v
 
 size_t PchorParser::parseMinExpr(std::vector<Token>::iterator &itr, const std::vector<Token>::iterator &end, std::shared_ptr<IndexASTNode>& nodePtr) {
 
-    if(itr->type != TokenType::Symbol || itr->value != "(") {
-      throw std::runtime_error(std::format("Expected symbol, '(', following min-operator. Instead, found: {}", itr->toString()));
+    if(itr->type != TokenType::Symbol || lexer->getText(*itr) != "(") {
+      throw PchorSyntaxError("symbol '(' following the min-operator");
     }
     itr++;
 
     if(itr->type != TokenType::Identifier) {
-      throw std::runtime_error(std::format("Expected Identifier as argument for min-operator. Instead, found: {}", itr->toString()));
+      throw PchorSyntaxError("Identifier as argument for the min-operator");
     }
-    auto elem = symbolTable->resolve(itr->value);
+    auto elem = symbolTable->resolve(lexer->getText(*itr));
 
     if(!elem || elem->getDeclType() != Decl::Index_Decl) {
-      throw std::runtime_error(std::format("Identifier {} did not map to an index declaration", itr->value));
+      throw PchorSyntaxError("Identifier of an Index declaration");
     }
 
     nodePtr = std::dynamic_pointer_cast<IndexASTNode>(elem);
 
     itr++;
 
-    if(itr->type != TokenType::Symbol || itr->value != ")") {
-      throw std::runtime_error(std::format("Expected symbol, '(', following min-operator. Instead, found: {}", itr->toString()));
+    if(itr->type != TokenType::Symbol || lexer->getText(*itr) != ")") {
+      throw PchorSyntaxError("symbol ')' closing the min-operator");
     }
     itr++;
     return nodePtr->getLower();
@@ -919,24 +1212,24 @@ size_t PchorParser::parseMinExpr(std::vector<Token>::iterator &itr, const std::v
 
 std::unique_ptr<BaseArithmeticExpr> PchorParser::parseArithmeticExpr(std::shared_ptr<IndexASTNode> indexType, std::vector<Token>::iterator &itr, const std::vector<Token>::iterator &end, bool& isLiteral) {
   //std::println("we now enter parseArithmeticExpr");
-  //std::println("itr is {}, end is {}", itr->toString(), end->toString());
+  //std::println("itr is {}, end is {}", lexer->toString(*itr), lexer->toString(*end));
   auto left = parsePrimaryArithmeticExpr(indexType, itr, end, isLiteral);
   //std::println("we successfully found left {}", left->toString());
   //we only deal with symbols from here !
-  //std::println("itr should be at end 0:: itr is:  {}, end is {}", itr->toString(), end->toString());
+  //std::println("itr should be at end 0:: itr is:  {}, end is {}", lexer->toString(*itr), lexer->toString(*end));
   //std::println("ptr dif is: {}", std::distance(itr, end));
   while(itr != end && itr->type == TokenType::Symbol) {
-    //std::println("itr is:  {}, end is {}", itr->toString(), end->toString());
+    //std::println("itr is:  {}, end is {}", lexer->toString(*itr), lexer->toString(*end));
     //std::println("ptr dif is: {}", std::distance(itr, end));
     ArithmeticExpr type;
-    if(itr->value == "+"){
+    if(lexer->getText(*itr) == "+"){
       type = ArithmeticExpr::Addition;
     }
-    else if(itr->value == "-"){
+    else if(lexer->getText(*itr) == "-"){
       type = ArithmeticExpr::Subtraction;
     }
     else {
-      throw std::runtime_error(std::format("Arithmetic Expressions can only be connected with symbols '+' or '-'. Instead, found {}", itr->toString()));
+      throw PchorSyntaxError("symbols '+' or '-' connecting Arithmetic Expressions");
     }
     itr++;
     auto right = parsePrimaryArithmeticExpr(indexType, itr, end, isLiteral);
@@ -968,17 +1261,17 @@ std::unique_ptr<BaseArithmeticExpr> PchorParser::parsePrimaryArithmeticExpr(std:
   std::vector<Token>::iterator endofScope;
   switch(itr->type) {
     case TokenType::Literal:
-      node = std::make_unique<LiteralExpr>(std::stoull(std::string(itr->value)));
+      node = std::make_unique<LiteralExpr>(std::stoull(std::string(lexer->getText(*itr))));
       itr++;
       break;
     case TokenType::Identifier:
       isLiteral = false;
-      node = std::make_unique<IdentifierExpr>(itr->value);
+      node = std::make_unique<IdentifierExpr>(lexer->getText(*itr));
       itr++;
       break;
     case TokenType::Symbol:
-      if(itr->value != "("){
-        throw std::runtime_error(std::format("Only symbols '(' or ')' allowed at expression level. Instead, found: {}", itr->toString()));
+      if(lexer->getText(*itr) != "("){
+        throw PchorSyntaxError("symbol '(' at expression level");
       }
       endofScope = findEndofIterScope(itr, end);
       itr++;
@@ -987,15 +1280,15 @@ std::unique_ptr<BaseArithmeticExpr> PchorParser::parsePrimaryArithmeticExpr(std:
       break;
     case TokenType::Keyword:
       //std::println("we successfully identified min or max");
-      if(itr->value != "min" && itr->value != "max"){
-        throw std::runtime_error(std::format("Only keywords'min' or 'max' allowed at expression level. Instead, found: {}", itr->toString()));
+      if(lexer->getText(*itr) != "min" && lexer->getText(*itr) != "max"){
+        throw PchorSyntaxError("keywords 'min' or 'max' at expression level");
       }
       size_t literal;
-      if(itr->value == "min") {
+      if(lexer->getText(*itr) == "min") {
         itr++;
         literal = parseMinExpr(itr, end, exprIndexDecl);
       }
-      else if(itr->value == "max") {
+      else if(lexer->getText(*itr) == "max") {
         itr++;
         literal = parseMaxExpr(itr, end, exprIndexDecl);
       }
@@ -1017,7 +1310,7 @@ std::unique_ptr<BaseArithmeticExpr> PchorParser::parsePrimaryArithmeticExpr(std:
       break;
 
     default:
-      throw std::runtime_error("Unexpected token in arithmetic expression: " + itr->toString());
+      throw std::runtime_error("Unexpected token in arithmetic expression");
   }
   return node;
 
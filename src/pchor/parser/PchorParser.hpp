@@ -4,6 +4,7 @@
 
 #include <memory> // For std::unique_ptr
 #include <print>
+#include <stdexcept>
 #include <unordered_map>
 
 namespace PchorAST {
@@ -77,26 +78,135 @@ private:
   friend class STIterator;
 };
 
+/*
+  Thrown where the parser required a specific token. It only names what was
+  expected: the token that was found instead is taken from the position the
+  diagnostic is reported at
+*/
+class PchorSyntaxError : public std::runtime_error {
+public:
+  explicit PchorSyntaxError(std::string expected, std::string context = "")
+      : std::runtime_error(context.empty()
+                               ? "Expected " + expected
+                               : context + ": expected " + expected),
+        expected(std::move(expected)), context(std::move(context)) {}
+
+  const std::string &getExpected() const { return expected; }
+  const std::string &getContext() const { return context; }
+
+private:
+  std::string expected;
+  std::string context;
+};
+
+// Parse error with the position of the token the parser failed at
+struct PchorDiagnostic {
+  size_t line;
+  size_t column;
+  // what went wrong, or the context of a syntax error
+  std::string message;
+  // for syntax errors, the token(s) required at this position
+  std::string expected;
+  std::string got;
+
+  std::string toString() const {
+    if (expected.empty()) {
+      return std::format("{}:{}: error: {} (got '{}')", line, column, message,
+                         got);
+    }
+    if (message.empty()) {
+      return std::format("{}:{}: error: expected {}, got '{}'", line, column,
+                         expected, got);
+    }
+    return std::format("{}:{}: error: {}: expected {}, got '{}'", line, column,
+                       message, expected, got);
+  }
+};
+
 class PchorParser {
 public:
   // Constructor now takes ownership of lexer and symbol table
   explicit PchorParser(const std::string &filePath)
-      : lexer(std::make_unique<PchorLexer>(filePath)),
-        symbolTable(std::make_shared<SymbolTable>()), tokens() {}
+      : filePath(filePath), lexer(std::make_unique<PchorLexer>(filePath)),
+        symbolTable(std::make_shared<SymbolTable>()), tokens(),
+        unaryIndex(nullptr), parsedDecls(), reusedDecls(0), diagnostics(),
+        recursionScopes() {}
 
   void parse();
   void genTokens();
 
+  /*
+    Incremental parse of the file after it has been edited. The file is
+    re-tokenized, but top-level declarations whose tokens and resolved
+    dependencies are unchanged since the previous parse are not parsed again:
+    their AST nodes are reused as is. Only parsing is incremental: the
+    projection memo lives in the projection visitor of a single run, so the
+    choreography is projected and validated again in full.
+  */
+  void reparse();
+  size_t getReusedDeclarations() const { return reusedDecls; }
+
+  /*
+    parse() does not stop at the first malformed token. It records a
+    diagnostic, skips to the next expression or declaration and continues, so
+    that all errors of a file are reported in one run. If any were found,
+    parse() throws once it is done, listing all of them
+  */
+  const std::vector<PchorDiagnostic> &getDiagnostics() const {
+    return diagnostics;
+  }
+
   void printTokenList() const;
   void printAST() const;
 
   std::shared_ptr<SymbolTable> getChorAST() { return std::move(symbolTable); }
 
 private:
+  // A top-level declaration as parsed in the previous run
+  struct ParsedDecl {
+    std::shared_ptr<DeclPchorASTNode> node;
+    // every identifier of the declaration and what it resolved to at the time
+    std::vector<std::pair<std::string, std::shared_ptr<DeclPchorASTNode>>>
+        dependencies;
+  };
+
+  std::string filePath;
   std::unique_ptr<PchorLexer> lexer;        // Unique ownership of lexer
   std::shared_ptr<SymbolTable> symbolTable; // Unique ownership of symbol table
   std::vector<Token> tokens;
 
+  std::shared_ptr<IndexASTNode> unaryIndex;
+  // keyed by the token values of the declaration
+  std::unordered_map<std::string, ParsedDecl> parsedDecls;
+  size_t reusedDecls;
+
+  std::vector<PchorDiagnostic> diagnostics;
+  // recursion variables bound around the expression being parsed
+  std::vector<std::string> recursionScopes;
+
+  void addDiagnostic(std::vector<Token>::iterator itr,
+                     const std::vector<Token>::iterator &end,
+                     const std::exception &error);
+  // panic mode recovery: skip to the start of the next declaration
+  void synchronizeDecl(std::vector<Token>::iterator &itr,
+                       const std::vector<Token>::iterator &declStart,
+                       const std::vector<Token>::iterator &end);
+  // panic mode recovery: skip to the '.' ending the current expression
+  void synchronizeExpr(std::vector<Token>::iterator &itr,
+                       const std::vector<Token>::iterator &end);
+
+  void parseDecl(std::vector<Token>::iterator &itr,
+                 const std::vector<Token>::iterator &end);
+
+  std::vector<Token>::iterator
+  findEndofDecl(std::vector<Token>::iterator &itr,
+                const std::vector<Token>::iterator &end);
+
+  std::string getDeclText(std::vector<Token>::iterator itr,
+                          const std::vector<Token>::iterator &declEnd) const;
+
+  bool isReusable(const ParsedDecl &decl) const;
+
   void parseParticipantDecl(std::vector<Token>::iterator &itr,
                             const std::vector<Token>::iterator &end);
   void parseChannelDecl(std::vector<Token>::iterator &itr,
@@ -120,12 +230,26 @@ private:
   parseIndexExpr(std::shared_ptr<IndexASTNode> index,
                  std::vector<Token>::iterator &itr,
                  const std::vector<Token>::iterator &end);
-  std::shared_ptr<CommunicationExpr>
+  std::shared_ptr<ExprPchorASTNode>
   parseCommunicationExpr(std::vector<Token>::iterator &itr,
                          const std::vector<Token>::iterator &end);
+  std::shared_ptr<SelectionExpr>
+  parseSelectionExpr(std::shared_ptr<ParticipantExpr> sender,
+                     std::shared_ptr<ParticipantExpr> reciever,
+                     std::shared_ptr<ChannelExpr> channel,
+                     std::shared_ptr<LabelASTNode> label,
+                     std::vector<Token>::iterator &itr,
+                     const std::vector<Token>::iterator &end);
+  bool isBranchStart(const std::vector<Token>::iterator &itr,
+                     const std::vector<Token>::iterator &begin,
+                     const std::vector<Token>::iterator &end,
+                     const LabelASTNode &label) const;
   std::shared_ptr<RecExpr>
   parseRecursiveExpr(std::vector<Token>::iterator &itr,
                      const std::vector<Token>::iterator &end);
+  std::shared_ptr<ConExpr>
+  parseContinueExpr(std::vector<Token>::iterator &itr,
+                    const std::vector<Token>::iterator &end);
 
   std::shared_ptr<ForEachExpr>
   parseForEachExpr(std::vector<Token>::iterator &itr, const std::vector<Token>::iterator &end);
@@ -133,6 +257,11 @@ private:
   std::shared_ptr<IterExpr>
   parseIterExpr(std::vector<Token>::iterator &itr, const std::vector<Token>::iterator &end);
 
+  // O(1) lookup of the bracket closing the scope opened at itr
+  std::vector<Token>::iterator
+  findMatchingBracket(std::vector<Token>::iterator &itr,
+                      const std::vector<Token>::iterator &end);
+
   std::vector<Token>::iterator
   findEndofScope(std::vector<Token>::iterator &itr,
                  const std::vector<Token>::iterator &end);
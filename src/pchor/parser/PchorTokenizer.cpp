@@ -1,114 +1,210 @@
 #include "PchorTokenizer.hpp"
+#include <format>
 #include <string>
 #include <vector>
 #include <algorithm>
 namespace PchorAST {
-std::string Token::toString() const {
-  std::string s;
-  switch (type) {
+const std::string PchorLexer::symbols = "{}<>[]().=+-:";
+const std::unordered_set<std::string_view> PchorLexer::keywords{
+    "Index", "Participant", "Channel", "Label", "foreach",
+    "rec",   "continue",    "end",     "min",   "max"};
+
+std::vector<Token> PchorLexer::genTokens() {
+  std::string_view input = file->getBuffer();
+  lineStarts.clear();
+  std::vector<Token> tokens{};
+
+  auto itr = input.begin();
+  const auto end = input.end();
+
+  tokens.emplace_back(nextToken(itr, end));
+  while (tokens.back().type != TokenType::EndOfFile) {
+    tokens.emplace_back(nextToken(itr, end));
+  }
+
+  genScopeTable(tokens);
+  return tokens;
+}
+
+size_t PchorLexer::findLineIndex(uint32_t offset) const {
+  if (lineStarts.empty()) {
+    std::string_view buffer = file->getBuffer();
+    lineStarts.push_back(0);
+    for (size_t i = 0; i < buffer.size(); ++i) {
+      if (buffer[i] == '\n') {
+        lineStarts.push_back(static_cast<uint32_t>(i + 1));
+      }
+    }
+  }
+  auto next = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+  return static_cast<size_t>(std::distance(lineStarts.begin(), next)) - 1;
+}
+
+std::string_view PchorLexer::getText(const Token &token) const {
+  return file->getBuffer().substr(token.offset, token.length);
+}
+
+size_t PchorLexer::getLine(const Token &token) const {
+  return findLineIndex(token.offset) + 1;
+}
+
+size_t PchorLexer::getColumn(const Token &token) const {
+  return token.offset - lineStarts[findLineIndex(token.offset)] + 1;
+}
+
+std::string PchorLexer::toString(const Token &token) const {
+  std::string_view type{};
+  switch (token.type) {
   case TokenType::Keyword:
-    s = "Keyword";
+    type = "Keyword";
     break;
   case TokenType::Identifier:
-    s = "Identifier";
+    type = "Identifier";
     break;
   case TokenType::Symbol:
-    s = "Symbol";
+    type = "Symbol";
     break;
   case TokenType::Literal:
-    s = "Literal";
+    type = "Literal";
     break;
   case TokenType::EndOfFile:
-    s = "EndOfFile";
+    type = "EndOfFile";
     break;
   case TokenType::Unknown:
-    s = "Unknown";
+    type = "Unknown";
     break;
   }
-  s += " " + std::string(value) + " " + std::to_string(line) + "\n";
-  return s;
+  return std::format("{} {} {}:{}\n", type, getText(token), getLine(token),
+                     getColumn(token));
 }
 
-const std::string PchorLexer::symbols = "{}<>[]().=+-:";
-const std::unordered_set<std::string_view> PchorLexer::keywords{
-    "Index", "Participant", "Channel", "Label", "foreach", "end", "min", "max"};
+void PchorLexer::genScopeTable(const std::vector<Token> &tokens) {
+  scopeTable.assign(tokens.size(), noMatchingScope);
 
-std::vector<Token> PchorLexer::genTokens() {
-  std::string_view input = file->getBuffer();
-  std::vector<Token> tokens{};
+  // bracket kinds are matched independently of each other
+  std::vector<size_t> braces{};
+  std::vector<size_t> parens{};
+  std::vector<size_t> brackets{};
 
-  auto itr = input.begin();
-  const auto end = input.end();
+  auto closeScope = [this](std::vector<size_t> &openScopes, size_t pos) {
+    if (!openScopes.empty()) {
+      scopeTable[openScopes.back()] = pos;
+      scopeTable[pos] = openScopes.back();
+      openScopes.pop_back();
+    }
+  };
 
-  size_t i = 1;
-  tokens.emplace_back(nextToken(itr, end));
-  while (tokens.back().type != TokenType::EndOfFile) {
-    i++;
-    tokens.emplace_back(nextToken(itr, end));
-    if (i == 200) {
+  for (size_t pos = 0; pos < tokens.size(); ++pos) {
+    if (tokens[pos].type != TokenType::Symbol) {
+      continue;
+    }
+    switch (getText(tokens[pos]).front()) {
+    case '{':
+      braces.push_back(pos);
+      break;
+    case '(':
+      parens.push_back(pos);
+      break;
+    case '[':
+      brackets.push_back(pos);
+      break;
+    case '}':
+      closeScope(braces, pos);
+      break;
+    case ')':
+      closeScope(parens, pos);
+      break;
+    case ']':
+      closeScope(brackets, pos);
+      break;
+    default:
       break;
     }
   }
-
-  return tokens;
 }
 
 Token PchorLexer::nextToken(std::string_view::iterator &itr,
                             const std::string_view::iterator &end) {
   skipToNextToken(itr, end);
+  uint32_t offset =
+      static_cast<uint32_t>(std::distance(file->getBuffer().begin(), itr));
 
   if (itr == end) {
-    return {TokenType::EndOfFile, std::string_view{itr, end}, line};
+    return {TokenType::EndOfFile, offset, 0};
   }
 
+  // the is* functions return itr when the token is not of their type
   auto possibleEnd = isSymbol(itr, end);
-  if (possibleEnd != end) {
-    std::string_view value(itr, std::distance(itr, possibleEnd));
+  if (possibleEnd != itr) {
+    const auto length =
+        static_cast<uint32_t>(std::distance(itr, possibleEnd));
     itr = possibleEnd;
-    return {TokenType::Symbol, value, line};
+    return {TokenType::Symbol, offset, length};
   }
 
   possibleEnd = isLiteral(itr, end);
-  if (possibleEnd != end) {
-    std::string_view value(itr, std::distance(itr, possibleEnd));
+  if (possibleEnd != itr) {
+    const auto length =
+        static_cast<uint32_t>(std::distance(itr, possibleEnd));
     itr = possibleEnd;
-    return {TokenType::Literal, value, line};
+    return {TokenType::Literal, offset, length};
   }
 
   possibleEnd = isKeyword(itr, end);
-  if (possibleEnd != end) {
-    std::string_view value(itr, std::distance(itr, possibleEnd));
+  if (possibleEnd != itr) {
+    const auto length =
+        static_cast<uint32_t>(std::distance(itr, possibleEnd));
     itr = possibleEnd;
-    return {TokenType::Keyword, value, line};
+    return {TokenType::Keyword, offset, length};
   }
 
   possibleEnd = isIdentifier(itr, end);
-  if (possibleEnd != end) {
-    std::string_view value(itr, std::distance(itr, possibleEnd));
+  if (possibleEnd != itr) {
+    const auto length =
+        static_cast<uint32_t>(std::distance(itr, possibleEnd));
     itr = possibleEnd;
-    return {TokenType::Identifier, value, line};
+    return {TokenType::Identifier, offset, length};
   }
 
-  std::string_view value(itr, std::distance(itr, itr + 1));
   itr++;
-  return {TokenType::Unknown, value, line};
+  return {TokenType::Unknown, offset, 1};
 }
 
 void PchorLexer::skipToNextToken(std::string_view::iterator &itr,
                                  const std::string_view::iterator &end) {
-  while (itr != end && std::isspace(*itr)) {
-    if (*itr == '\n') {
-      line++;
+  while (itr != end) {
+    if (std::isspace(static_cast<unsigned char>(*itr))) {
+      ++itr;
+    } else if (isCommentStart(itr, end)) {
+      // comments run until the end of the line
+      itr = std::find(itr, end, '\n');
+    } else {
+      return;
     }
+  }
+}
+
+bool PchorLexer::isCommentStart(std::string_view::iterator itr,
+                                const std::string_view::iterator &end) {
+  return *itr == '/' && (itr + 1) != end && *(itr + 1) == '/';
+}
+
+std::string_view::iterator
+PchorLexer::findWordEnd(std::string_view::iterator itr,
+                        const std::string_view::iterator &end) {
+  while (itr != end && !std::isspace(static_cast<unsigned char>(*itr)) &&
+         symbols.find(*itr) == std::string_view::npos &&
+         !isCommentStart(itr, end)) {
     ++itr;
   }
+  return itr;
 }
 
 std::string_view::iterator
 PchorLexer::isSymbol(std::string_view::iterator &itr,
                      const std::string_view::iterator &end) const {
   if (itr == end) {
-    return end;
+    return itr;
   }
   if (*itr == '-' && (itr + 1) != end && *(itr + 1) == '>') {
     return itr + 2; // Return iterator past "->"
@@ -118,30 +214,26 @@ PchorLexer::isSymbol(std::string_view::iterator &itr,
     return itr + 1;
   }
 
-  return end;
+  return itr;
 }
 
 std::string_view::iterator
 PchorLexer::isKeyword(std::string_view::iterator &itr,
                       const std::string_view::iterator &end) const {
-  auto spaceItr = std::find_if(itr, end, [](char c) {
-    return std::isspace(c) || symbols.find(c) != std::string_view::npos;
-  });
+  auto spaceItr = findWordEnd(itr, end);
   std::string_view possibleKeyword(&(*itr), std::distance(itr, spaceItr));
 
-  return keywords.find(possibleKeyword) != keywords.end() ? spaceItr : end;
+  return keywords.find(possibleKeyword) != keywords.end() ? spaceItr : itr;
 }
 
 std::string_view::iterator
 PchorLexer::isLiteral(std::string_view::iterator &itr,
                       const std::string_view::iterator &end) const {
   if (itr == end) {
-    return end;
+    return itr;
   }
 
-  if (*itr == 'n' && (itr + 1) != end &&
-      (symbols.find(*(itr + 1)) != std::string_view::npos ||
-       std::isspace(*(itr + 1)))) {
+  if (*itr == 'n' && findWordEnd(itr, end) == itr + 1) {
     return itr + 1;
   }
 
@@ -153,15 +245,13 @@ PchorLexer::isLiteral(std::string_view::iterator &itr,
     return incr_itr;
   }
 
-  return end;
+  return itr;
 }
 
 std::string_view::iterator
 PchorLexer::isIdentifier(std::string_view::iterator &itr,
                          const std::string_view::iterator &end) const {
-  return std::find_if(itr, end, [](char c) {
-    return std::isspace(c) || symbols.find(c) != std::string_view::npos;
-  });
+  return findWordEnd(itr, end);
 }
 
 } // namespace PchorAST
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+namespace PchorRuntime {
+
+// Assumed size of a cache line. Counters written by different threads are
+// kept this far apart, so no two writers share a line
+inline constexpr std::size_t cacheLineSize = 64;
+
+} // namespace PchorRuntime
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "MpscChannel.hpp"
+#include "SpscChannel.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace PchorRuntime {
+
+/*
+  Participants as C++20 coroutines, instantiated by the skeletons
+  PChorAnalyzer generates with --coroutines. A participant waiting for a
+  message suspends instead of spinning, so many participants share one
+  thread:
+
+    PchorRuntime::Task Kernel::run(Consumer &consumer) {
+      Data data = co_await d.recv();
+      co_await consumer.c.send(data);
+    }
+
+    PchorRuntime::Executor executor;
+    executor.spawn(kernel.run(consumer));
+    executor.run();
+
+  An Executor runs its tasks on the thread calling run. A suspended task is
+  parked in its run queue with the channel operation it waits for, which is
+  retried when the task comes round again, so a task is only resumed once
+  its message has been sent (or its send has found room). AsyncChannels wrap
+  the lock-free rings of the runtime, so participants may also be spread
+  over one Executor per thread. An Executor that finds every task waiting
+  yields its thread, as the blocking channels do.
+
+  Tasks may only await channels, as the executor does not know how to
+  resume a task suspended on anything else.
+*/
+
+// Coroutine of a participant, run by the Executor it is spawned on
+class Task {
+public:
+  struct promise_type {
+    std::exception_ptr exception{};
+
+    Task get_return_object() { return Task{Handle::from_promise(*this)}; }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+  Task(const Task &other) = delete;
+  Task &operator=(const Task &other) = delete;
+  Task &operator=(Task &&other) = delete;
+  // a task that is never spawned never runs
+  ~Task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+private:
+  Handle handle;
+
+  explicit Task(Handle handle) : handle(handle) {}
+
+  friend class Executor;
+};
+
+class Executor {
+public:
+  Executor() : queue() {}
+  ~Executor() {
+    for (const Waiting &waiting : queue) {
+      waiting.task.destroy();
+    }
+  }
+
+  Executor(const Executor &other) = delete;
+  Executor &operator=(const Executor &other) = delete;
+
+  void spawn(Task task) {
+    queue.push_back(Waiting{std::exchange(task.handle, {}), nullptr, nullptr});
+  }
+
+  // Runs the spawned tasks on the calling thread until all of them have
+  // finished. An exception leaving a task is rethrown, leaving the tasks that
+  // have not finished in the queue
+  void run() {
+    Running running{*this};
+    std::size_t stalled = 0;
+    while (!queue.empty()) {
+      Waiting waiting = queue.front();
+      queue.pop_front();
+      if (waiting.poll && !waiting.poll(waiting.awaiter)) {
+        queue.push_back(waiting);
+        // every task waits for another thread
+        if (++stalled >= queue.size()) {
+          std::this_thread::yield();
+          stalled = 0;
+        }
+        continue;
+      }
+      stalled = 0;
+      waiting.task.resume();
+      if (waiting.task.done()) {
+        std::exception_ptr exception = waiting.task.promise().exception;
+        waiting.task.destroy();
+        if (exception) {
+          std::rethrow_exception(exception);
+        }
+      }
+    }
+  }
+
+  // Executor running the calling thread's tasks
+  static Executor &current() { return *running; }
+
+  // Parks the suspended task until poll(awaiter) has completed the channel
+  // operation it waits for
+  void park(std::coroutine_handle<> task, bool (*poll)(void *),
+            void *awaiter) {
+    queue.push_back(
+        Waiting{Task::Handle::from_address(task.address()), poll, awaiter});
+  }
+
+private:
+  struct Waiting {
+    Task::Handle task;
+    // nullptr for a task that has not started
+    bool (*poll)(void *);
+    void *awaiter;
+  };
+  // makes an executor the current one while it runs
+  struct Running {
+    explicit Running(Executor &executor)
+        : previous(std::exchange(running, &executor)) {}
+    ~Running() { running = previous; }
+    Executor *previous;
+  };
+
+  std::deque<Waiting> queue;
+  inline static thread_local Executor *running = nullptr;
+};
+
+/*
+  Channel awaited by coroutines, over the ring of a blocking channel of the
+  runtime: an SpscChannel by default, or an MpscChannel for a reciever with
+  several senders. A participant recieves by awaiting recv on its own
+  channel field, and sends by awaiting send on the field of its peer:
+
+    Data data = co_await d.recv();
+    co_await consumer.c.send(data);
+
+  Its payload is the first template argument, which the analyzer matches
+  against the data type of a communication like any other wrapper.
+*/
+template <typename T, std::size_t Capacity,
+          template <typename, std::size_t> class Ring = SpscChannel>
+class AsyncChannel {
+public:
+  using value_type = T;
+  static constexpr std::size_t capacity = Capacity;
+
+  class RecvAwaiter {
+  public:
+    explicit RecvAwaiter(Ring<T, Capacity> &ring) : ring(ring), payload() {}
+
+    bool await_ready() { return poll(this); }
+    void await_suspend(std::coroutine_handle<> task) {
+      Executor::current().park(task, &poll, this);
+    }
+    T await_resume() { return std::move(*payload); }
+
+  private:
+    Ring<T, Capacity> &ring;
+    std::optional<T> payload;
+
+    static bool poll(void *awaiter) {
+      auto &self = *static_cast<RecvAwaiter *>(awaiter);
+      self.payload = self.ring.tryPop();
+      return self.payload.has_value();
+    }
+  };
+
+  class SendAwaiter {
+  public:
+    SendAwaiter(Ring<T, Capacity> &ring, T payload)
+        : ring(ring), payload(std::move(payload)) {}
+
+    bool await_ready() { return poll(this); }
+    void await_suspend(std::coroutine_handle<> task) {
+      Executor::current().park(task, &poll, this);
+    }
+    void await_resume() {}
+
+  private:
+    Ring<T, Capacity> &ring;
+    T payload;
+
+    // the payload is left in place while the ring is full
+    static bool poll(void *awaiter) {
+      auto &self = *static_cast<SendAwaiter *>(awaiter);
+      return self.ring.tryPush(std::move(self.payload));
+    }
+  };
+
+  AsyncChannel() : ring() {}
+
+  AsyncChannel(const AsyncChannel &other) = delete;
+  AsyncChannel &operator=(const AsyncChannel &other) = delete;
+
+  // Completes once a payload has been sent, with the payload
+  [[nodiscard]] RecvAwaiter recv() { return RecvAwaiter{ring}; }
+  // Completes once the ring has room for payload
+  [[nodiscard]] SendAwaiter send(T payload) {
+    return SendAwaiter{ring, std::move(payload)};
+  }
+
+  bool empty() const { return ring.empty(); }
+
+private:
+  Ring<T, Capacity> ring;
+};
+
+} // namespace PchorRuntime
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// PCHOR_MONITOR turns the conformance monitor on (1) or off (0). It follows
+// assertions by default, so release builds defining NDEBUG compile every
+// monitor down to nothing
+#ifndef PCHOR_MONITOR
+#ifdef NDEBUG
+#define PCHOR_MONITOR 0
+#else
+#define PCHOR_MONITOR 1
+#endif
+#endif
+
+namespace PchorRuntime {
+
+using MonitorState = uint16_t;
+// entry of a transition table for events a state does not allow
+inline constexpr MonitorState invalidState = 0xFFFF;
+
+/*
+  Local type of one participant compiled to a transition table, as generated
+  by PChorAnalyzer with --monitor. Row s holds the state following each event
+  in state s, so next[s * eventCount + event] is the only lookup a step takes.
+  State 0 is the initial state.
+*/
+struct MonitorTable {
+  const char *participant;
+  const char *const *eventNames;
+  std::size_t eventCount;
+  const MonitorState *next;
+  const bool *final;
+};
+
+struct MonitorViolation {
+  const char *participant;
+  MonitorState state;
+  const char *event;
+};
+
+using ViolationHandler = void (*)(const MonitorViolation &violation);
+
+inline void abortOnViolation(const MonitorViolation &violation) {
+  std::fprintf(stderr,
+               "pchor: %s sent or recieved %s in state %u, which its local "
+               "type does not allow\n",
+               violation.participant, violation.event,
+               static_cast<unsigned>(violation.state));
+  std::abort();
+}
+
+// Called with every violation, from the thread of the offending participant
+inline std::atomic<ViolationHandler> violationHandler{abortOnViolation};
+
+inline void setViolationHandler(ViolationHandler handler) {
+  violationHandler.store(handler, std::memory_order_relaxed);
+}
+
+#if PCHOR_MONITOR
+
+/*
+  Checks at runtime that one participant follows its local type. Every
+  instrumented send and recieve calls step with its event, which advances the
+  state by one table lookup, without allocating or locking. An event the
+  state does not allow is reported to the violation handler, and leaves the
+  state as it was.
+*/
+class Monitor {
+public:
+  explicit Monitor(const MonitorTable &table) : table(&table), state(0) {}
+
+  template <typename Event> void step(Event event) {
+    const auto column = static_cast<std::size_t>(event);
+    const MonitorState target = table->next[state * table->eventCount + column];
+    if (target == invalidState) [[unlikely]] {
+      violationHandler.load(std::memory_order_relaxed)(MonitorViolation{
+          table->participant, state, table->eventNames[column]});
+      return;
+    }
+    state = target;
+  }
+
+  // True once the participant has completed its local type
+  bool done() const { return table->final[state]; }
+  MonitorState getState() const { return state; }
+
+private:
+  const MonitorTable *table;
+  MonitorState state;
+};
+
+#else
+
+// Disabled monitor: holds nothing and checks nothing
+class Monitor {
+public:
+  explicit constexpr Monitor([[maybe_unused]] const MonitorTable &table) {}
+
+  template <typename Event> constexpr void step([[maybe_unused]] Event event) {}
+
+  constexpr bool done() const { return true; }
+  constexpr MonitorState getState() const { return 0; }
+};
+
+#endif
+
+} // namespace PchorRuntime
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "CacheLine.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace PchorRuntime {
+
+/*
+  Bounded lock-free channel from many senders to one reciever, for a
+  participant recieving from every index of a foreach. All senders combine
+  into one ring instead of one queue per sender, so the reciever polls a
+  single channel. Senders claim a slot by advancing the shared tail, and
+  every slot carries a sequence number telling whether it is free, or holds a
+  payload for the reciever. Slots are a cache line apart, so senders filling
+  neighbouring slots do not contend on a line.
+
+  Like the single-producer channel, sending is assignment and the reciever
+  waits on the channel in a loop:
+
+    reciever->channel = Result("payload"); // every sender
+
+    while (channel.empty()) {}             // reciever
+    Result result = channel.pop();
+*/
+template <typename T, std::size_t Capacity> class MpscChannel {
+  // with a single slot, a stored payload could not be told from a free slot
+  static_assert(Capacity > 1 && std::has_single_bit(Capacity),
+                "Capacity of a channel must be a power of two, and at least 2");
+
+public:
+  using value_type = T;
+  static constexpr std::size_t capacity = Capacity;
+
+  MpscChannel() : tail(0), consumer(), slots() {
+    for (std::size_t position = 0; position < Capacity; ++position) {
+      slots[position].sequence.store(position, std::memory_order_relaxed);
+    }
+  }
+  ~MpscChannel() {
+    std::size_t head = consumer.head.load(std::memory_order_relaxed);
+    while (isReady(head)) {
+      std::destroy_at(slotOf(head).payload());
+      ++head;
+    }
+  }
+
+  MpscChannel(const MpscChannel &other) = delete;
+  MpscChannel &operator=(const MpscChannel &other) = delete;
+  MpscChannel(MpscChannel &&other) = delete;
+  MpscChannel &operator=(MpscChannel &&other) = delete;
+
+  // Sends value, blocking while the channel is full
+  MpscChannel &operator=(const T &value) {
+    push(value);
+    return *this;
+  }
+  MpscChannel &operator=(T &&value) {
+    push(std::move(value));
+    return *this;
+  }
+
+  // Sender side, from any number of threads. Returns false, leaving value
+  // untouched, if the ring is full
+  template <typename U> bool tryPush(U &&value) {
+    std::size_t position = tail.load(std::memory_order_relaxed);
+    while (true) {
+      Slot &slot = slotOf(position);
+      const std::size_t sequence =
+          slot.sequence.load(std::memory_order_acquire);
+      const auto distance = static_cast<std::intptr_t>(sequence) -
+                            static_cast<std::intptr_t>(position);
+      if (distance == 0) {
+        if (tail.compare_exchange_weak(position, position + 1,
+                                       std::memory_order_relaxed)) {
+          std::construct_at(slot.rawPayload(), std::forward<U>(value));
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (distance < 0) {
+        // the slot still holds the payload of the previous round
+        return false;
+      } else {
+        position = tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  template <typename U> void push(U &&value) {
+    while (!tryPush(std::forward<U>(value))) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Reciever side
+  bool empty() const {
+    return !isReady(consumer.head.load(std::memory_order_acquire));
+  }
+  std::optional<T> tryPop() {
+    const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+    if (!isReady(head)) {
+      return std::nullopt;
+    }
+    return take(head);
+  }
+  // Blocks until a payload has been sent
+  T pop() {
+    const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+    while (!isReady(head)) {
+      std::this_thread::yield();
+    }
+    return take(head);
+  }
+
+private:
+  struct alignas(cacheLineSize) Slot {
+    // position + 1 once a payload is stored, position + Capacity once free
+    // for the next round
+    std::atomic<std::size_t> sequence;
+    alignas(T) std::byte storage[sizeof(T)];
+
+    T *rawPayload() { return reinterpret_cast<T *>(storage); }
+    T *payload() { return std::launder(rawPayload()); }
+  };
+  struct alignas(cacheLineSize) ConsumerEnd {
+    std::atomic<std::size_t> head{0};
+  };
+
+  alignas(cacheLineSize) std::atomic<std::size_t> tail;
+  ConsumerEnd consumer;
+  std::array<Slot, Capacity> slots;
+
+  Slot &slotOf(std::size_t position) {
+    return slots[position & (Capacity - 1)];
+  }
+  const Slot &slotOf(std::size_t position) const {
+    return slots[position & (Capacity - 1)];
+  }
+  bool isReady(std::size_t position) const {
+    return slotOf(position).sequence.load(std::memory_order_acquire) ==
+           position + 1;
+  }
+  // Moves the payload at head out of the ring, and frees its slot
+  T take(std::size_t head) {
+    Slot &slot = slotOf(head);
+    T *payload = slot.payload();
+    T value{std::move(*payload)};
+    std::destroy_at(payload);
+    slot.sequence.store(head + Capacity, std::memory_order_release);
+    consumer.head.store(head + 1, std::memory_order_release);
+    return value;
+  }
+};
+
+} // namespace PchorRuntime
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "CacheLine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace PchorRuntime {
+
+/*
+  Bounded lock-free channel from one sender to a fixed number of recievers,
+  for a participant sending the same payload to every index of a foreach.
+  Each payload is constructed once in a shared ring of Capacity slots, and
+  every reciever reads it through its own cursor, which lives on a cache
+  line of its own. A slot is reused once every cursor has moved past it.
+
+  A single assignment sends to all recievers, which PChorAnalyzer matches
+  against the whole run of sends over the channel's indices. Recievers are
+  numbered from 0 and wait on their own cursor:
+
+    channel = Order("payload");                // sender
+
+    while (sender->channel.empty(reciever)) {} // reciever
+    const Order &order = sender->channel.front(reciever);
+    ...
+    sender->channel.release(reciever);
+
+  front() hands out the shared payload without copying it, and pop() copies
+  it for recievers that keep it.
+*/
+template <typename T, std::size_t Capacity, std::size_t Recievers>
+class MulticastChannel {
+  static_assert(Capacity > 0 && std::has_single_bit(Capacity),
+                "Capacity of a channel must be a power of two");
+  static_assert(Recievers > 0, "A multicast channel needs a reciever");
+
+public:
+  using value_type = T;
+  static constexpr std::size_t capacity = Capacity;
+  static constexpr std::size_t recievers = Recievers;
+
+  MulticastChannel() : producer(), cursors() {}
+  ~MulticastChannel() {
+    // slots are only destroyed when reused, so the last Capacity are alive
+    const std::size_t tail = producer.tail.load(std::memory_order_acquire);
+    for (std::size_t position = tail - std::min(tail, Capacity);
+         position != tail; ++position) {
+      std::destroy_at(slot(position));
+    }
+  }
+
+  MulticastChannel(const MulticastChannel &other) = delete;
+  MulticastChannel &operator=(const MulticastChannel &other) = delete;
+  MulticastChannel(MulticastChannel &&other) = delete;
+  MulticastChannel &operator=(MulticastChannel &&other) = delete;
+
+  // Sends value to every reciever, blocking while the slowest is behind
+  MulticastChannel &operator=(const T &value) {
+    push(value);
+    return *this;
+  }
+  MulticastChannel &operator=(T &&value) {
+    push(std::move(value));
+    return *this;
+  }
+
+  // Sender side. Returns false, leaving value untouched, if the ring is full
+  template <typename U> bool tryPush(U &&value) {
+    const std::size_t tail = producer.tail.load(std::memory_order_relaxed);
+    if (tail - producer.cachedHead == Capacity) {
+      producer.cachedHead = slowestHead();
+      if (tail - producer.cachedHead == Capacity) {
+        return false;
+      }
+    }
+    if (tail >= Capacity) {
+      std::destroy_at(slot(tail));
+    }
+    std::construct_at(rawSlot(tail), std::forward<U>(value));
+    producer.tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  template <typename U> void push(U &&value) {
+    while (!tryPush(std::forward<U>(value))) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Reciever side, for reciever 0 to Recievers - 1
+  bool empty(std::size_t reciever) const {
+    return cursors[reciever].head.load(std::memory_order_acquire) ==
+           producer.tail.load(std::memory_order_acquire);
+  }
+  // Blocks until a payload has been sent, which stays valid until release
+  const T &front(std::size_t reciever) {
+    Cursor &cursor = cursors[reciever];
+    const std::size_t head = cursor.head.load(std::memory_order_relaxed);
+    while (head == cursor.cachedTail) {
+      cursor.cachedTail = producer.tail.load(std::memory_order_acquire);
+      if (head == cursor.cachedTail) {
+        std::this_thread::yield();
+      }
+    }
+    return *slot(head);
+  }
+  void release(std::size_t reciever) {
+    Cursor &cursor = cursors[reciever];
+    cursor.head.store(cursor.head.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_release);
+  }
+  T pop(std::size_t reciever) {
+    T value{front(reciever)};
+    release(reciever);
+    return value;
+  }
+  std::optional<T> tryPop(std::size_t reciever) {
+    if (empty(reciever)) {
+      return std::nullopt;
+    }
+    return pop(reciever);
+  }
+
+private:
+  struct alignas(cacheLineSize) ProducerEnd {
+    std::atomic<std::size_t> tail{0};
+    // a lower bound of every cursor
+    std::size_t cachedHead{0};
+  };
+  struct alignas(cacheLineSize) Cursor {
+    std::atomic<std::size_t> head{0};
+    std::size_t cachedTail{0};
+  };
+
+  ProducerEnd producer;
+  std::array<Cursor, Recievers> cursors;
+  alignas(cacheLineSize) alignas(T) std::byte storage[sizeof(T) * Capacity];
+
+  std::size_t slowestHead() const {
+    std::size_t head = producer.tail.load(std::memory_order_relaxed);
+    for (const Cursor &cursor : cursors) {
+      head = std::min(head, cursor.head.load(std::memory_order_acquire));
+    }
+    return head;
+  }
+  // storage of the slot, to construct a payload in
+  T *rawSlot(std::size_t position) {
+    return reinterpret_cast<T *>(storage +
+                                 (position & (Capacity - 1)) * sizeof(T));
+  }
+  // payload constructed in the slot
+  T *slot(std::size_t position) { return std::launder(rawSlot(position)); }
+};
+
+} // namespace PchorRuntime
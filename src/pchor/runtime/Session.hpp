@@ -0,0 +1,152 @@
+#pragma once
+
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace PchorRuntime {
+
+/*
+  Typestate session API, instantiated by the header PChorAnalyzer generates
+  with --session. Every state of a participant's local type is a type of its
+  own, whose only methods are the communications the state allows, and each
+  returns the state following it:
+
+    auto s0 = PchorSession::Kernel_1::start(kernel);
+    auto [data, s1] = std::move(s0).recv();
+    auto [key, s2] = std::move(s1).recv();
+    auto s3 = std::move(s2).send(*consumer, data);
+
+  so communicating out of order does not compile. A state holds a pointer to
+  its participant and every method inlines to the channel operation, so the
+  API costs nothing over using the channels directly. Methods are rvalue
+  qualified and nodiscard, which flags (through use-after-move diagnostics)
+  a state that is used twice.
+
+  Channels are reached through accessors naming the field of a participant,
+  so sending writes the field of the peer and recieving pops the field of
+  the participant itself, like the channels of --channels.
+*/
+
+// Peer of a send whose reciever is not known, which is then not checked
+struct AnyPeer {};
+
+// Only the session API can create a state, so every state is reached by
+// following the protocol from its start
+class SessionKey {
+  SessionKey() = default;
+
+  template <typename Self> friend class SessionState;
+  template <typename State, typename Self>
+  friend State startSession(Self &self);
+};
+
+template <typename Self> class SessionState {
+public:
+  SessionState(Self &self, [[maybe_unused]] SessionKey key) : self(&self) {}
+
+  // a copy would let a state be used twice, while moving hands it on
+  SessionState(const SessionState &other) = delete;
+  SessionState &operator=(const SessionState &other) = delete;
+  SessionState(SessionState &&other) noexcept = default;
+  SessionState &operator=(SessionState &&other) noexcept = default;
+
+protected:
+  Self *self;
+
+  template <typename Next> Next next() const {
+    return Next{*self, SessionKey{}};
+  }
+};
+
+template <typename State, typename Self> State startSession(Self &self) {
+  return State{self, SessionKey{}};
+}
+
+// Branch of a choice, continuing in State after Label
+template <auto Label, typename Next> struct Case {
+  static constexpr auto label = Label;
+  using State = Next;
+  State state;
+};
+
+template <auto Label, typename... Cases> struct CaseOf;
+template <auto Label> struct CaseOf<Label> {
+  static_assert(Label != Label, "Label is not a branch of this choice");
+};
+template <auto Label, typename First, typename... Rest>
+struct CaseOf<Label, First, Rest...>
+    : std::conditional_t<First::label == Label, First,
+                         CaseOf<Label, Rest...>> {};
+
+template <typename Self, typename Peer, typename Channel, typename Payload,
+          typename Next>
+class Send : public SessionState<Self> {
+public:
+  using SessionState<Self>::SessionState;
+
+  template <typename P> [[nodiscard]] Next send(P &peer, Payload payload) && {
+    static_assert(std::is_same_v<Peer, AnyPeer> || std::is_same_v<P, Peer>,
+                  "Payload is sent to the wrong participant");
+    Channel::of(peer) = std::move(payload);
+    return this->template next<Next>();
+  }
+};
+
+template <typename Self, typename Channel, typename Payload, typename Next>
+class Recv : public SessionState<Self> {
+public:
+  using SessionState<Self>::SessionState;
+
+  // Blocks until the payload has been sent
+  [[nodiscard]] std::pair<Payload, Next> recv() && {
+    Payload payload = Channel::of(*this->self).pop();
+    return {std::move(payload), this->template next<Next>()};
+  }
+};
+
+template <typename Self, typename Peer, typename Channel, typename... Cases>
+class Select : public SessionState<Self> {
+public:
+  using SessionState<Self>::SessionState;
+
+  template <auto Label, typename P>
+  [[nodiscard]] typename CaseOf<Label, Cases...>::State select(P &peer) && {
+    static_assert(std::is_same_v<Peer, AnyPeer> || std::is_same_v<P, Peer>,
+                  "Label is sent to the wrong participant");
+    Channel::of(peer) = Label;
+    return this->template next<typename CaseOf<Label, Cases...>::State>();
+  }
+};
+
+template <typename Self, typename Channel, typename... Cases>
+class Branch : public SessionState<Self> {
+public:
+  using SessionState<Self>::SessionState;
+
+  // Blocks until a label has been sent, and continues in its branch
+  [[nodiscard]] std::variant<Cases...> branch() && {
+    const auto label = Channel::of(*this->self).pop();
+    std::optional<std::variant<Cases...>> taken{};
+    ((label == Cases::label
+          ? (void)taken.emplace(
+                std::in_place_type<Cases>,
+                Cases{this->template next<typename Cases::State>()})
+          : (void)0),
+     ...);
+    if (!taken) {
+      throw std::runtime_error("Recieved a label the branching does not have");
+    }
+    return std::move(*taken);
+  }
+};
+
+// Completed local type
+template <typename Self> class End : public SessionState<Self> {
+public:
+  using SessionState<Self>::SessionState;
+};
+
+} // namespace PchorRuntime
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "CacheLine.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace PchorRuntime {
+
+/*
+  Bounded lock-free channel between one sending and one recieving thread.
+  Payloads live in a ring of Capacity slots, indexed by a head counter owned
+  by the consumer and a tail counter owned by the producer. Each end keeps a
+  cached copy of the other end's counter on its own cache line, and only
+  reloads it when the ring looks full (or empty), so the counters are not
+  bounced between cores on every message. Blocking ends yield while they
+  wait, so a channel also makes progress on an oversubscribed machine.
+
+  Sending is assignment, which blocks while the ring is full. A channel field
+  is therefore sent on the way PChorAnalyzer expects any channel to be:
+
+    channel = Data("payload");
+
+  and recieved from by waiting on it in a loop:
+
+    while (channel.empty()) {}
+    Data data = channel.pop();
+
+  Its payload is the first template argument, which the analyzer matches
+  against the data type of a communication like any other wrapper.
+*/
+template <typename T, std::size_t Capacity> class SpscChannel {
+  static_assert(Capacity > 0 && std::has_single_bit(Capacity),
+                "Capacity of a channel must be a power of two");
+
+public:
+  using value_type = T;
+  static constexpr std::size_t capacity = Capacity;
+
+  SpscChannel() : producer(), consumer() {}
+  ~SpscChannel() {
+    const std::size_t tail = producer.tail.load(std::memory_order_acquire);
+    for (std::size_t head = consumer.head.load(std::memory_order_relaxed);
+         head != tail; ++head) {
+      std::destroy_at(slot(head));
+    }
+  }
+
+  SpscChannel(const SpscChannel &other) = delete;
+  SpscChannel &operator=(const SpscChannel &other) = delete;
+  SpscChannel(SpscChannel &&other) = delete;
+  SpscChannel &operator=(SpscChannel &&other) = delete;
+
+  // Sends value, blocking while the channel is full
+  SpscChannel &operator=(const T &value) {
+    push(value);
+    return *this;
+  }
+  SpscChannel &operator=(T &&value) {
+    push(std::move(value));
+    return *this;
+  }
+
+  // Producer side. Returns false, leaving value untouched, if the ring is full
+  template <typename U> bool tryPush(U &&value) {
+    const std::size_t tail = producer.tail.load(std::memory_order_relaxed);
+    if (tail - producer.cachedHead == Capacity) {
+      producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+      if (tail - producer.cachedHead == Capacity) {
+        return false;
+      }
+    }
+    std::construct_at(rawSlot(tail), std::forward<U>(value));
+    producer.tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  template <typename U> void push(U &&value) {
+    while (!tryPush(std::forward<U>(value))) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Consumer side. Returns nothing if no payload has been sent
+  std::optional<T> tryPop() {
+    const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+    if (head == consumer.cachedTail) {
+      consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+      if (head == consumer.cachedTail) {
+        return std::nullopt;
+      }
+    }
+    return take(head);
+  }
+  // Blocks until a payload has been sent
+  T pop() {
+    const std::size_t head = consumer.head.load(std::memory_order_relaxed);
+    while (head == consumer.cachedTail) {
+      consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+      if (head == consumer.cachedTail) {
+        std::this_thread::yield();
+      }
+    }
+    return take(head);
+  }
+
+  // May be called from either end, and is exact from the consumer's
+  bool empty() const {
+    return consumer.head.load(std::memory_order_acquire) ==
+           producer.tail.load(std::memory_order_acquire);
+  }
+  std::size_t size() const {
+    return producer.tail.load(std::memory_order_acquire) -
+           consumer.head.load(std::memory_order_acquire);
+  }
+
+private:
+  struct alignas(cacheLineSize) ProducerEnd {
+    std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead{0};
+  };
+  struct alignas(cacheLineSize) ConsumerEnd {
+    std::atomic<std::size_t> head{0};
+    std::size_t cachedTail{0};
+  };
+
+  ProducerEnd producer;
+  ConsumerEnd consumer;
+  alignas(cacheLineSize) alignas(T) std::byte storage[sizeof(T) * Capacity];
+
+  // storage of the slot, to construct a payload in
+  T *rawSlot(std::size_t position) {
+    return reinterpret_cast<T *>(storage +
+                                 (position & (Capacity - 1)) * sizeof(T));
+  }
+  // payload constructed in the slot
+  T *slot(std::size_t position) { return std::launder(rawSlot(position)); }
+  // Moves the payload at head out of the ring, and hands its slot back
+  T take(std::size_t head) {
+    T *payload = slot(head);
+    T value{std::move(*payload)};
+    std::destroy_at(payload);
+    consumer.head.store(head + 1, std::memory_order_release);
+    return value;
+  }
+};
+
+} // namespace PchorRuntime
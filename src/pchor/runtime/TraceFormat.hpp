@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PchorRuntime {
+
+/*
+  Binary trace file written by TraceRecorder and read by pchor-trace-check.
+  A trace is a TraceFileHeader followed by chunks, each a TraceChunk header
+  and its body, padded to traceAlignment:
+
+  - Participant: announces stream id participant, with the name of the
+    participant ("Worker[2]") as body of size bytes
+  - Events: size TraceRecords of stream participant, in the order they were
+    recorded
+  - Dropped: size records of stream participant were lost to a full buffer,
+    so the events following it do not continue the events before it
+
+  Values are stored in the byte order of the recording machine. A process
+  stopped mid-flush leaves a truncated last chunk, which readers ignore.
+*/
+
+inline constexpr char traceMagic[8] = {'P', 'C', 'H', 'O', 'R', 'T', 'R', 'C'};
+inline constexpr uint32_t traceVersion = 1;
+inline constexpr std::size_t traceAlignment = 8;
+
+struct TraceFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+enum class TraceChunkKind : uint32_t { Participant = 1, Events = 2, Dropped = 3 };
+
+struct TraceChunk {
+  TraceChunkKind kind;
+  uint32_t participant;
+  uint64_t size;
+};
+
+// A recorded event: nanoseconds since the recorder started in the upper 48
+// bits, and the event of the participant's monitor table in the lower 16
+using TraceRecord = uint64_t;
+
+constexpr TraceRecord makeTraceRecord(uint64_t time, uint16_t event) {
+  return (time << 16) | event;
+}
+constexpr uint16_t traceEvent(TraceRecord record) {
+  return static_cast<uint16_t>(record & 0xFFFF);
+}
+constexpr uint64_t traceTime(TraceRecord record) { return record >> 16; }
+
+constexpr std::size_t tracePadding(std::size_t size) {
+  return (traceAlignment - size % traceAlignment) % traceAlignment;
+}
+
+static_assert(sizeof(TraceFileHeader) % traceAlignment == 0);
+static_assert(sizeof(TraceChunk) % traceAlignment == 0);
+static_assert(sizeof(TraceRecord) == traceAlignment);
+
+} // namespace PchorRuntime
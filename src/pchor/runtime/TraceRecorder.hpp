@@ -0,0 +1,220 @@
+#pragma once
+
+#include "Monitor.hpp"
+#include "SpscChannel.hpp"
+#include "TraceFormat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace PchorRuntime {
+
+// Records a participant may have recorded but not yet flushed
+inline constexpr std::size_t traceBufferCapacity = std::size_t{1} << 14;
+
+// Event of an in-band record telling how many records were dropped before it
+inline constexpr uint16_t droppedEvent = 0xFFFF;
+
+/*
+  Ring of events recorded by one participant thread, drained by the flusher.
+  Recording never blocks: an event that does not fit a full ring is counted
+  as dropped instead, and the count is recorded in-band ahead of the next
+  event that fits, so the flusher knows exactly where the gap is.
+*/
+class TraceBuffer {
+public:
+  TraceBuffer(uint32_t id, std::string participant)
+      : id(id), participant(std::move(participant)), ring(), pending(0) {}
+
+  const uint32_t id;
+  const std::string participant;
+  SpscChannel<TraceRecord, traceBufferCapacity> ring;
+  // drops not yet recorded in the ring, written by the recording thread only
+  std::atomic<uint64_t> pending;
+};
+
+/*
+  Handle through which one participant thread records its events, by the
+  event enumeration of its generated monitor table. A tracer belongs to a
+  single thread, and to the recorder it came from, which must outlive it.
+*/
+class Tracer {
+public:
+  template <typename Event> void record(Event event) {
+    const auto time = std::chrono::steady_clock::now() - start;
+    const TraceRecord record = makeTraceRecord(
+        static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(time)
+                .count()),
+        static_cast<uint16_t>(event));
+    const uint64_t pending = buffer->pending.load(std::memory_order_relaxed);
+    if (pending != 0) [[unlikely]] {
+      if (!buffer->ring.tryPush(makeTraceRecord(pending, droppedEvent))) {
+        buffer->pending.store(pending + 1, std::memory_order_relaxed);
+        return;
+      }
+      buffer->pending.store(0, std::memory_order_relaxed);
+    }
+    if (!buffer->ring.tryPush(record)) [[unlikely]] {
+      buffer->pending.store(1, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  friend class TraceRecorder;
+
+  Tracer(TraceBuffer &buffer, std::chrono::steady_clock::time_point start)
+      : buffer(&buffer), start(start) {}
+
+  TraceBuffer *buffer;
+  std::chrono::steady_clock::time_point start;
+};
+
+/*
+  Records the events of every participant of a process to a binary trace
+  file (TraceFormat.hpp), for checking against the choreography after the
+  fact with pchor-trace-check. Every participant thread records into a ring
+  of its own, without locks, and a flusher thread appends the rings to the
+  file every flushInterval, so a crashed process loses at most the events of
+  the last interval:
+
+    PchorRuntime::TraceRecorder recorder{"run.pctrace"};
+    // in the thread of Worker[i]
+    PchorRuntime::Tracer trace = recorder.participant(
+        PchorMonitor::Worker::table(i));
+    trace.record(PchorMonitor::Worker::recv_c_Data);
+*/
+class TraceRecorder {
+public:
+  static constexpr std::chrono::milliseconds flushInterval{10};
+
+  explicit TraceRecorder(const std::string &path)
+      : start(std::chrono::steady_clock::now()), file(nullptr), mutex(),
+        wakeup(), buffers(), announced(0), flusher() {
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+      throw std::runtime_error("Could not open " + path +
+                               " to write the trace to");
+    }
+    TraceFileHeader header{{}, traceVersion, 0};
+    std::copy(std::begin(traceMagic), std::end(traceMagic), header.magic);
+    std::fwrite(&header, sizeof(header), 1, file);
+    flusher = std::jthread([this](std::stop_token stop) { run(stop); });
+  }
+  ~TraceRecorder() {
+    flusher.request_stop();
+    flusher.join();
+    // tracers are done by now, so drops after their last event are kept too
+    flush(true);
+    std::fclose(file);
+  }
+
+  TraceRecorder(const TraceRecorder &other) = delete;
+  TraceRecorder &operator=(const TraceRecorder &other) = delete;
+  TraceRecorder(TraceRecorder &&other) = delete;
+  TraceRecorder &operator=(TraceRecorder &&other) = delete;
+
+  // Registers a participant, named "Name[index]" as in its monitor table
+  Tracer participant(std::string_view name) {
+    std::lock_guard lock{mutex};
+    const auto id = static_cast<uint32_t>(buffers.size());
+    buffers.push_back(std::make_unique<TraceBuffer>(id, std::string(name)));
+    return Tracer{*buffers.back(), start};
+  }
+  Tracer participant(const MonitorTable &table) {
+    return participant(table.participant);
+  }
+
+  // Appends every recorded event to the file
+  void flush() { flush(false); }
+
+private:
+  std::chrono::steady_clock::time_point start;
+  std::FILE *file;
+  std::mutex mutex;
+  std::condition_variable_any wakeup;
+  std::vector<std::unique_ptr<TraceBuffer>> buffers;
+  // buffers whose Participant chunk has been written
+  std::size_t announced;
+  std::jthread flusher;
+
+  void flush(bool last) {
+    std::lock_guard lock{mutex};
+    for (; announced < buffers.size(); ++announced) {
+      const std::string &name = buffers[announced]->participant;
+      writeChunk(TraceChunkKind::Participant, buffers[announced]->id,
+                 name.size());
+      std::fwrite(name.data(), 1, name.size(), file);
+      writePadding(name.size());
+    }
+    for (const auto &buffer : buffers) {
+      drain(*buffer);
+      const uint64_t pending = buffer->pending.load(std::memory_order_relaxed);
+      if (last && pending != 0) {
+        writeChunk(TraceChunkKind::Dropped, buffer->id, pending);
+      }
+    }
+    std::fflush(file);
+  }
+
+  void run(std::stop_token stop) {
+    while (!stop.stop_requested()) {
+      {
+        std::unique_lock lock{mutex};
+        wakeup.wait_for(lock, stop, flushInterval, [] { return false; });
+      }
+      flush();
+    }
+  }
+
+  void drain(TraceBuffer &buffer) {
+    std::array<TraceRecord, 1024> batch;
+    std::size_t count = 0;
+    while (auto record = buffer.ring.tryPop()) {
+      if (traceEvent(*record) == droppedEvent) {
+        writeEvents(buffer.id, batch.data(), count);
+        writeChunk(TraceChunkKind::Dropped, buffer.id, traceTime(*record));
+        count = 0;
+        continue;
+      }
+      batch[count++] = *record;
+      if (count == batch.size()) {
+        writeEvents(buffer.id, batch.data(), count);
+        count = 0;
+      }
+    }
+    writeEvents(buffer.id, batch.data(), count);
+  }
+
+  void writeEvents(uint32_t id, const TraceRecord *records, std::size_t count) {
+    if (count == 0) {
+      return;
+    }
+    writeChunk(TraceChunkKind::Events, id, count);
+    std::fwrite(records, sizeof(TraceRecord), count, file);
+  }
+  void writeChunk(TraceChunkKind kind, uint32_t id, uint64_t size) {
+    const TraceChunk chunk{kind, id, size};
+    std::fwrite(&chunk, sizeof(chunk), 1, file);
+  }
+  void writePadding(std::size_t size) {
+    static constexpr std::array<char, traceAlignment> zeros{};
+    std::fwrite(zeros.data(), 1, tracePadding(size), file);
+  }
+};
+
+} // namespace PchorRuntime
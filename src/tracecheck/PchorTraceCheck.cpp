@@ -0,0 +1,124 @@
+#include "TraceChecker.hpp"
+
+#include "../analyzer/PchorAnalysis.hpp"
+
+#include <clang/Frontend/ASTUnit.h>
+#include <clang/Tooling/Tooling.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <string>
+#include <thread>
+
+/*
+  Usage:
+    pchor-trace-check --cor=<path_to_cor-file> [--jobs=<n>] <trace>
+
+  Checks a trace recorded with PchorRuntime::TraceRecorder against the
+  projections of the choreography, and prints one line per participant.
+  Exits with 1 if any participant violated its local type.
+*/
+
+namespace {
+
+const char *verdictName(PchorAST::TraceVerdict verdict) {
+  switch (verdict) {
+  case PchorAST::TraceVerdict::Conforms:
+    return "conforms";
+  case PchorAST::TraceVerdict::Unfinished:
+    return "unfinished";
+  case PchorAST::TraceVerdict::Incomplete:
+    return "incomplete";
+  case PchorAST::TraceVerdict::Violation:
+    return "violation";
+  case PchorAST::TraceVerdict::Unknown:
+    return "unknown participant";
+  case PchorAST::TraceVerdict::Untraced:
+    return "not traced";
+  }
+  return "";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string corFilePath;
+  std::string tracePath;
+  size_t jobs = std::max(std::thread::hardware_concurrency(), 1u);
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    if (arg.starts_with("--cor=")) {
+      corFilePath = arg.substr(6);
+    } else if (arg.starts_with("--jobs=")) {
+      const std::string value = arg.substr(7);
+      const auto [ptr, ec] =
+          std::from_chars(value.data(), value.data() + value.size(), jobs);
+      if (ec != std::errc{} || ptr != value.data() + value.size() ||
+          jobs == 0) {
+        llvm::errs() << "Error: --jobs expects a positive number\n";
+        return 1;
+      }
+    } else {
+      tracePath = arg;
+    }
+  }
+
+  if (corFilePath.empty() || tracePath.empty()) {
+    llvm::errs() << "Error: Usage is pchor-trace-check "
+                    "--cor=<path_to_file> [--jobs=<n>] <trace>\n";
+    return 1;
+  }
+
+  try {
+    auto sTable = PchorAST::parseChoreography(corFilePath, false);
+    // projection needs no translation unit, only a context to run in
+    std::unique_ptr<clang::ASTUnit> unit = clang::tooling::buildASTFromCode("");
+    auto projection =
+        PchorAST::projectChoreography(unit->getASTContext(), *sTable);
+    PchorAST::MonitorGenerator monitors{*projection};
+
+    PchorAST::TraceFile trace{tracePath};
+    PchorAST::TraceChecker checker{monitors, trace};
+    if (checker.isTruncated()) {
+      llvm::outs() << "Trace ends in a partly written chunk, which is "
+                      "ignored\n";
+    }
+
+    int status = 0;
+    for (const auto &result : checker.check(jobs)) {
+      std::string line = std::format("{}: {}", result.participant,
+                                     verdictName(result.verdict));
+      switch (result.verdict) {
+      case PchorAST::TraceVerdict::Conforms:
+        line += std::format(", {} events", result.events);
+        break;
+      case PchorAST::TraceVerdict::Unfinished:
+        line += std::format(" in state {} after {} events", result.state,
+                            result.events);
+        break;
+      case PchorAST::TraceVerdict::Incomplete:
+        line += std::format(", {} events dropped after {} events",
+                            result.dropped, result.events);
+        break;
+      case PchorAST::TraceVerdict::Violation:
+        line += std::format(": {} not allowed in state {}, event {}",
+                            result.detail, result.state, result.events);
+        status = 1;
+        break;
+      case PchorAST::TraceVerdict::Unknown:
+        status = 1;
+        break;
+      case PchorAST::TraceVerdict::Untraced:
+        break;
+      }
+      llvm::outs() << line << "\n";
+    }
+    return status;
+  } catch (const std::exception &e) {
+    llvm::errs() << "pchor-trace-check: " << e.what() << "\n";
+    return 1;
+  }
+}
@@ -0,0 +1,259 @@
+#include "TraceChecker.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <format>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace PchorAST {
+
+using PchorRuntime::TraceChunk;
+using PchorRuntime::TraceChunkKind;
+using PchorRuntime::TraceRecord;
+
+TraceFile::TraceFile(const std::string &path) : bytes(nullptr), length(0) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error(
+        std::format("Could not open trace {}: {}", path, strerror(errno)));
+  }
+  struct stat status{};
+  if (fstat(fd, &status) == -1) {
+    close(fd);
+    throw std::runtime_error(
+        std::format("Could not read trace {}: {}", path, strerror(errno)));
+  }
+  length = static_cast<size_t>(status.st_size);
+  if (length == 0) {
+    close(fd);
+    throw std::runtime_error(std::format("Trace {} is empty", path));
+  }
+  void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error(
+        std::format("Could not map trace {}: {}", path, strerror(errno)));
+  }
+  // every checker thread reads the trace front to back once
+  madvise(mapping, length, MADV_SEQUENTIAL);
+  bytes = static_cast<const std::byte *>(mapping);
+}
+
+TraceFile::~TraceFile() {
+  munmap(const_cast<std::byte *>(bytes), length);
+}
+
+namespace {
+
+// Splits "Name[index]" into its name and index
+bool parseParticipant(std::string_view participant, std::string &name,
+                      size_t &index) {
+  const size_t open = participant.find('[');
+  if (open == std::string_view::npos || !participant.ends_with(']')) {
+    return false;
+  }
+  const char *first = participant.data() + open + 1;
+  const char *last = participant.data() + participant.size() - 1;
+  const auto [ptr, ec] = std::from_chars(first, last, index);
+  if (ec != std::errc{} || ptr != last) {
+    return false;
+  }
+  name = participant.substr(0, open);
+  return true;
+}
+
+} // namespace
+
+TraceChecker::TraceChecker(const MonitorGenerator &monitors,
+                           const TraceFile &trace)
+    : monitors(monitors), trace(trace), streams(), end(0) {
+  PchorRuntime::TraceFileHeader header{};
+  if (trace.size() < sizeof(header)) {
+    throw std::runtime_error("Trace is too short to hold a trace header");
+  }
+  std::memcpy(&header, trace.data(), sizeof(header));
+  if (!std::equal(std::begin(header.magic), std::end(header.magic),
+                  std::begin(PchorRuntime::traceMagic))) {
+    throw std::runtime_error("File is not a PChorAnalyzer trace");
+  }
+  if (header.version != PchorRuntime::traceVersion) {
+    throw std::runtime_error(
+        std::format("Trace has version {}, expected version {}",
+                    header.version, PchorRuntime::traceVersion));
+  }
+
+  size_t offset = sizeof(header);
+  while (offset + sizeof(TraceChunk) <= trace.size()) {
+    const TraceChunk chunk = chunkAt(offset);
+    if (chunk.kind != TraceChunkKind::Participant &&
+        chunk.kind != TraceChunkKind::Events &&
+        chunk.kind != TraceChunkKind::Dropped) {
+      throw std::runtime_error(
+          std::format("Malformed trace: unknown chunk at offset {}", offset));
+    }
+    // a chunk the recording process did not finish writing
+    if (chunk.size > trace.size() ||
+        offset + sizeof(TraceChunk) + bodySize(chunk) > trace.size()) {
+      break;
+    }
+    if (chunk.kind == TraceChunkKind::Participant) {
+      if (chunk.participant >= streams.size()) {
+        streams.resize(chunk.participant + 1);
+      }
+      Stream &stream = streams[chunk.participant];
+      stream.participant.assign(
+          reinterpret_cast<const char *>(trace.data() + offset +
+                                         sizeof(TraceChunk)),
+          chunk.size);
+
+      std::string name{};
+      size_t index = 0;
+      const auto &participants = monitors.getParticipants();
+      if (parseParticipant(stream.participant, name, index)) {
+        const auto it = participants.find(name);
+        if (it != participants.end()) {
+          const auto &tables = it->second.tables;
+          const auto table = std::find_if(
+              tables.begin(), tables.end(),
+              [index](const auto &table) { return table.index == index; });
+          if (table != tables.end()) {
+            stream.monitor = &it->second;
+            stream.table = &*table;
+          }
+        }
+      }
+    } else if (chunk.participant >= streams.size() ||
+               streams[chunk.participant].participant.empty()) {
+      throw std::runtime_error(std::format(
+          "Malformed trace: events of stream {} before it is announced",
+          chunk.participant));
+    }
+    offset += sizeof(TraceChunk) + bodySize(chunk);
+  }
+  end = offset;
+}
+
+TraceChunk TraceChecker::chunkAt(size_t offset) const {
+  TraceChunk chunk{};
+  std::memcpy(&chunk, trace.data() + offset, sizeof(chunk));
+  return chunk;
+}
+
+size_t TraceChecker::bodySize(const TraceChunk &chunk) {
+  switch (chunk.kind) {
+  case TraceChunkKind::Participant:
+    return chunk.size + PchorRuntime::tracePadding(chunk.size);
+  case TraceChunkKind::Events:
+    return chunk.size * sizeof(TraceRecord);
+  case TraceChunkKind::Dropped:
+    return 0;
+  }
+  return 0;
+}
+
+std::vector<TraceResult> TraceChecker::check(size_t jobs) const {
+  jobs = std::clamp<size_t>(jobs, 1, std::max<size_t>(streams.size(), 1));
+  std::vector<TraceResult> results(streams.size());
+  {
+    std::vector<std::jthread> workers{};
+    for (size_t job = 0; job < jobs; ++job) {
+      workers.emplace_back(
+          [this, job, jobs, &results] { checkStreams(job, jobs, results); });
+    }
+  }
+
+  std::set<std::string> traced{};
+  for (const Stream &stream : streams) {
+    traced.insert(stream.participant);
+  }
+  for (const auto &[name, participant] : monitors.getParticipants()) {
+    for (const auto &table : participant.tables) {
+      std::string key = std::format("{}[{}]", name, table.index);
+      if (!traced.contains(key)) {
+        results.push_back(
+            TraceResult{std::move(key), TraceVerdict::Untraced, 0, 0, 0, ""});
+      }
+    }
+  }
+  return results;
+}
+
+void TraceChecker::checkStreams(size_t job, size_t jobs,
+                                std::vector<TraceResult> &results) const {
+  for (size_t id = job; id < streams.size(); id += jobs) {
+    results[id] = TraceResult{streams[id].participant,
+                              streams[id].table ? TraceVerdict::Unfinished
+                                                : TraceVerdict::Unknown,
+                              0, 0, 0, ""};
+  }
+
+  size_t offset = sizeof(PchorRuntime::TraceFileHeader);
+  while (offset < end) {
+    const TraceChunk chunk = chunkAt(offset);
+    const size_t body = offset + sizeof(TraceChunk);
+    offset = body + bodySize(chunk);
+    if (chunk.kind == TraceChunkKind::Participant ||
+        chunk.participant % jobs != job) {
+      continue;
+    }
+    const Stream &stream = streams[chunk.participant];
+    TraceResult &result = results[chunk.participant];
+    if (stream.table == nullptr) {
+      continue;
+    }
+    if (chunk.kind == TraceChunkKind::Dropped) {
+      result.dropped += chunk.size;
+      if (result.verdict != TraceVerdict::Violation) {
+        result.verdict = TraceVerdict::Incomplete;
+      }
+      continue;
+    }
+    // the stream is not checked past a violation or a gap
+    if (result.verdict != TraceVerdict::Unfinished) {
+      continue;
+    }
+
+    const std::vector<std::string> &events = stream.monitor->events;
+    const uint16_t *next = stream.table->next.data();
+    for (uint64_t i = 0; i < chunk.size; ++i) {
+      TraceRecord record;
+      std::memcpy(&record, trace.data() + body + i * sizeof(TraceRecord),
+                  sizeof(record));
+      const uint16_t event = PchorRuntime::traceEvent(record);
+      ++result.events;
+      const uint16_t target =
+          event < events.size()
+              ? next[result.state * events.size() + event]
+              : MonitorGenerator::invalidState;
+      if (target == MonitorGenerator::invalidState) {
+        result.verdict = TraceVerdict::Violation;
+        result.detail = std::format(
+            "{} at {} us", event < events.size()
+                               ? events[event]
+                               : std::format("unknown event {}", event),
+            PchorRuntime::traceTime(record) / 1000);
+        break;
+      }
+      result.state = target;
+    }
+  }
+
+  for (size_t id = job; id < streams.size(); id += jobs) {
+    TraceResult &result = results[id];
+    if (result.verdict == TraceVerdict::Unfinished &&
+        streams[id].table->final[result.state]) {
+      result.verdict = TraceVerdict::Conforms;
+    }
+  }
+}
+
+} // namespace PchorAST
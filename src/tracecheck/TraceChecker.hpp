@@ -0,0 +1,99 @@
+#pragma once
+
+#include "../analyzer/utils/MonitorGenerator.hpp"
+#include "../pchor/runtime/TraceFormat.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PchorAST {
+
+// Read-only memory mapping of a trace file. Throws if it cannot be mapped
+class TraceFile {
+public:
+  explicit TraceFile(const std::string &path);
+  ~TraceFile();
+
+  TraceFile(const TraceFile &other) = delete;
+  TraceFile &operator=(const TraceFile &other) = delete;
+  TraceFile(TraceFile &&other) = delete;
+  TraceFile &operator=(TraceFile &&other) = delete;
+
+  const std::byte *data() const { return bytes; }
+  size_t size() const { return length; }
+
+private:
+  const std::byte *bytes;
+  size_t length;
+};
+
+enum class TraceVerdict : uint8_t {
+  // completed its local type
+  Conforms,
+  // followed its local type, but stopped before completing it
+  Unfinished,
+  // followed its local type until events were dropped
+  Incomplete,
+  Violation,
+  // traced, but not a participant of the choreography
+  Unknown,
+  // projected, but never traced
+  Untraced
+};
+
+struct TraceResult {
+  std::string participant;
+  TraceVerdict verdict;
+  // events checked, up to and including a violation
+  uint64_t events;
+  uint64_t dropped;
+  uint16_t state;
+  // the offending event and its time, for a violation
+  std::string detail;
+};
+
+/*
+  Checks the streams of a binary trace (pchor/runtime/TraceFormat.hpp)
+  against the monitor tables of the choreography, as pchor-trace-check.
+  Each stream is run through the table of its participant, one lookup per
+  event, from the initial state, until the end of the trace, the first
+  violation or the first dropped event. The streams are split over jobs
+  threads, which each walk the chunks of the mapped trace once and check
+  their own streams on the way, so a trace of any size is checked with one
+  state per stream, reading the file straight from the page cache.
+*/
+class TraceChecker {
+public:
+  // Indexes the participants of trace, throws on a malformed trace
+  TraceChecker(const MonitorGenerator &monitors, const TraceFile &trace);
+
+  // A result for every stream, then for every projection without a stream
+  std::vector<TraceResult> check(size_t jobs) const;
+
+  // True if the trace ends in a partly written chunk
+  bool isTruncated() const { return end != trace.size(); }
+
+private:
+  struct Stream {
+    std::string participant;
+    // null for participants the choreography does not have
+    const MonitorGenerator::Participant *monitor = nullptr;
+    const MonitorGenerator::Table *table = nullptr;
+  };
+
+  const MonitorGenerator &monitors;
+  const TraceFile &trace;
+  // indexed by stream id
+  std::vector<Stream> streams;
+  // offset past the last complete chunk
+  size_t end;
+
+  PchorRuntime::TraceChunk chunkAt(size_t offset) const;
+  static size_t bodySize(const PchorRuntime::TraceChunk &chunk);
+  void checkStreams(size_t job, size_t jobs,
+                    std::vector<TraceResult> &results) const;
+};
+
+} // namespace PchorAST
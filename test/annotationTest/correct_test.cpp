@@ -0,0 +1,55 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Job {
+    explicit Job() : str(""), isRead(true) {}
+    explicit Job(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+class [[clang::annotate("pchor:participant=Worker")]] JobQueue {
+public:
+    explicit JobQueue() : backlog(Job{}), hotline(Job{}) {}
+
+    void drain() {
+        while (hotline.isRead) {
+            // Wait for the urgent job
+        }
+        std::println("JobQueue: urgent {}", hotline.str);
+        while (backlog.isRead) {
+            // Wait for the routine job
+        }
+        std::println("JobQueue: routine {}", backlog.str);
+    }
+
+    // declared in the opposite order of the channels
+    [[clang::annotate("pchor:channel=routine")]] Job backlog;
+    [[clang::annotate("pchor:channel=urgent")]] Job hotline;
+};
+
+class [[clang::annotate("pchor:participant=Dispatcher")]] Scheduler {
+public:
+    explicit Scheduler(JobQueue* queue) : queue(queue) {}
+
+    void schedule() {
+        queue->hotline = Job{"restart server"};
+        queue->backlog = Job{"rotate logs"};
+    }
+
+    JobQueue* queue;
+};
+
+int main() {
+    JobQueue queue;
+    Scheduler scheduler(&queue);
+
+    std::thread schedulerThread([&]() { scheduler.schedule(); });
+    std::thread queueThread([&]() { queue.drain(); });
+
+    schedulerThread.join();
+    queueThread.join();
+
+    return 0;
+}
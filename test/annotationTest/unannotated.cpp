@@ -0,0 +1,55 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Job {
+    explicit Job() : str(""), isRead(true) {}
+    explicit Job(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+class Worker {
+public:
+    explicit Worker() : backlog(Job{}), hotline(Job{}) {}
+
+    void drain() {
+        while (hotline.isRead) {
+            // Wait for the urgent job
+        }
+        std::println("Worker: urgent {}", hotline.str);
+        while (backlog.isRead) {
+            // Wait for the routine job
+        }
+        std::println("Worker: routine {}", backlog.str);
+    }
+
+    // declared in the opposite order of the channels
+    Job backlog;
+    Job hotline;
+};
+
+class Dispatcher {
+public:
+    explicit Dispatcher(Worker* queue) : queue(queue) {}
+
+    void schedule() {
+        queue->hotline = Job{"restart server"};
+        queue->backlog = Job{"rotate logs"};
+    }
+
+    Worker* queue;
+};
+
+int main() {
+    Worker queue;
+    Dispatcher scheduler(&queue);
+
+    std::thread schedulerThread([&]() { scheduler.schedule(); });
+    std::thread queueThread([&]() { queue.drain(); });
+
+    schedulerThread.join();
+    queueThread.join();
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Data {
+    explicit Data() : str(""), isRead(true) {}
+    explicit Data(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+struct Reply {
+    explicit Reply() : accepted(false), isRead(true) {}
+    explicit Reply(bool accepted) : accepted(accepted), isRead(false) {}
+    bool accepted;
+    bool isRead;
+};
+
+class Producer;
+
+class Consumer {
+public:
+    explicit Consumer() : data(Data{}), producer(nullptr) {}
+
+    void consume() {
+        while (data.isRead) {
+            // Wait for the data
+        }
+        std::println("Consumer: Received {}", data.str);
+        acknowledge(!data.str.empty());
+    }
+
+    Data data;
+    Producer* producer;
+
+private:
+    // the reply is sent two calls down from consume
+    void acknowledge(bool accepted);
+    void send(const Reply& reply);
+};
+
+class Producer {
+public:
+    explicit Producer(Consumer* consumer) : reply(Reply{}), consumer(consumer) {}
+
+    void produce(const std::string& content) {
+        publish(content);
+        awaitReply();
+    }
+
+    Reply reply;
+    Consumer* consumer;
+
+private:
+    void publish(const std::string& content) {
+        consumer->data = Data{content};
+    }
+
+    void awaitReply() {
+        while (reply.isRead) {
+            // Wait for the reply
+        }
+        std::println("Producer: Reply {}", reply.accepted);
+    }
+};
+
+void Consumer::acknowledge(bool accepted) {
+    send(Reply{accepted});
+}
+
+void Consumer::send(const Reply& reply) {
+    producer->reply = reply;
+}
+
+int main() {
+    Consumer consumer;
+    Producer producer(&consumer);
+    consumer.producer = &producer;
+
+    std::thread producerThread([&]() { producer.produce("Hello, Consumer!"); });
+    std::thread consumerThread([&]() { consumer.consume(); });
+
+    producerThread.join();
+    consumerThread.join();
+
+    return 0;
+}
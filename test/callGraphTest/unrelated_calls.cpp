@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cctype>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Data {
+    explicit Data() : str(""), isRead(true) {}
+    explicit Data(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+struct Reply {
+    explicit Reply() : accepted(false), isRead(true) {}
+    explicit Reply(bool accepted) : accepted(accepted), isRead(false) {}
+    bool accepted;
+    bool isRead;
+};
+
+// never touches a channel, however much of it runs
+class Formatter {
+public:
+    std::string format(const std::string& content) const {
+        std::string upper = capitalise(content);
+        return std::format("[{}] {}", checksum(upper, upper.size()), upper);
+    }
+
+private:
+    std::string capitalise(std::string content) const {
+        std::transform(content.begin(), content.end(), content.begin(),
+                       [](unsigned char c) { return std::toupper(c); });
+        return content;
+    }
+
+    size_t checksum(const std::string& content, size_t length) const {
+        if (length == 0) {
+            return 0;
+        }
+        return static_cast<unsigned char>(content[length - 1]) +
+               31 * checksum(content, length - 1);
+    }
+};
+
+class Sink {
+public:
+    virtual ~Sink() = default;
+    virtual void record(const std::string& entry) = 0;
+};
+
+class HistorySink : public Sink {
+public:
+    void record(const std::string& entry) override {
+        history.push_back(entry);
+        std::sort(history.begin(), history.end());
+    }
+
+    std::vector<std::string> history;
+};
+
+class Producer;
+
+class Consumer {
+public:
+    explicit Consumer(Sink* sink, bool (*accept)(const std::string&))
+        : data(Data{}), producer(nullptr), sink(sink), accept(accept) {}
+
+    void consume();
+
+    Data data;
+    Producer* producer;
+    Sink* sink;
+    bool (*accept)(const std::string&);
+};
+
+class Producer {
+public:
+    explicit Producer(Consumer* consumer) : reply(Reply{}), consumer(consumer) {}
+
+    void produce(const std::string& content) {
+        Formatter formatter;
+        consumer->data = Data{formatter.format(content)};
+        while (reply.isRead) {
+            // Wait for the reply
+        }
+        std::println("Producer: Reply {}", reply.accepted);
+    }
+
+    Reply reply;
+    Consumer* consumer;
+};
+
+void Consumer::consume() {
+    while (data.isRead) {
+        // Wait for the data
+    }
+    sink->record(data.str);
+    producer->reply = Reply{accept(data.str)};
+}
+
+bool nonEmpty(const std::string& content) {
+    return !content.empty();
+}
+
+int main() {
+    HistorySink sink;
+    Consumer consumer(&sink, nonEmpty);
+    Producer producer(&consumer);
+    consumer.producer = &producer;
+
+    std::thread producerThread([&]() { producer.produce("Hello, Consumer!"); });
+    std::thread consumerThread([&]() { consumer.consume(); });
+
+    producerThread.join();
+    consumerThread.join();
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <format>
+#include <print>
+#include <string>
+
+struct Request {
+    int round = 0;
+};
+
+struct Data {
+    std::string data;
+};
+
+enum class Control { more, done };
+
+#include "pchor/runtime/Coroutine.hpp"
+
+class Server;
+
+// The skeleton of stream_coroutines.hpp, filled in
+class Client {
+public:
+    PchorRuntime::Task fetch(Server& server);
+
+    PchorRuntime::AsyncChannel<Control, 1> c;
+    PchorRuntime::AsyncChannel<Data, 1> d;
+
+private:
+    int rounds = 0;
+};
+
+class Server {
+public:
+    PchorRuntime::Task serve(Client& client);
+
+    PchorRuntime::AsyncChannel<Request, 1> r;
+};
+
+PchorRuntime::Task Client::fetch(Server& server) {
+    while (true) {
+        co_await server.r.send(Request{rounds++});
+        const Control control = co_await c.recv();
+        switch (control) {
+        case Control::more: {
+            Data data = co_await d.recv();
+            std::println("Client: Received Data -> {}", data.data);
+            continue;
+        }
+        case Control::done: {
+            co_return;
+        }
+        }
+    }
+}
+
+PchorRuntime::Task Server::serve(Client& client) {
+    while (true) {
+        Request request = co_await r.recv();
+        Control control = request.round < 3 ? Control::more : Control::done;
+        if (control == Control::more) {
+            co_await client.c.send(Control::more);
+            Data data{std::format("Data{}", request.round)};
+            co_await client.d.send(data);
+            continue;
+        } else {
+            co_await client.c.send(Control::done);
+            co_return;
+        }
+    }
+}
+
+int main() {
+    Client client;
+    Server server;
+
+    // both participants take turns on the thread running the executor
+    PchorRuntime::Executor executor;
+    executor.spawn(client.fetch(server));
+    executor.spawn(server.serve(client));
+    executor.run();
+
+    return 0;
+}
@@ -0,0 +1,28 @@
+#include <print>
+#include <string>
+
+struct Request {
+    int round = 0;
+};
+
+struct Data {
+    std::string data;
+};
+
+enum class Control { more, done };
+
+#include "stream_coroutines.hpp"
+
+int main() {
+    Client client;
+    Server server;
+
+    // as generated, Server always chooses more, so the skeleton is only
+    // validated and not run
+    PchorRuntime::Executor executor;
+    executor.spawn(client.run(server));
+    executor.spawn(server.run(client));
+
+    std::println("The generated skeleton compiles");
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Generated by PChorAnalyzer from the projections of a choreography,
+// as a starting point for its participants as coroutines. Include it
+// after the payload and label types are declared, and fill in the
+// payloads sent and the branches selected.
+#pragma once
+
+#include "pchor/runtime/Coroutine.hpp"
+
+class Client;
+class Server;
+
+class Client {
+public:
+  // Client[1]: rec Loop{!r[1]<Request>.?c[1]<Control>{more: ?d[1]<Data>.continue Loop. | done: }.}.
+  PchorRuntime::Task run(Server &server);
+
+  PchorRuntime::AsyncChannel<Control, 1> c;
+  PchorRuntime::AsyncChannel<Data, 1> d;
+};
+
+class Server {
+public:
+  // Server[1]: rec Loop{?r[1]<Request>.!c[1]<Control>{more: !d[1]<Data>.continue Loop. | done: }.}.
+  PchorRuntime::Task run(Client &client);
+
+  PchorRuntime::AsyncChannel<Request, 1> r;
+};
+
+inline PchorRuntime::Task Client::run(Server &server) {
+  while (true) {
+    co_await server.r.send(Request{});
+    const Control control = co_await c.recv();
+    switch (control) {
+    case Control::more: {
+      [[maybe_unused]] Data data = co_await d.recv();
+      continue;
+    }
+    case Control::done: {
+      co_return;
+    }
+    }
+  }
+}
+
+inline PchorRuntime::Task Server::run(Client &client) {
+  while (true) {
+    [[maybe_unused]] Request request = co_await r.recv();
+    Control control = Control::more; // choose the branch to take
+    if (control == Control::more) {
+      co_await client.c.send(Control::more);
+      co_await client.d.send(Data{});
+      continue;
+    } else {
+      co_await client.c.send(Control::done);
+      co_return;
+    }
+  }
+}
+
@@ -0,0 +1,79 @@
+#include <string>
+#include <print>
+#include <vector>
+#include <thread>
+
+struct Order{
+    std::string item;
+    unsigned quantity;
+
+    Order(const std::string& s, unsigned q): item(s), quantity(q) {}
+};
+
+#include "multicast_channels.hpp"
+
+class BroadCaster {
+public:
+
+void run(Order* order) {
+    thread = std::thread([this, order]() {
+        broadCast(*order);
+    });
+}
+
+void broadCast(Order order) {
+    // stored once, and read by every worker
+    w = order;
+}
+
+PchorChannels::w w;
+std::thread thread;
+};
+
+class Worker {
+public:
+
+Worker(BroadCaster* caster, size_t id): caster(caster), id(id) {}
+
+void run() {
+    thread = std::thread([this]() {
+        processOrder();
+    });
+}
+
+void processOrder() {
+    while(caster->w.empty(id)){
+        //spinwait
+    }
+    const Order& order = caster->w.front(id);
+    std::println("Worker {}: Order {} with quantity {}", id, order.item, order.quantity);
+    caster->w.release(id);
+}
+
+BroadCaster* caster;
+size_t id;
+std::thread thread;
+};
+
+int main()
+{
+    BroadCaster bCast;
+    std::vector<Worker> workerArr{};
+    for(size_t id = 0; id < PchorChannels::w::recievers; ++id){
+        workerArr.emplace_back(&bCast, id);
+    }
+
+    for(Worker& worker : workerArr){
+        worker.run();
+    }
+
+    Order order{"Payamas", 11};
+    bCast.run(&order);
+
+    for(Worker& worker : workerArr){
+        worker.thread.join();
+    }
+    bCast.thread.join();
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+// Generated by PChorAnalyzer from the Channel declarations of a
+// choreography. Include it after the payload types are declared.
+#pragma once
+
+#include "pchor/runtime/MulticastChannel.hpp"
+
+#include <cstddef>
+
+namespace PchorChannels {
+
+// w: BroadCaster[1] -> 5 recievers (numbered from index w[1]), at most 1 message in flight each
+inline constexpr std::size_t w_capacity = 1;
+inline constexpr bool w_bounded = true;
+using w = PchorRuntime::MulticastChannel<Order, w_capacity, 5>;
+
+} // namespace PchorChannels
@@ -0,0 +1,89 @@
+#include <format>
+#include <print>
+#include <string>
+#include <thread>
+
+enum class Control { none, more, done };
+
+struct Request {
+    explicit Request() : str(""), isRead(true) {}
+    explicit Request(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+struct Data {
+    explicit Data() : str(""), isRead(true) {}
+    explicit Data(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+class Server;
+
+class Client {
+public:
+    explicit Client() : control(Control::none), data(Data{}), server(nullptr) {}
+
+    void fetch();
+
+    Control control;
+    Data data;
+    Server* server;
+};
+
+class Server {
+public:
+    explicit Server(Client* client) : request(Request{}), client(client) {}
+
+    void serve(int chunks) {
+        while (true) {
+            while (request.isRead) {
+                // Wait for the next request
+            }
+            request.isRead = true;
+            if (chunks == 0) {
+                client->control = Control::done;
+                break;
+            }
+            client->control = Control::more;
+            client->data = Data{std::format("chunk {}", chunks)};
+            chunks--;
+        }
+    }
+
+    Request request;
+    Client* client;
+};
+
+void Client::fetch() {
+    while (true) {
+        server->request = Request{"next"};
+        while (control == Control::none) {
+            // Wait for the server to decide
+        }
+        if (control == Control::done) {
+            break;
+        }
+        while (data.isRead) {
+            // Wait for the data
+        }
+        std::println("Client: Received {}", data.str);
+        data.isRead = true;
+        control = Control::none;
+    }
+}
+
+int main() {
+    Client client;
+    Server server(&client);
+    client.server = &server;
+
+    std::thread serverThread([&]() { server.serve(3); });
+    std::thread clientThread([&]() { client.fetch(); });
+
+    serverThread.join();
+    clientThread.join();
+
+    return 0;
+}
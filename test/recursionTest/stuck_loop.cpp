@@ -0,0 +1,68 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Request {
+    explicit Request() : str(""), isRead(true) {}
+    explicit Request(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+struct Data {
+    explicit Data() : str(""), isRead(true) {}
+    explicit Data(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+class Server;
+
+class Client {
+public:
+    explicit Client() : data(Data{}), server(nullptr) {}
+
+    void poll();
+
+    Data data;
+    Server* server;
+};
+
+class Server {
+public:
+    explicit Server(Client* client) : request(Request{}), client(client) {}
+
+    void serve() {
+        for (;;) {
+            while (request.isRead) {
+                // Wait for the next request
+            }
+            request.isRead = true;
+            client->data = Data{"reply to " + request.str};
+        }
+    }
+
+    Request request;
+    Client* client;
+};
+
+void Client::poll() {
+    while (true) {
+        server->request = Request{"status"};
+    }
+}
+
+int main() {
+    Client client;
+    Server server(&client);
+    client.server = &server;
+
+    // both participants serve the protocol until the process is stopped
+    std::thread serverThread([&]() { server.serve(); });
+    std::thread clientThread([&]() { client.poll(); });
+
+    serverThread.join();
+    clientThread.join();
+
+    return 0;
+}
@@ -15,20 +15,44 @@ for dir in "$TEST_ROOT"/*/; do
         cat "$txtfile"
         echo "------------------------------"
 
+        #each line of args.txt holds extra plugin arguments for one run,
+        #results files of the test are written from scratch
+        runs=("")
+        if [[ -f "${dir}args.txt" ]]; then
+            mapfile -t runs < "${dir}args.txt"
+            rm -f "$dir"results.*
+        fi
+
         #we try all combinations of .cpp and .cor
         for cpp in "$dir"*.cpp; do
 
             for cor in "$dir"*.cor; do
-                echo "Running Pchor on: "
-                echo "  C++: $cpp"
-                echo "  COR: $cor \n"
-                echo "------------------------------"
 
-                clang++-18 -std=c++23 -Xclang -load -Xclang "$PLUGIN_PATH" \
-                    -Xclang -plugin-arg-PchorAnalyzer -Xclang --cor="$cor" \
-                    "$cpp" -o /dev/null
-                echo "------------------------------"
+                for args in "${runs[@]}"; do
+                    extra=()
+                    for arg in $args; do
+                        extra+=(-Xclang -plugin-arg-PchorAnalyzer -Xclang "$arg")
+                    done
+                    echo "Running Pchor on: "
+                    echo "  C++: $cpp"
+                    echo "  COR: $cor"
+                    echo "  ARGS: $args \n"
+                    echo "------------------------------"
+
+                    clang++-18 -std=c++23 -I../src -Xclang -load -Xclang "$PLUGIN_PATH" \
+                        -Xclang -plugin-arg-PchorAnalyzer -Xclang --cor="$cor" \
+                        "${extra[@]}" "$cpp" -o /dev/null
+                    echo "------------------------------"
+                done
             done
         done
+
+        for results in "$dir"results.*; do
+            if [[ -f "$results" ]]; then
+                echo "Results in $results:"
+                cat "$results"
+                echo "------------------------------"
+            fi
+        done
     fi
-done
\ No newline at end of file
+done
@@ -0,0 +1,90 @@
+#include <print>
+#include <string>
+#include <thread>
+
+enum class Filter { none, transformable, non_transformable };
+
+struct Message {
+    explicit Message() : str(""), isRead(true) {}
+    explicit Message(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+struct Entry {
+    explicit Entry() : str(""), isRead(true) {}
+    explicit Entry(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+class Logger {
+public:
+    explicit Logger() : entry(Entry{}) {}
+
+    void log() {
+        while (entry.isRead) {
+            // Wait for a new entry
+        }
+        std::println("Logger: {}", entry.str);
+    }
+
+    Entry entry;
+};
+
+class Subscriber {
+public:
+    explicit Subscriber(Logger* logger)
+        : label(Filter::none), msg(Message{}), logger(logger) {}
+
+    void receive() {
+        while (label == Filter::none) {
+            // Wait for the topic to select a branch
+        }
+        if (label != Filter::non_transformable) {
+            while (msg.isRead) {
+                // Wait for the message
+            }
+            std::println("Subscriber: Received Message -> {}", msg.str);
+        } else {
+            std::println("Subscriber: Message filtered");
+        }
+        logger->entry = Entry{"handled message"};
+    }
+
+    Filter label;
+    Message msg;
+    Logger* logger;
+};
+
+class Topic {
+public:
+    explicit Topic(Subscriber* subscriber) : subscriber(subscriber) {}
+
+    void publish(const std::string& content, bool transform) {
+        if (transform) {
+            subscriber->label = Filter::transformable;
+            subscriber->msg = Message{content};
+        } else {
+            subscriber->label = Filter::non_transformable;
+        }
+    }
+
+    Subscriber* subscriber;
+};
+
+int main() {
+    Logger logger;
+    Subscriber subscriber(&logger);
+    Topic topic(&subscriber);
+
+    std::thread topicThread([&]() { topic.publish("Hello, Subscriber!", true); });
+    std::thread subscriberThread([&]() { subscriber.receive(); });
+    std::thread loggerThread([&]() { logger.log(); });
+
+    topicThread.join();
+    subscriberThread.join();
+    loggerThread.join();
+
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Job {
+    explicit Job() : str(""), isRead(true) {}
+    explicit Job(std::string str) : str(str), isRead(false) {}
+    std::string str;
+    bool isRead;
+};
+
+class Worker {
+public:
+    explicit Worker() : urgent(Job{}), routine(Job{}) {}
+
+    void work() {
+        while (routine.isRead) {
+            // Wait for the routine job
+        }
+        std::println("Worker: routine {}", routine.str);
+        while (urgent.isRead) {
+            // Wait for the urgent job
+        }
+        std::println("Worker: urgent {}", urgent.str);
+    }
+
+    Job urgent;
+    Job routine;
+};
+
+class Dispatcher {
+public:
+    explicit Dispatcher(Worker* worker) : worker(worker) {}
+
+    void dispatch() {
+        worker->urgent = Job{"restart server"};
+        worker->routine = Job{"rotate logs"};
+    }
+
+    Worker* worker;
+};
+
+int main() {
+    Worker worker;
+    Dispatcher dispatcher(&worker);
+
+    std::thread dispatcherThread([&]() { dispatcher.dispatch(); });
+    std::thread workerThread([&]() { worker.work(); });
+
+    dispatcherThread.join();
+    workerThread.join();
+
+    return 0;
+}
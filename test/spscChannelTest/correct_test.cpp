@@ -0,0 +1,91 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Data {
+    std::string data;
+    explicit Data(const std::string& data) : data(data) {}
+};
+
+struct Key {
+    std::string key;
+    explicit Key(const std::string& key) : key(key) {}
+};
+
+#include "stream_channels.hpp"
+
+class Consumer {
+public:
+    void receiveData() {
+        while (c.empty()) {
+            // Wait for the kernel
+        }
+        Data data = c.pop();
+        std::println("Consumer: Received Data -> {}", data.data);
+    }
+
+    PchorChannels::c c;
+};
+
+class Kernel {
+public:
+    explicit Kernel(Consumer* consumer) : consumer(consumer) {}
+
+    void sendData() {
+        while (d.empty()) {
+            // Wait for the data producer
+        }
+        Data data = d.pop();
+        while (k.empty()) {
+            // Wait for the key producer
+        }
+        Key key = k.pop();
+        std::println("Kernel: Received Key -> {}, Data -> {}", key.key, data.data);
+        consumer->c = data;
+    }
+
+    PchorChannels::d d;
+    PchorChannels::k k;
+    Consumer* consumer;
+};
+
+class DataProducer {
+public:
+    explicit DataProducer(Kernel* kernel) : kernel(kernel) {}
+
+    void sendData() {
+        kernel->d = Data("Data1");
+    }
+
+    Kernel* kernel;
+};
+
+class KeyProducer {
+public:
+    explicit KeyProducer(Kernel* kernel) : kernel(kernel) {}
+
+    void sendKeys() {
+        kernel->k = Key("Key1");
+    }
+
+    Kernel* kernel;
+};
+
+int main() {
+    Consumer consumer;
+    Kernel kernel(&consumer);
+    DataProducer dataProducer(&kernel);
+    KeyProducer keyProducer(&kernel);
+
+    std::thread consumerThread([&]() { consumer.receiveData(); });
+    std::thread kernelThread([&]() { kernel.sendData(); });
+    std::thread dataProducerThread([&]() { dataProducer.sendData(); });
+    std::thread keyProducerThread([&]() { keyProducer.sendKeys(); });
+
+    dataProducerThread.join();
+    keyProducerThread.join();
+    kernelThread.join();
+    consumerThread.join();
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Data {
+    std::string data;
+    explicit Data(const std::string& data) : data(data) {}
+};
+
+struct Key {
+    std::string key;
+    explicit Key(const std::string& key) : key(key) {}
+};
+
+#include "stream_channels.hpp"
+#include "stream_monitor.hpp"
+
+class Consumer {
+public:
+    void receiveData() {
+        while (c.empty()) {
+            // Wait for the kernel
+        }
+        Data data = c.pop();
+        monitor.step(PchorMonitor::Consumer::recv_c_Data);
+        std::println("Consumer: Received Data -> {}", data.data);
+    }
+
+    PchorChannels::c c;
+    PchorRuntime::Monitor monitor{PchorMonitor::Consumer::table(1)};
+};
+
+class Kernel {
+public:
+    explicit Kernel(Consumer* consumer) : consumer(consumer) {}
+
+    void sendData() {
+        while (d.empty()) {
+            // Wait for the data producer
+        }
+        Data data = d.pop();
+        monitor.step(PchorMonitor::Kernel::recv_d_Data);
+        while (k.empty()) {
+            // Wait for the key producer
+        }
+        Key key = k.pop();
+        monitor.step(PchorMonitor::Kernel::recv_k_Key);
+        std::println("Kernel: Received Key -> {}, Data -> {}", key.key, data.data);
+        consumer->c = data;
+        monitor.step(PchorMonitor::Kernel::send_c_Data);
+    }
+
+    PchorChannels::d d;
+    PchorChannels::k k;
+    Consumer* consumer;
+    PchorRuntime::Monitor monitor{PchorMonitor::Kernel::table(1)};
+};
+
+class DataProducer {
+public:
+    explicit DataProducer(Kernel* kernel) : kernel(kernel) {}
+
+    void sendData() {
+        kernel->d = Data("Data1");
+        monitor.step(PchorMonitor::DataProducer::send_d_Data);
+    }
+
+    Kernel* kernel;
+    PchorRuntime::Monitor monitor{PchorMonitor::DataProducer::table(1)};
+};
+
+class KeyProducer {
+public:
+    explicit KeyProducer(Kernel* kernel) : kernel(kernel) {}
+
+    void sendKeys() {
+        kernel->k = Key("Key1");
+        monitor.step(PchorMonitor::KeyProducer::send_k_Key);
+    }
+
+    Kernel* kernel;
+    PchorRuntime::Monitor monitor{PchorMonitor::KeyProducer::table(1)};
+};
+
+int main() {
+    Consumer consumer;
+    Kernel kernel(&consumer);
+    DataProducer dataProducer(&kernel);
+    KeyProducer keyProducer(&kernel);
+
+    std::thread consumerThread([&]() { consumer.receiveData(); });
+    std::thread kernelThread([&]() { kernel.sendData(); });
+    std::thread dataProducerThread([&]() { dataProducer.sendData(); });
+    std::thread keyProducerThread([&]() { keyProducer.sendKeys(); });
+
+    dataProducerThread.join();
+    keyProducerThread.join();
+    kernelThread.join();
+    consumerThread.join();
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Data {
+    std::string data;
+    explicit Data(const std::string& data) : data(data) {}
+};
+
+struct Key {
+    std::string key;
+    explicit Key(const std::string& key) : key(key) {}
+};
+
+#include "stream_channels.hpp"
+#include "stream_session.hpp"
+
+class Consumer {
+public:
+    void receiveData() {
+        auto [data, done] = PchorSession::Consumer_1::start(*this).recv();
+        std::println("Consumer: Received Data -> {}", data.data);
+    }
+
+    PchorChannels::c c;
+};
+
+class Kernel {
+public:
+    explicit Kernel(Consumer* consumer) : consumer(consumer) {}
+
+    void sendData() {
+        auto [data, keyState] = PchorSession::Kernel_1::start(*this).recv();
+        auto [key, sendState] = std::move(keyState).recv();
+        std::println("Kernel: Received Key -> {}, Data -> {}", key.key, data.data);
+        [[maybe_unused]] auto done = std::move(sendState).send(*consumer, data);
+    }
+
+    PchorChannels::d d;
+    PchorChannels::k k;
+    Consumer* consumer;
+};
+
+class DataProducer {
+public:
+    explicit DataProducer(Kernel* kernel) : kernel(kernel) {}
+
+    void sendData() {
+        [[maybe_unused]] auto done =
+            PchorSession::DataProducer_1::start(*this).send(*kernel, Data("Data1"));
+    }
+
+    Kernel* kernel;
+};
+
+class KeyProducer {
+public:
+    explicit KeyProducer(Kernel* kernel) : kernel(kernel) {}
+
+    void sendKeys() {
+        [[maybe_unused]] auto done =
+            PchorSession::KeyProducer_1::start(*this).send(*kernel, Key("Key1"));
+    }
+
+    Kernel* kernel;
+};
+
+int main() {
+    Consumer consumer;
+    Kernel kernel(&consumer);
+    DataProducer dataProducer(&kernel);
+    KeyProducer keyProducer(&kernel);
+
+    std::thread consumerThread([&]() { consumer.receiveData(); });
+    std::thread kernelThread([&]() { kernel.sendData(); });
+    std::thread dataProducerThread([&]() { dataProducer.sendData(); });
+    std::thread keyProducerThread([&]() { keyProducer.sendKeys(); });
+
+    dataProducerThread.join();
+    keyProducerThread.join();
+    kernelThread.join();
+    consumerThread.join();
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+// Generated by PChorAnalyzer from the Channel declarations of a
+// choreography. Include it after the payload types are declared.
+#pragma once
+
+#include "pchor/runtime/SpscChannel.hpp"
+
+#include <cstddef>
+
+namespace PchorChannels {
+
+// d: DataProducer[1] -> Kernel[1], at most 1 message in flight
+inline constexpr std::size_t d_capacity = 1;
+inline constexpr bool d_bounded = true;
+using d = PchorRuntime::SpscChannel<Data, d_capacity>;
+
+// k: KeyProducer[1] -> Kernel[1], at most 1 message in flight
+inline constexpr std::size_t k_capacity = 1;
+inline constexpr bool k_bounded = true;
+using k = PchorRuntime::SpscChannel<Key, k_capacity>;
+
+// c: Kernel[1] -> Consumer[1], at most 1 message in flight
+inline constexpr std::size_t c_capacity = 1;
+inline constexpr bool c_bounded = true;
+using c = PchorRuntime::SpscChannel<Data, c_capacity>;
+
+} // namespace PchorChannels
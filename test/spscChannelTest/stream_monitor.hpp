@@ -0,0 +1,134 @@
+// Generated by PChorAnalyzer from the projections of a choreography.
+// Define PCHOR_MONITOR as 0 (or NDEBUG) to compile the monitors out.
+#pragma once
+
+#include "pchor/runtime/Monitor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace PchorMonitor {
+
+namespace Consumer {
+
+enum Event : uint16_t {
+  recv_c_Data,
+};
+
+inline constexpr std::size_t eventCount = 1;
+inline constexpr const char *eventNames[] = {
+    "recv_c_Data",
+};
+
+// Consumer[1]: ?c[1]<Data>.
+inline constexpr PchorRuntime::MonitorState next1[] = {
+    1,
+    0xFFFF,
+};
+inline constexpr bool final1[] = {false, true};
+inline constexpr PchorRuntime::MonitorTable table1{
+    "Consumer[1]", eventNames, eventCount, next1, final1};
+
+inline constexpr const PchorRuntime::MonitorTable *tables[] = {
+    &table1,
+};
+constexpr const PchorRuntime::MonitorTable &table(std::size_t index) {
+  return *tables[index - 1];
+}
+
+} // namespace Consumer
+
+namespace DataProducer {
+
+enum Event : uint16_t {
+  send_d_Data,
+};
+
+inline constexpr std::size_t eventCount = 1;
+inline constexpr const char *eventNames[] = {
+    "send_d_Data",
+};
+
+// DataProducer[1]: !d[1]<Data>.
+inline constexpr PchorRuntime::MonitorState next1[] = {
+    1,
+    0xFFFF,
+};
+inline constexpr bool final1[] = {false, true};
+inline constexpr PchorRuntime::MonitorTable table1{
+    "DataProducer[1]", eventNames, eventCount, next1, final1};
+
+inline constexpr const PchorRuntime::MonitorTable *tables[] = {
+    &table1,
+};
+constexpr const PchorRuntime::MonitorTable &table(std::size_t index) {
+  return *tables[index - 1];
+}
+
+} // namespace DataProducer
+
+namespace Kernel {
+
+enum Event : uint16_t {
+  recv_d_Data,
+  recv_k_Key,
+  send_c_Data,
+};
+
+inline constexpr std::size_t eventCount = 3;
+inline constexpr const char *eventNames[] = {
+    "recv_d_Data",
+    "recv_k_Key",
+    "send_c_Data",
+};
+
+// Kernel[1]: ?d[1]<Data>.?k[1]<Key>.!c[1]<Data>.
+inline constexpr PchorRuntime::MonitorState next1[] = {
+    1, 0xFFFF, 0xFFFF,
+    0xFFFF, 2, 0xFFFF,
+    0xFFFF, 0xFFFF, 3,
+    0xFFFF, 0xFFFF, 0xFFFF,
+};
+inline constexpr bool final1[] = {false, false, false, true};
+inline constexpr PchorRuntime::MonitorTable table1{
+    "Kernel[1]", eventNames, eventCount, next1, final1};
+
+inline constexpr const PchorRuntime::MonitorTable *tables[] = {
+    &table1,
+};
+constexpr const PchorRuntime::MonitorTable &table(std::size_t index) {
+  return *tables[index - 1];
+}
+
+} // namespace Kernel
+
+namespace KeyProducer {
+
+enum Event : uint16_t {
+  send_k_Key,
+};
+
+inline constexpr std::size_t eventCount = 1;
+inline constexpr const char *eventNames[] = {
+    "send_k_Key",
+};
+
+// KeyProducer[1]: !k[1]<Key>.
+inline constexpr PchorRuntime::MonitorState next1[] = {
+    1,
+    0xFFFF,
+};
+inline constexpr bool final1[] = {false, true};
+inline constexpr PchorRuntime::MonitorTable table1{
+    "KeyProducer[1]", eventNames, eventCount, next1, final1};
+
+inline constexpr const PchorRuntime::MonitorTable *tables[] = {
+    &table1,
+};
+constexpr const PchorRuntime::MonitorTable &table(std::size_t index) {
+  return *tables[index - 1];
+}
+
+} // namespace KeyProducer
+
+} // namespace PchorMonitor
@@ -0,0 +1,104 @@
+// Generated by PChorAnalyzer from the projections of a choreography.
+// Include it after the payload and label types are declared.
+#pragma once
+
+#include "pchor/runtime/Session.hpp"
+
+class Consumer;
+class DataProducer;
+class Kernel;
+class KeyProducer;
+
+namespace PchorSession {
+
+namespace Channels {
+struct c {
+  template <typename Participant> static auto &of(Participant &p) {
+    return p.c;
+  }
+};
+struct d {
+  template <typename Participant> static auto &of(Participant &p) {
+    return p.d;
+  }
+};
+struct k {
+  template <typename Participant> static auto &of(Participant &p) {
+    return p.k;
+  }
+};
+} // namespace Channels
+
+namespace Consumer_1 {
+// ?c[1]<Data>.
+struct s0;
+struct s1;
+struct s0 : PchorRuntime::Recv<::Consumer, Channels::c, Data, s1> {
+  using Recv::Recv;
+};
+struct s1 : PchorRuntime::End<::Consumer> {
+  using End::End;
+};
+
+inline s0 start(::Consumer &self) {
+  return PchorRuntime::startSession<s0>(self);
+}
+} // namespace Consumer_1
+
+namespace DataProducer_1 {
+// !d[1]<Data>.
+struct s0;
+struct s1;
+struct s0 : PchorRuntime::Send<::DataProducer, ::Kernel, Channels::d, Data, s1> {
+  using Send::Send;
+};
+struct s1 : PchorRuntime::End<::DataProducer> {
+  using End::End;
+};
+
+inline s0 start(::DataProducer &self) {
+  return PchorRuntime::startSession<s0>(self);
+}
+} // namespace DataProducer_1
+
+namespace Kernel_1 {
+// ?d[1]<Data>.?k[1]<Key>.!c[1]<Data>.
+struct s0;
+struct s1;
+struct s2;
+struct s3;
+struct s0 : PchorRuntime::Recv<::Kernel, Channels::d, Data, s1> {
+  using Recv::Recv;
+};
+struct s1 : PchorRuntime::Recv<::Kernel, Channels::k, Key, s2> {
+  using Recv::Recv;
+};
+struct s2 : PchorRuntime::Send<::Kernel, ::Consumer, Channels::c, Data, s3> {
+  using Send::Send;
+};
+struct s3 : PchorRuntime::End<::Kernel> {
+  using End::End;
+};
+
+inline s0 start(::Kernel &self) {
+  return PchorRuntime::startSession<s0>(self);
+}
+} // namespace Kernel_1
+
+namespace KeyProducer_1 {
+// !k[1]<Key>.
+struct s0;
+struct s1;
+struct s0 : PchorRuntime::Send<::KeyProducer, ::Kernel, Channels::k, Key, s1> {
+  using Send::Send;
+};
+struct s1 : PchorRuntime::End<::KeyProducer> {
+  using End::End;
+};
+
+inline s0 start(::KeyProducer &self) {
+  return PchorRuntime::startSession<s0>(self);
+}
+} // namespace KeyProducer_1
+
+} // namespace PchorSession
@@ -0,0 +1,113 @@
+#include <print>
+#include <string>
+#include <thread>
+
+struct Data {
+    std::string data;
+    explicit Data(const std::string& data) : data(data) {}
+};
+
+struct Key {
+    std::string key;
+    explicit Key(const std::string& key) : key(key) {}
+};
+
+#include "stream_channels.hpp"
+#include "stream_monitor.hpp"
+#include "pchor/runtime/TraceRecorder.hpp"
+
+class Consumer {
+public:
+    explicit Consumer(PchorRuntime::TraceRecorder& recorder)
+        : trace(recorder.participant(PchorMonitor::Consumer::table(1))) {}
+
+    void receiveData() {
+        while (c.empty()) {
+            // Wait for the kernel
+        }
+        Data data = c.pop();
+        trace.record(PchorMonitor::Consumer::recv_c_Data);
+        std::println("Consumer: Received Data -> {}", data.data);
+    }
+
+    PchorChannels::c c;
+    PchorRuntime::Tracer trace;
+};
+
+class Kernel {
+public:
+    Kernel(Consumer* consumer, PchorRuntime::TraceRecorder& recorder)
+        : consumer(consumer),
+          trace(recorder.participant(PchorMonitor::Kernel::table(1))) {}
+
+    void sendData() {
+        while (d.empty()) {
+            // Wait for the data producer
+        }
+        Data data = d.pop();
+        trace.record(PchorMonitor::Kernel::recv_d_Data);
+        while (k.empty()) {
+            // Wait for the key producer
+        }
+        Key key = k.pop();
+        trace.record(PchorMonitor::Kernel::recv_k_Key);
+        std::println("Kernel: Received Key -> {}, Data -> {}", key.key, data.data);
+        consumer->c = data;
+        trace.record(PchorMonitor::Kernel::send_c_Data);
+    }
+
+    PchorChannels::d d;
+    PchorChannels::k k;
+    Consumer* consumer;
+    PchorRuntime::Tracer trace;
+};
+
+class DataProducer {
+public:
+    DataProducer(Kernel* kernel, PchorRuntime::TraceRecorder& recorder)
+        : kernel(kernel),
+          trace(recorder.participant(PchorMonitor::DataProducer::table(1))) {}
+
+    void sendData() {
+        kernel->d = Data("Data1");
+        trace.record(PchorMonitor::DataProducer::send_d_Data);
+    }
+
+    Kernel* kernel;
+    PchorRuntime::Tracer trace;
+};
+
+class KeyProducer {
+public:
+    KeyProducer(Kernel* kernel, PchorRuntime::TraceRecorder& recorder)
+        : kernel(kernel),
+          trace(recorder.participant(PchorMonitor::KeyProducer::table(1))) {}
+
+    void sendKeys() {
+        kernel->k = Key("Key1");
+        trace.record(PchorMonitor::KeyProducer::send_k_Key);
+    }
+
+    Kernel* kernel;
+    PchorRuntime::Tracer trace;
+};
+
+int main() {
+    PchorRuntime::TraceRecorder recorder("stream.pctrace");
+    Consumer consumer(recorder);
+    Kernel kernel(&consumer, recorder);
+    DataProducer dataProducer(&kernel, recorder);
+    KeyProducer keyProducer(&kernel, recorder);
+
+    std::thread consumerThread([&]() { consumer.receiveData(); });
+    std::thread kernelThread([&]() { kernel.sendData(); });
+    std::thread dataProducerThread([&]() { dataProducer.sendData(); });
+    std::thread keyProducerThread([&]() { keyProducer.sendKeys(); });
+
+    dataProducerThread.join();
+    keyProducerThread.join();
+    kernelThread.join();
+    consumerThread.join();
+
+    return 0;
+}